@@ -161,6 +161,14 @@ int Benchmark<T>::init()
         fec = new quadiron::fec::RsGf2n<T>(
             word_size, k, m, quadiron::fec::RsMatrixType::CAUCHY);
         break;
+    case EC_TYPE_RS_GF2N_CX:
+        fec = new quadiron::fec::RsGf2n<T>(
+            word_size,
+            k,
+            m,
+            quadiron::fec::RsMatrixType::CAUCHY_BITMATRIX,
+            pkt_size);
+        break;
     case EC_TYPE_RS_GF2N_FFT:
         fec = new quadiron::fec::RsGf2nFft<T>(word_size, k, m);
         break;
@@ -305,6 +313,12 @@ int Benchmark<T>::check_params()
         }
     }
 
+    // packets are split into one sub-packet per bit of symbols
+    if (fec_type == EC_TYPE_RS_GF2N_CX) {
+        if (pkt_size == 0 || pkt_size % (8 * word_size) != 0)
+            return ERR_PKT_SIZE;
+    }
+
     size_t wordsize_limit = quadiron::arith::log2<T>(n) + 1;
     if (wordsize_limit > 8 * word_size) {
         return ERR_COMPT_CODE_LEN_T;
@@ -641,6 +655,8 @@ bool Benchmark<T>::enc_dec()
               << "\t-e \tType of Reed-Solomon codes, either\n"
               << "\t\t\trs-gf2n-v: " << ec_desc.at(EC_TYPE_RS_GF2N_V) << '\n'
               << "\t\t\trs-gf2n-c: " << ec_desc.at(EC_TYPE_RS_GF2N_C) << '\n'
+              << "\t\t\trs-gf2n-cx: " << ec_desc.at(EC_TYPE_RS_GF2N_CX)
+              << '\n'
               << "\t\t\trs-gf2n-fft: " << ec_desc.at(EC_TYPE_RS_GF2N_FFT)
               << '\n'
               << "\t\t\trs-gf2n-fft-add: "
@@ -54,6 +54,7 @@ enum ec_type {
     EC_TYPE_RS_GF2N_FFT_ADD,
     EC_TYPE_RS_GF2N_V,
     EC_TYPE_RS_GF2N_C,
+    EC_TYPE_RS_GF2N_CX,
     EC_TYPE_RS_GF2N_FFT,
     EC_TYPE_END,
 };
@@ -64,6 +65,8 @@ const std::map<ec_type, std::string> ec_desc = {
     {EC_TYPE_RS_GF2N_V,
      "Classical Vandermonde Reed-solomon codes over GF(2^n)"},
     {EC_TYPE_RS_GF2N_C, "Classical Cauchy Reed-solomon codes over GF(2^n)"},
+    {EC_TYPE_RS_GF2N_CX,
+     "Cauchy Reed-solomon codes over GF(2^n) using XORs of bit sub-packets"},
     {EC_TYPE_RS_GF2N_FFT, "Reed-solomon codes over GF(2^n) using FFT"},
     {EC_TYPE_RS_GF2N_FFT_ADD,
      "Reed-solomon codes over GF(2^n) using additive FFT"},
@@ -81,6 +84,7 @@ const std::map<ec_type, std::string> ec_desc_short = {
     {EC_TYPE_ALL, "all"},
     {EC_TYPE_RS_GF2N_V, "rs-gf2n-v"},
     {EC_TYPE_RS_GF2N_C, "rs-gf2n-c"},
+    {EC_TYPE_RS_GF2N_CX, "rs-gf2n-cx"},
     {EC_TYPE_RS_GF2N_FFT, "rs-gf2n-fft"},
     {EC_TYPE_RS_GF2N_FFT_ADD, "rs-gf2n-fft-add"},
     {EC_TYPE_RS_GFP_FFT, "rs-gfp-fft"},
@@ -95,8 +99,9 @@ enum gf2nrs_type {
 };
 
 enum errors {
-    ERR_COMPT_WORD_SIZE_T = -4,
+    ERR_COMPT_WORD_SIZE_T = -5,
     ERR_WORD_SIZE,
+    ERR_PKT_SIZE,
     ERR_COMPT_CODE_LEN_T,
     ERR_FEC_TYPE_NOT_SUPPORTED,
     ERR_SCENARIO_TYPE_NOT_SUPPORTED,
@@ -109,6 +114,7 @@ enum errors {
 const std::map<int, std::string> errors_desc = {
     {ERR_COMPT_WORD_SIZE_T, "Word size and type T is not compatible"},
     {ERR_WORD_SIZE, "Word size is incorrect"},
+    {ERR_PKT_SIZE, "Packet size is incorrect"},
     {ERR_COMPT_CODE_LEN_T, "Code length is too long vs. type T"},
     {ERR_FEC_TYPE_NOT_SUPPORTED, "Fec type is not recognised"},
     {ERR_SCENARIO_TYPE_NOT_SUPPORTED, "Scenario type is not recognised"},
@@ -122,6 +128,7 @@ const std::map<std::string, ec_type> fec_type_map = {
     {"all", EC_TYPE_ALL},
     {"rs-gf2n-v", EC_TYPE_RS_GF2N_V},
     {"rs-gf2n-c", EC_TYPE_RS_GF2N_C},
+    {"rs-gf2n-cx", EC_TYPE_RS_GF2N_CX},
     {"rs-gf2n-fft", EC_TYPE_RS_GF2N_FFT},
     {"rs-gf2n-fft-add", EC_TYPE_RS_GF2N_FFT_ADD},
     {"rs-gfp-fft", EC_TYPE_RS_GFP_FFT},
@@ -32,13 +32,18 @@
 #define __QUAD_FEC_BASE_H__
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <sys/time.h>
 
 #include "fec_context.h"
+#include "fec_stats.h"
 #include "fft_base.h"
 #include "gf_base.h"
 #include "misc.h"
@@ -88,6 +93,121 @@ enum class FecType {
     NON_SYSTEMATIC
 };
 
+/** Scratch state used to encode one packet.
+ *
+ * Each worker of a parallel encoding owns its workspace, so workers never
+ * share mutable buffers. Codes whose encoding only touches its arguments don't
+ * need one.
+ */
+template <typename T>
+class EncodeWorkspace {
+  public:
+    virtual ~EncodeWorkspace() = default;
+};
+
+/** Scratch state used in encoding of systematic FFT-based codes
+ *
+ * Data words are interpolated as if they were received in the first
+ * `n_data` fragments, then the polynomial is evaluated over the codeword.
+ */
+template <typename T>
+class SysEncodeWorkspace : public EncodeWorkspace<T> {
+  public:
+    // buffers for intermediate symbols
+    std::unique_ptr<vec::Buffers<T>> inter_words;
+    // buffers for suffix symbols of codewords
+    std::unique_ptr<vec::Buffers<T>> suffix_words;
+    // buffers replacing data symbols of codewords, so that data blocks are
+    // left untouched
+    std::unique_ptr<vec::Buffers<T>> prefix_words;
+    // decoding context bound to `inter_words`
+    std::unique_ptr<DecodeContext<T>> context;
+};
+
+/** Buffers used to process packets of blocks.
+ *
+ * They only depend on the code parameters, hence they are kept by the code
+ * across block operations instead of being allocated on each call.
+ */
+template <typename T>
+class BlockScratch {
+  public:
+    BlockScratch(
+        unsigned n_inputs,
+        unsigned n_outputs,
+        size_t pkt_size,
+        size_t inputs_buf_size,
+        size_t outputs_buf_size,
+        bool with_output)
+        : words_char(n_inputs, inputs_buf_size),
+          words(n_inputs, pkt_size),
+          output_char(n_outputs, outputs_buf_size)
+    {
+        if (with_output) {
+            output = std::make_unique<vec::Buffers<T>>(n_outputs, pkt_size);
+        }
+    }
+
+    // buffers storing data read from blocks
+    vec::Buffers<uint8_t> words_char;
+    // buffers storing words that are coded
+    vec::Buffers<T> words;
+    // buffers storing coded words, nullptr if the caller provides them
+    std::unique_ptr<vec::Buffers<T>> output;
+    // buffers storing data written to blocks
+    vec::Buffers<uint8_t> output_char;
+};
+
+template <typename T>
+class FecCode;
+
+/** Mutable state of block operations.
+ *
+ * Once initialized, a code only holds immutable tables (field, FFT twiddles,
+ * powers of the root). Hence several threads can run block operations on a
+ * shared code, provided that each of them uses its own workspace.
+ *
+ * Everything is allocated on demand and kept across calls.
+ */
+template <typename T>
+class Workspace {
+  public:
+    /** Set the maximal number of cached decoding contexts.
+     *
+     * A decoding context only depends on the set of received fragments, hence
+     * it is reused as long as the same erasure pattern repeats.
+     *
+     * @param capacity number of contexts, at least one is kept
+     */
+    void set_context_cache_capacity(size_t capacity)
+    {
+        context_cache.set_capacity(capacity);
+    }
+
+    /** Release the memory kept across block operations. */
+    void trim()
+    {
+        enc_scratch.clear();
+        enc_workspaces.clear();
+        dec_scratch = nullptr;
+        dec_inter_codeword = nullptr;
+        context_cache.clear();
+    }
+
+  private:
+    // decoding contexts of recently seen erasure patterns
+    DecodeContextCache<T> context_cache;
+    // scratch buffers and workspaces of encoding workers
+    std::vector<std::unique_ptr<BlockScratch<T>>> enc_scratch;
+    std::vector<std::unique_ptr<EncodeWorkspace<T>>> enc_workspaces;
+    // scratch buffers of block decoding
+    std::unique_ptr<BlockScratch<T>> dec_scratch;
+    // buffers for intermediate symbols used for systematic decoding
+    std::unique_ptr<vec::Buffers<T>> dec_inter_codeword;
+
+    friend class FecCode<T>;
+};
+
 /** Base class for Forward Error Correction (FEC) codes. */
 template <typename T>
 class FecCode {
@@ -100,18 +220,32 @@ class FecCode {
     unsigned n_outputs;
     size_t pkt_size; // packet size, i.e. number of words per packet
     size_t buf_size; // packet size in bytes
+    // size in bytes of the words of coded fragments, i.e. of the outputs of
+    // encoding, that are the inputs of decoding. Codes whose symbols don't fit
+    // in `word_size` bytes may store them on wider words.
+    unsigned coded_word_size;
+    size_t coded_buf_size; // packet size in bytes of coded fragments
+    // symbols of a packet are coded together, e.g. split into sub-packets:
+    // coded data must be made of whole packets and can't be updated per symbol
+    bool whole_packets = false;
 
     // Length of operating codeword. It's calculated by derived Class
     // FIXME: move n to protected
     T n;
 
-    uint64_t total_encode_cycles = 0;
-    uint64_t n_encode_ops = 0;
-    uint64_t total_decode_cycles = 0;
-    uint64_t n_decode_ops = 0;
+    // Statistics of the last operations, aggregated over concurrent ones.
+    // Writers update them under `stats_mutex` so that a reset never
+    // interleaves with a partial update; readers may load them lock-free.
+    std::atomic<uint64_t> total_encode_cycles{0};
+    std::atomic<uint64_t> n_encode_ops{0};
+    std::atomic<uint64_t> total_decode_cycles{0};
+    std::atomic<uint64_t> n_decode_ops{0};
+
+    std::atomic<uint64_t> total_enc_usec{0};
+    std::atomic<uint64_t> total_dec_usec{0};
 
-    uint64_t total_enc_usec = 0;
-    uint64_t total_dec_usec = 0;
+    // Per-stage statistics of block operations, accumulated until reset
+    StageStats stage_stats;
 
     FecCode(
         FecType type,
@@ -173,7 +307,7 @@ class FecCode {
     bool readw(T* ptr, std::istream* stream);
     bool writew(T val, std::ostream* stream);
 
-    bool read_pkt(char* pkt, std::istream& stream);
+    bool read_pkt(char* pkt, std::istream& stream, size_t bytes);
     bool write_pkt(char* pkt, std::ostream& stream, size_t bytes);
 
     void encode_streams_horizontal(
@@ -208,7 +342,24 @@ class FecCode {
         std::vector<uint8_t*> parities_bufs,
         std::vector<Properties>& parities_props,
         std::vector<bool> wanted_idxs,
-        size_t block_size_bytes);
+        size_t block_size_bytes)
+    {
+        encode_blocks_vertical(
+            data_bufs,
+            parities_bufs,
+            parities_props,
+            wanted_idxs,
+            block_size_bytes,
+            default_workspace);
+    }
+
+    void encode_blocks_vertical(
+        const std::vector<uint8_t*>& data_bufs,
+        const std::vector<uint8_t*>& parities_bufs,
+        std::vector<Properties>& parities_props,
+        const std::vector<bool>& wanted_idxs,
+        size_t block_size_bytes,
+        Workspace<T>& workspace);
 
     bool decode_blocks_vertical(
         std::vector<uint8_t*> data_bufs,
@@ -216,15 +367,110 @@ class FecCode {
         const std::vector<Properties>& parities_props,
         std::vector<int> missing_idxs,
         std::vector<bool> wanted_idxs,
-        size_t block_size_bytes);
+        size_t block_size_bytes)
+    {
+        return decode_blocks_vertical(
+            data_bufs,
+            parities_bufs,
+            parities_props,
+            missing_idxs,
+            wanted_idxs,
+            block_size_bytes,
+            default_workspace);
+    }
+
+    bool decode_blocks_vertical(
+        const std::vector<uint8_t*>& data_bufs,
+        const std::vector<uint8_t*>& parities_bufs,
+        const std::vector<Properties>& parities_props,
+        const std::vector<int>& missing_idxs,
+        const std::vector<bool>& wanted_idxs,
+        size_t block_size_bytes,
+        Workspace<T>& workspace);
+
+    void update_parities(
+        unsigned frag_idx,
+        const uint8_t* old_data,
+        const uint8_t* new_data,
+        std::vector<uint8_t*> parities_bufs,
+        std::vector<Properties>& parities_props,
+        size_t offset_bytes,
+        size_t size_bytes);
 
     const gf::Field<T>& get_gf()
     {
         return *gf;
     }
 
+    /** Size in bytes of the coded fragments of data fragments of `size_bytes`
+     * bytes
+     *
+     * A trailing partial word is coded as a whole one when coded words are
+     * wider than data words.
+     */
+    size_t get_coded_size(size_t size_bytes) const
+    {
+        if (coded_word_size == word_size) {
+            return size_bytes;
+        }
+        return (size_bytes + word_size - 1) / word_size * coded_word_size;
+    }
+
+    /** Size in bytes of the data fragments of coded fragments of `size_bytes`
+     * bytes
+     */
+    size_t get_data_size(size_t size_bytes) const
+    {
+        if (coded_word_size == word_size) {
+            return size_bytes;
+        }
+        return size_bytes / coded_word_size * word_size;
+    }
+
+    /** Set the number of threads used to encode blocks.
+     *
+     * Packets of a block are independent, hence `encode_blocks_vertical` can
+     * split them across several workers. By default, a single thread is used.
+     *
+     * @param n_threads number of workers, 0 to use the number of hardware
+     * threads
+     */
+    void set_n_threads(unsigned n_threads)
+    {
+        if (n_threads == 0) {
+            n_threads = std::max(1U, std::thread::hardware_concurrency());
+        }
+        this->n_threads = n_threads;
+    }
+
+    unsigned get_n_threads() const
+    {
+        return n_threads;
+    }
+
+    /** Set the maximal number of cached decoding contexts of the workspace
+     * owned by the code.
+     *
+     * @see Workspace::set_context_cache_capacity
+     */
+    void set_context_cache_capacity(size_t capacity)
+    {
+        default_workspace.set_context_cache_capacity(capacity);
+    }
+
+    /** Release the memory kept across block operations by the workspace owned
+     * by the code.
+     *
+     * It is allocated again on demand.
+     */
+    void trim()
+    {
+        default_workspace.trim();
+    }
+
     void reset_stats_enc()
     {
+        std::lock_guard<std::mutex> lock(stats_mutex);
         total_encode_cycles = 0;
         n_encode_ops = 0;
         total_enc_usec = 0;
@@ -232,23 +478,65 @@ class FecCode {
 
     void reset_stats_dec()
     {
+        std::lock_guard<std::mutex> lock(stats_mutex);
         total_decode_cycles = 0;
         n_decode_ops = 0;
         total_dec_usec = 0;
     }
 
   protected:
+    // serializes resets and updates of the encode/decode statistics
+    std::mutex stats_mutex;
+
+    void add_stats_enc(uint64_t cycles, uint64_t usec, uint64_t n_ops)
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        total_encode_cycles += cycles;
+        total_enc_usec += usec;
+        n_encode_ops += n_ops;
+    }
+
+    void add_stats_dec(uint64_t cycles, uint64_t usec, uint64_t n_ops)
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        total_decode_cycles += cycles;
+        total_dec_usec += usec;
+        n_decode_ops += n_ops;
+    }
+
+    // alignment of blocks that Buffers can wrap without any copy
+    static constexpr size_t zero_copy_alignment =
+        std::max(simd::ALIGNMENT, alignof(T));
+    // number of words read from each stream at a time by horizontal coding
+    static constexpr size_t stream_batch_size = 1024;
+    // number of workers used to encode blocks
+    unsigned n_threads = 1;
     // primitive nth root of unity
     T r;
-    std::unique_ptr<gf::Field<T>> gf = nullptr;
-    std::unique_ptr<fft::FourierTransform<T>> fft = nullptr;
-    std::unique_ptr<fft::FourierTransform<T>> fft_2k = nullptr;
+    // field, FFTs and powers of `r` may be shared with other codes
+    // @see PlanRegistry
+    std::shared_ptr<gf::Field<T>> gf = nullptr;
+    std::shared_ptr<fft::FourierTransform<T>> fft = nullptr;
+    std::shared_ptr<fft::FourierTransform<T>> fft_2k = nullptr;
     // This vector MUST be initialized by derived Class using multiplicative FFT
-    std::unique_ptr<vec::Vector<T>> inv_r_powers = nullptr;
+    std::shared_ptr<vec::Vector<T>> inv_r_powers = nullptr;
     // This vector MUST be initialized by derived Class using multiplicative FFT
-    std::unique_ptr<vec::Vector<T>> r_powers = nullptr;
-    // buffers for intermediate symbols used for systematic FNT
-    std::unique_ptr<vec::Buffers<T>> dec_inter_codeword;
+    std::shared_ptr<vec::Vector<T>> r_powers = nullptr;
+    // ids of data fragments, used in encoding of systematic FFT-based codes
+    std::unique_ptr<vec::Vector<T>> enc_frag_ids;
+    // state of operations that aren't given a workspace
+    Workspace<T> default_workspace;
+
+    /// Throw if `size_bytes` of coded data aren't made of whole packets
+    void check_whole_packets(size_t size_bytes) const
+    {
+        if (whole_packets && size_bytes % buf_size != 0) {
+            throw InvalidArgument(
+                "FEC base: data must be made of whole packets");
+        }
+    }
+
+    void set_coded_word_size(unsigned size);
 
     // pure abstract methods that will be defined in derived class
     virtual void check_params() = 0;
@@ -269,6 +557,106 @@ class FecCode {
         init_others();
     }
 
+    /** Allocate the workspace used by `encode_packet`.
+     *
+     * @return nullptr if the Buffers encoding doesn't need any
+     */
+    virtual std::unique_ptr<EncodeWorkspace<T>> init_encode_workspace()
+    {
+        return nullptr;
+    }
+
+    /** Encode a packet using a given workspace.
+     *
+     * Calls on distinct workspaces and buffers can run concurrently. A null
+     * workspace stands for the one of the default workspace.
+     *
+     * Codes may skip the computation of outputs that are not wanted. Such
+     * outputs and their properties are then left empty.
+     *
+     * @note When `word_size == sizeof(T)`, `words` and `output` may wrap the
+     * caller blocks, hence `words` must be left untouched.
+     *
+     * @param wanted_idxs flags of wanted outputs of len n_outputs, empty if
+     * all outputs are wanted
+     */
+    virtual void encode_packet(
+        EncodeWorkspace<T>* /* workspace */,
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset,
+        vec::Buffers<T>& words,
+        const std::vector<bool>& /* wanted_idxs */)
+    {
+        StageTimer timer(stage_stats, Stage::FFT, n_data * buf_size);
+        encode(output, props, offset, words);
+    }
+
+    /** Allocate the state of the systematic encoding of FFT-based codes.
+     *
+     * Such codes encode data words by interpolating them as if they were
+     * received in the first `n_data` fragments, then by evaluating the
+     * polynomial over the codeword. They call it from `init_others`.
+     */
+    void init_systematic();
+
+    std::unique_ptr<EncodeWorkspace<T>> init_sys_encode_workspace();
+
+    virtual void decode_data(
+        const DecodeContext<T>& context,
+        vec::Buffers<T>& output,
+        vec::Buffers<T>& words);
+
+    void encode_packet_fft(
+        EncodeWorkspace<T>* workspace,
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset,
+        vec::Buffers<T>& words,
+        const std::vector<bool>& wanted_idxs);
+
+    void generator_column_buffers(unsigned frag_idx, vec::Vector<T>& column);
+
+    CachedDecodeContext<T>& get_context_dec(
+        DecodeContextCache<T>& cache,
+        vec::Vector<T>& fragments_ids,
+        size_t size = 0);
+
+    /** Get the field element of a stored symbol
+     *
+     * @param value symbol as stored in a fragment
+     * @param prop property attached to the symbol, 0 if none
+     */
+    virtual T restore_symbol(T value, uint32_t /* prop */)
+    {
+        return value;
+    }
+
+    virtual void generator_column(unsigned frag_idx, vec::Vector<T>& column);
+
+    bool blocks_aligned(
+        const std::vector<uint8_t*>& bufs,
+        size_t pkt_bytes,
+        size_t alignment) const;
+
+    void reserve_encode_workers(Workspace<T>& workspace, unsigned n_workers);
+
+    EncodeWorkspace<T>* get_default_encode_workspace();
+
+    vec::Buffers<T>* get_dec_inter_codeword(Workspace<T>& workspace);
+
+    void encode_blocks_range(
+        EncodeWorkspace<T>* workspace,
+        BlockScratch<T>& scratch,
+        const std::vector<uint8_t*>& data_bufs,
+        const std::vector<uint8_t*>& parities_bufs,
+        std::vector<Properties>& parities_props,
+        const std::vector<bool>& wanted_idxs,
+        size_t begin,
+        size_t end,
+        uint64_t& cycles,
+        uint64_t& usec);
+
     virtual void decode_prepare(
         const DecodeContext<T>& context,
         const std::vector<Properties>& props,
@@ -286,6 +674,30 @@ class FecCode {
         off_t offset,
         vec::Buffers<T>& words);
 
+    /** Pack received packets into words and prepare them for decoding.
+     *
+     * Codes may fuse both steps to save a pass over the words.
+     *
+     * @param src received packets, in the order of fragments ids of `context`
+     */
+    virtual void pack_prepare(
+        const DecodeContext<T>& context,
+        const std::vector<Properties>& props,
+        off_t offset,
+        const std::vector<uint8_t*>& src,
+        vec::Buffers<T>& words)
+    {
+        vec::pack<uint8_t, T>(
+            src, words.get_mem(), n_data, pkt_size, coded_word_size);
+        decode_prepare(context, props, offset, words);
+    }
+
+    virtual void decode_prepared(
+        const DecodeContext<T>& context,
+        vec::Buffers<T>& output,
+        vec::Buffers<T>& words,
+        vec::Buffers<T>* inter_codeword);
+
     virtual void decode_apply(
         const DecodeContext<T>& context,
         vec::Buffers<T>& output,
@@ -312,6 +724,25 @@ FecCode<T>::FecCode(
         (type == FecType::SYSTEMATIC) ? this->n_parities : this->code_len;
     this->pkt_size = pkt_size;
     this->buf_size = pkt_size * word_size;
+    this->coded_word_size = word_size;
+    this->coded_buf_size = buf_size;
+}
+
+/** Store symbols of coded fragments on words of `size` bytes
+ *
+ * Data fragments of systematic codes are also coded fragments, hence only
+ * non-systematic codes can widen their symbols.
+ *
+ * @param size size in bytes of coded words, at least `word_size`
+ */
+template <typename T>
+void FecCode<T>::set_coded_word_size(unsigned size)
+{
+    assert(size >= word_size && size <= sizeof(T));
+    assert(type == FecType::NON_SYSTEMATIC || size == word_size);
+
+    coded_word_size = size;
+    coded_buf_size = pkt_size * size;
 }
 
 template <typename T>
@@ -347,6 +778,13 @@ inline bool FecCode<T>::readw(T* ptr, std::istream* stream)
             *ptr = s;
             return true;
         }
+    } else if (word_size < sizeof(T)) {
+        // no integer type matches the word, e.g. of 6 or 7 bytes
+        T s = 0;
+        if (stream->read(reinterpret_cast<char*>(&s), word_size)) {
+            *ptr = s;
+            return true;
+        }
     } else {
         assert(false && "no such size");
     }
@@ -376,6 +814,10 @@ inline bool FecCode<T>::writew(T val, std::ostream* stream)
         __uint128_t s = val;
         if (stream->write(reinterpret_cast<char*>(&s), sizeof(s)))
             return true;
+    } else if (word_size < sizeof(T)) {
+        // no integer type matches the word, e.g. of 6 or 7 bytes
+        if (stream->write(reinterpret_cast<char*>(&val), word_size))
+            return true;
     } else {
         assert(false && "no such size");
     }
@@ -383,9 +825,9 @@ inline bool FecCode<T>::writew(T val, std::ostream* stream)
 }
 
 template <typename T>
-inline bool FecCode<T>::read_pkt(char* pkt, std::istream& stream)
+inline bool FecCode<T>::read_pkt(char* pkt, std::istream& stream, size_t bytes)
 {
-    return static_cast<bool>(stream.read(pkt, buf_size));
+    return static_cast<bool>(stream.read(pkt, bytes));
 }
 
 template <typename T>
@@ -410,15 +852,35 @@ void FecCode<T>::encode_streams_horizontal(
     std::vector<std::ostream*> output_parities_bufs,
     std::vector<Properties>& output_parities_props)
 {
-    bool cont = true;
     off_t offset = 0;
 
     assert(input_data_bufs.size() == n_data);
     assert(output_parities_bufs.size() == n_outputs);
     assert(output_parities_props.size() == n_outputs);
 
-    vec::Vector<T> words(*(this->gf), n_data);
-    vec::Vector<T> output(*(this->gf), get_n_outputs());
+    const int output_len = get_n_outputs();
+
+    // Streams are read and written by batches of words, the i-th word of each
+    // batch belonging to the i-th codeword. Batches are made of whole packets,
+    // so that they are encoded a packet at a time, as blocks are.
+    const size_t batch_size =
+        std::max<size_t>(1, stream_batch_size / pkt_size) * pkt_size;
+    const size_t batch_bytes = batch_size * word_size;
+    vec::Buffers<char> data_char(n_data, batch_bytes);
+    const std::vector<char*> data_mem_char = data_char.get_mem();
+    vec::Buffers<T> data_words(n_data, batch_size);
+    const std::vector<T*> data_mem_T = data_words.get_mem();
+    vec::Buffers<T> parities_words(output_len, batch_size);
+    const std::vector<T*> parities_mem_T = parities_words.get_mem();
+    vec::Buffers<char> parities_char(n_outputs, batch_size * coded_word_size);
+    const std::vector<char*> parities_mem_char = parities_char.get_mem();
+
+    // views of a packet of the batches
+    vec::Buffers<T> words(n_data, pkt_size, data_mem_T);
+    vec::Buffers<T> output(output_len, pkt_size, parities_mem_T);
+    // codes coding the symbols of a packet together encode word by word
+    vec::Vector<T> words_vec(*(this->gf), n_data);
+    vec::Vector<T> output_vec(*(this->gf), output_len);
 
     // clear property vectors
     for (auto& props : output_parities_props) {
@@ -427,38 +889,67 @@ void FecCode<T>::encode_streams_horizontal(
 
     reset_stats_enc();
 
-    while (true) {
-        words.zero_fill();
+    size_t n_words = batch_size;
+    while (n_words == batch_size) {
+        // only whole words of all streams are encoded
         for (unsigned i = 0; i < n_data; i++) {
-            T tmp;
-            if (!readw(&tmp, input_data_bufs[i])) {
-                cont = false;
-                break;
-            }
-            words.set(i, tmp);
+            input_data_bufs[i]->read(data_mem_char[i], batch_bytes);
+            const size_t read_words = input_data_bufs[i]->gcount() / word_size;
+            n_words = std::min(n_words, read_words);
         }
-        if (!cont)
+        if (n_words == 0) {
             break;
+        }
 
-        // std::cout << "words at " << offset << ": "; words.dump();
+        vec::pack<char, T>(
+            data_mem_char, data_mem_T, n_data, n_words, word_size);
+        // zero-out the trailing words of the last packet
+        const size_t batch_words =
+            ((n_words + pkt_size - 1) / pkt_size) * pkt_size;
+        for (unsigned i = 0; i < n_data; i++) {
+            std::fill(data_mem_T[i] + n_words, data_mem_T[i] + batch_words, 0);
+        }
 
         timeval t1 = tick();
         uint64_t start = hw_timer();
-        encode(output, output_parities_props, offset, words);
+        if (whole_packets) {
+            for (size_t j = 0; j < n_words; ++j) {
+                for (unsigned i = 0; i < n_data; i++) {
+                    words_vec.set(i, data_mem_T[i][j]);
+                }
+                encode(
+                    output_vec, output_parities_props, offset + j, words_vec);
+                for (unsigned i = 0; i < n_outputs; i++) {
+                    parities_mem_T[i][j] = output_vec.get(i);
+                }
+            }
+        } else {
+            for (size_t j = 0; j < batch_words; j += pkt_size) {
+                words.set_view(data_mem_T, j, pkt_size);
+                output.set_view(parities_mem_T, j, pkt_size);
+                encode(output, output_parities_props, offset + j, words);
+            }
+        }
         uint64_t end = hw_timer();
         uint64_t t2 = hrtime_usec(t1);
 
-        // std::cout << "output: "; output.dump();
-
-        total_enc_usec += t2;
-        total_encode_cycles += (end - start) / word_size;
-        n_encode_ops++;
+        add_stats_enc((end - start) / word_size, t2, n_words);
 
+        vec::unpack<T, char>(
+            parities_mem_T,
+            parities_mem_char,
+            n_outputs,
+            n_words,
+            coded_word_size);
         for (unsigned i = 0; i < n_outputs; i++) {
-            T tmp = output.get(i);
-            writew(tmp, output_parities_bufs[i]);
+            if (output_parities_bufs[i] != nullptr) {
+                write_pkt(
+                    parities_mem_char[i],
+                    *(output_parities_bufs[i]),
+                    n_words * coded_word_size);
+            }
         }
-        offset++;
+        offset += n_words;
     }
 }
 
@@ -493,7 +984,7 @@ void FecCode<T>::encode_streams_vertical(
     vec::Buffers<T> output(output_len, pkt_size);
     const std::vector<T*> output_mem_T = output.get_mem();
     // vector of buffers storing data in output chunk
-    vec::Buffers<char> output_char(output_len, buf_size);
+    vec::Buffers<char> output_char(output_len, coded_buf_size);
     const std::vector<char*> output_mem_char = output_char.get_mem();
 
     reset_stats_enc();
@@ -504,7 +995,8 @@ void FecCode<T>::encode_streams_vertical(
 
     while (cont) {
         for (unsigned i = 0; i < n_data; i++) {
-            if (!read_pkt(words_mem_char.at(i), *(input_data_bufs[i]))) {
+            if (!read_pkt(
+                    words_mem_char.at(i), *(input_data_bufs[i]), buf_size)) {
                 read_bytes = input_data_bufs[i]->gcount();
                 // Zero-out trailing part
                 std::fill_n(
@@ -519,6 +1011,7 @@ void FecCode<T>::encode_streams_vertical(
         if (read_bytes == 0) {
             break;
         }
+        check_whole_packets(read_bytes);
 
         vec::pack<char, T>(
             words_mem_char, words_mem_T, n_data, pkt_size, word_size);
@@ -529,16 +1022,20 @@ void FecCode<T>::encode_streams_vertical(
         uint64_t end = hw_timer();
         uint64_t t2 = hrtime_usec(t1);
 
-        total_enc_usec += t2;
-        total_encode_cycles += (end - start) / buf_size;
-        n_encode_ops++;
+        add_stats_enc((end - start) / buf_size, t2, 1);
 
         vec::unpack<T, char>(
-            output_mem_T, output_mem_char, output_len, pkt_size, word_size);
+            output_mem_T,
+            output_mem_char,
+            output_len,
+            pkt_size,
+            coded_word_size);
 
         for (unsigned i = 0; i < n_outputs; i++) {
             write_pkt(
-                output_mem_char.at(i), *(output_parities_bufs[i]), read_bytes);
+                output_mem_char.at(i),
+                *(output_parities_bufs[i]),
+                get_coded_size(read_bytes));
         }
         offset += pkt_size;
     }
@@ -567,7 +1064,6 @@ bool FecCode<T>::decode_streams_horizontal(
     std::vector<std::ostream*> output_data_bufs)
 {
     off_t offset = 0;
-    bool cont = true;
 
     unsigned fragment_index = 0;
     unsigned parity_index = 0;
@@ -622,60 +1118,128 @@ bool FecCode<T>::decode_streams_horizontal(
 
     decode_build();
 
-    int n_words = code_len;
-    if (type == FecType::SYSTEMATIC) {
-        n_words = n_data;
+    // Streams of received fragments, in the order of `fragments_ids`
+    std::vector<std::istream*> received_bufs(n_data);
+    for (unsigned i = 0; i < avail_data_nb; ++i) {
+        received_bufs[i] = input_data_bufs[fragments_ids.get(i)];
+    }
+    for (unsigned i = 0; i < n_data - avail_data_nb; ++i) {
+        received_bufs[avail_data_nb + i] =
+            input_parities_bufs[avail_parity_ids.get(i)];
     }
 
-    vec::Vector<T> words(*(this->gf), n_words);
-    vec::Vector<T> output(*(this->gf), n_data);
+    // Streams are read and written by batches of words, the i-th word of each
+    // batch belonging to the i-th codeword. Batches are made of whole packets,
+    // so that they are decoded a packet at a time, as blocks are.
+    const size_t batch_size =
+        std::max<size_t>(1, stream_batch_size / pkt_size) * pkt_size;
+    const size_t batch_bytes = batch_size * word_size;
+    const size_t received_batch_bytes = batch_size * coded_word_size;
+    vec::Buffers<char> received_char(n_data, received_batch_bytes);
+    const std::vector<char*> received_mem_char = received_char.get_mem();
+    vec::Buffers<T> received_words(n_data, batch_size);
+    const std::vector<T*> received_mem_T = received_words.get_mem();
+    vec::Buffers<T> data_words(n_data, batch_size);
+    const std::vector<T*> data_mem_T = data_words.get_mem();
+    vec::Buffers<char> data_char(n_data, batch_bytes);
+    const std::vector<char*> data_mem_char = data_char.get_mem();
+
+    // view of a packet of the received batch
+    vec::Buffers<T> words(n_data, pkt_size, received_mem_T);
+    // codes coding the symbols of a packet together decode word by word
+    const int n_words = (type == FecType::SYSTEMATIC) ? n_data : code_len;
+    vec::Vector<T> words_vec(*(this->gf), n_words);
+    vec::Vector<T> output_vec(*(this->gf), n_data);
+
+    const DecodeContext<T>* context = nullptr;
+    vec::Buffers<T>* output = nullptr;
+    vec::Buffers<T>* inter_codeword = nullptr;
+    if (whole_packets) {
+        context =
+            get_context_dec(default_workspace.context_cache, fragments_ids)
+                .context.get();
+    } else {
+        CachedDecodeContext<T>& cached = get_context_dec(
+            default_workspace.context_cache, fragments_ids, pkt_size);
+        context = cached.context.get();
+        output = cached.output.get();
+        inter_codeword = get_dec_inter_codeword(default_workspace);
+    }
 
-    std::unique_ptr<DecodeContext<T>> context = init_context_dec(fragments_ids);
-    while (true) {
-        words.zero_fill();
-        if (type == FecType::SYSTEMATIC) {
-            for (unsigned i = 0; i < avail_data_nb; ++i) {
-                unsigned data_idx = fragments_ids.get(i);
-                T tmp;
-                if (!readw(&tmp, input_data_bufs[data_idx])) {
-                    cont = false;
-                    break;
-                }
-                words.set(i, tmp);
-            }
-            if (!cont)
-                break;
-        }
-        for (unsigned i = 0; i < n_data - avail_data_nb; ++i) {
-            unsigned parity_idx = avail_parity_ids.get(i);
-            T tmp;
-            if (!readw(&tmp, input_parities_bufs[parity_idx])) {
-                cont = false;
-                break;
-            }
-            words.set(avail_data_nb + i, tmp);
+    size_t n_batch_words = batch_size;
+    while (n_batch_words == batch_size) {
+        // only whole words of all streams are decoded
+        for (unsigned i = 0; i < n_data; i++) {
+            received_bufs[i]->read(received_mem_char[i], received_batch_bytes);
+            const size_t read_words =
+                received_bufs[i]->gcount() / coded_word_size;
+            n_batch_words = std::min(n_batch_words, read_words);
         }
-        if (!cont)
+        if (n_batch_words == 0) {
             break;
+        }
+
+        vec::pack<char, T>(
+            received_mem_char,
+            received_mem_T,
+            n_data,
+            n_batch_words,
+            coded_word_size);
+        // zero-out the trailing words of the last packet
+        const size_t batch_words =
+            ((n_batch_words + pkt_size - 1) / pkt_size) * pkt_size;
+        for (unsigned i = 0; i < n_data; i++) {
+            std::fill(
+                received_mem_T[i] + n_batch_words,
+                received_mem_T[i] + batch_words,
+                0);
+        }
 
         timeval t1 = tick();
         uint64_t start = hw_timer();
-        decode(*context, output, input_parities_props, offset, words);
+        if (whole_packets) {
+            for (size_t j = 0; j < n_batch_words; ++j) {
+                words_vec.zero_fill();
+                for (unsigned i = 0; i < n_data; i++) {
+                    words_vec.set(i, received_mem_T[i][j]);
+                }
+                decode(
+                    *context,
+                    output_vec,
+                    input_parities_props,
+                    offset + j,
+                    words_vec);
+                for (unsigned i = 0; i < n_data; i++) {
+                    data_mem_T[i][j] = output_vec.get(i);
+                }
+            }
+        } else {
+            for (size_t j = 0; j < batch_words; j += pkt_size) {
+                words.set_view(received_mem_T, j, pkt_size);
+                decode_prepare(
+                    *context, input_parities_props, offset + j, words);
+                decode_prepared(*context, *output, words, inter_codeword);
+                for (unsigned i = 0; i < n_data; i++) {
+                    std::copy_n(output->get(i), pkt_size, data_mem_T[i] + j);
+                }
+            }
+        }
         uint64_t end = hw_timer();
         uint64_t t2 = hrtime_usec(t1);
 
-        total_dec_usec += t2;
-        total_decode_cycles += (end - start) / word_size;
-        n_decode_ops++;
+        add_stats_dec((end - start) / word_size, t2, n_batch_words);
 
+        vec::unpack<T, char>(
+            data_mem_T, data_mem_char, n_data, n_batch_words, word_size);
         for (unsigned i = 0; i < n_data; i++) {
             if (output_data_bufs[i] != nullptr) {
-                T tmp = output.get(i);
-                writew(tmp, output_data_bufs[i]);
+                write_pkt(
+                    data_mem_char[i],
+                    *(output_data_bufs[i]),
+                    n_batch_words * word_size);
             }
         }
-
-        offset++;
+        offset += n_batch_words;
     }
 
     return true;
@@ -783,6 +1347,36 @@ std::unique_ptr<DecodeContext<T>> FecCode<T>::init_context_dec(
         *gf, *fft, *fft_2k, fragments_ids, vx, n_data, n, -1, size, output);
 }
 
+/** Get the decoding context of given received fragments
+ *
+ * The context is built by `init_context_dec` the first time an erasure pattern
+ * is seen, and then served from the cache.
+ *
+ * @param fragments_ids ids of received fragments
+ * @param size number of symbols per buffer, 0 for decoding of vectors
+ * @return the cached context, along with the output buffers bound to it
+ */
+template <typename T>
+CachedDecodeContext<T>&
+FecCode<T>::get_context_dec(
+    DecodeContextCache<T>& cache,
+    vec::Vector<T>& fragments_ids,
+    size_t size)
+{
+    CachedDecodeContext<T>* cached = cache.get(fragments_ids, size);
+    if (cached != nullptr) {
+        return *cached;
+    }
+
+    CachedDecodeContext<T> entry;
+    if (size > 0) {
+        entry.output = std::make_unique<vec::Buffers<T>>(n_data, size);
+    }
+    entry.context = init_context_dec(fragments_ids, size, entry.output.get());
+
+    return cache.put(fragments_ids, size, std::move(entry));
+}
+
 /* Prepare for decoding
  * It supports for FEC using multiplicative FFT over FNT
  */
@@ -947,7 +1541,7 @@ bool FecCode<T>::decode_streams_vertical(
     decode_build();
 
     // vector of buffers storing data read from chunk
-    vec::Buffers<char> words_char(n_data, buf_size);
+    vec::Buffers<char> words_char(n_data, coded_buf_size);
     const std::vector<char*> words_mem_char = words_char.get_mem();
     // vector of buffers storing data that are performed in encoding, i.e. FFT
     vec::Buffers<T> words(n_data, pkt_size);
@@ -955,33 +1549,36 @@ bool FecCode<T>::decode_streams_vertical(
 
     int output_len = n_data;
 
+    CachedDecodeContext<T>& cached = get_context_dec(
+        default_workspace.context_cache, fragments_ids, pkt_size);
+    const DecodeContext<T>* context = cached.context.get();
+
     // vector of buffers storing data that are performed in decoding, i.e. FFT
-    vec::Buffers<T> output(output_len, pkt_size);
+    vec::Buffers<T>& output = *(cached.output);
     const std::vector<T*> output_mem_T = output.get_mem();
     // vector of buffers storing data in output chunk
     vec::Buffers<char> output_char(output_len, buf_size);
     const std::vector<char*> output_mem_char = output_char.get_mem();
 
-    std::unique_ptr<DecodeContext<T>> context =
-        init_context_dec(fragments_ids, pkt_size, &output);
-
     reset_stats_dec();
 
     // Number of bytes would be read from each input stream
     // We suppose that these stream returns the same quantity of data.
-    size_t read_bytes = buf_size;
+    size_t read_bytes = coded_buf_size;
 
     while (cont) {
         if (type == FecType::SYSTEMATIC) {
             for (unsigned i = 0; i < avail_data_nb; i++) {
                 unsigned data_idx = fragments_ids.get(i);
                 if (!read_pkt(
-                        words_mem_char.at(i), *(input_data_bufs[data_idx]))) {
+                        words_mem_char.at(i),
+                        *(input_data_bufs[data_idx]),
+                        coded_buf_size)) {
                     read_bytes = input_data_bufs[data_idx]->gcount();
                     // Zero-out trailing part
                     std::fill_n(
                         words_mem_char.at(i) + read_bytes,
-                        buf_size - read_bytes,
+                        coded_buf_size - read_bytes,
                         0);
 
                     cont = false;
@@ -992,12 +1589,13 @@ bool FecCode<T>::decode_streams_vertical(
             unsigned parity_idx = avail_parity_ids.get(i);
             if (!read_pkt(
                     words_mem_char.at(avail_data_nb + i),
-                    *(input_parities_bufs[parity_idx]))) {
+                    *(input_parities_bufs[parity_idx]),
+                    coded_buf_size)) {
                 read_bytes = input_parities_bufs[parity_idx]->gcount();
                 // Zero-out trailing part
                 std::fill_n(
                     words_mem_char.at(avail_data_nb + i) + read_bytes,
-                    buf_size - read_bytes,
+                    coded_buf_size - read_bytes,
                     0);
 
                 cont = false;
@@ -1007,9 +1605,10 @@ bool FecCode<T>::decode_streams_vertical(
         if (read_bytes == 0) {
             break;
         }
+        check_whole_packets(get_data_size(read_bytes));
 
         vec::pack<char, T>(
-            words_mem_char, words_mem_T, n_data, pkt_size, word_size);
+            words_mem_char, words_mem_T, n_data, pkt_size, coded_word_size);
 
         timeval t1 = tick();
         uint64_t start = hw_timer();
@@ -1017,9 +1616,7 @@ bool FecCode<T>::decode_streams_vertical(
         uint64_t end = hw_timer();
         uint64_t t2 = hrtime_usec(t1);
 
-        total_dec_usec += t2;
-        total_decode_cycles += (end - start) / word_size;
-        n_decode_ops++;
+        add_stats_dec((end - start) / word_size, t2, 1);
 
         vec::unpack<T, char>(
             output_mem_T, output_mem_char, output_len, pkt_size, word_size);
@@ -1027,7 +1624,9 @@ bool FecCode<T>::decode_streams_vertical(
         for (unsigned i = 0; i < n_data; i++) {
             if (output_data_bufs[i] != nullptr) {
                 write_pkt(
-                    output_mem_char.at(i), *(output_data_bufs[i]), read_bytes);
+                    output_mem_char.at(i),
+                    *(output_data_bufs[i]),
+                    get_data_size(read_bytes));
             }
         }
         offset += pkt_size;
@@ -1047,95 +1646,516 @@ bool FecCode<T>::decode_streams_vertical(
  * @param wanted_idxs bool array of missing_idxs of len n_outputs indicating
  * wanted (value 1) or not wanted fragments (value 0) - wanted blocks MUST BE
  * allocated by caller
- * @param block_size_bytes the block size in bytes
+ * @param block_size_bytes the size in bytes of data blocks, parity blocks are
+ * get_coded_size(block_size_bytes) bytes long
+ * @param workspace scratch state used by this call
  *
- * @pre All blocks must be of equal size
+ * @pre All data blocks must be of equal size
+ *
+ * @note Codes may compute only the wanted fragments, in which case properties
+ * of not wanted fragments are left empty
+ *
+ * @note Packets are split across `get_n_threads()` workers
+ *
+ * @note Concurrent calls on the same code are safe as long as each one uses
+ * its own workspace
  */
 template <typename T>
 void FecCode<T>::encode_blocks_vertical(
-    std::vector<uint8_t*> data_bufs,
-    std::vector<uint8_t*> parities_bufs,
+    const std::vector<uint8_t*>& data_bufs,
+    const std::vector<uint8_t*>& parities_bufs,
     std::vector<Properties>& parities_props,
-    std::vector<bool> wanted_idxs,
-    size_t block_size_bytes)
+    const std::vector<bool>& wanted_idxs,
+    size_t block_size_bytes,
+    Workspace<T>& workspace)
 {
     assert(data_bufs.size() == n_data);
     assert(parities_bufs.size() == n_outputs);
     assert(parities_props.size() == n_outputs);
+    check_whole_packets(block_size_bytes);
 
     // clear property vectors
     for (auto& props : parities_props) {
         props.clear();
     }
 
-    size_t offset = 0;
-    size_t block_size = block_size_bytes / word_size;
+    const size_t block_size = block_size_bytes / word_size;
+    const size_t n_pkts = (block_size + pkt_size - 1) / pkt_size;
+
+    reset_stats_enc();
+
+    if (n_threads <= 1 || n_pkts <= 1) {
+        uint64_t cycles = 0;
+        uint64_t usec = 0;
+        reserve_encode_workers(workspace, 1);
+        encode_blocks_range(
+            workspace.enc_workspaces[0].get(),
+            *(workspace.enc_scratch[0]),
+            data_bufs,
+            parities_bufs,
+            parities_props,
+            wanted_idxs,
+            0,
+            block_size,
+            cycles,
+            usec);
+        add_stats_enc(cycles, usec, n_pkts);
+        return;
+    }
+
+    // Split packets in contiguous ranges, one per worker
+    const size_t pkts_per_worker = (n_pkts + n_threads - 1) / n_threads;
+    const size_t range_size = pkts_per_worker * pkt_size;
+    const unsigned n_workers = (n_pkts + pkts_per_worker - 1) / pkts_per_worker;
+
+    // Workspaces are allocated upfront so that only the encoding runs
+    // concurrently
+    reserve_encode_workers(workspace, n_workers);
+    std::vector<std::vector<Properties>> workers_props(
+        n_workers, std::vector<Properties>(n_outputs));
+    std::vector<uint64_t> workers_cycles(n_workers, 0);
+    std::vector<uint64_t> workers_usec(n_workers, 0);
+    std::vector<std::exception_ptr> errors(n_workers);
+
+    auto run_worker = [&](unsigned w) {
+        const size_t begin = w * range_size;
+        const size_t end = std::min(begin + range_size, block_size);
+        try {
+            encode_blocks_range(
+                workspace.enc_workspaces[w].get(),
+                *(workspace.enc_scratch[w]),
+                data_bufs,
+                parities_bufs,
+                workers_props[w],
+                wanted_idxs,
+                begin,
+                end,
+                workers_cycles[w],
+                workers_usec[w]);
+        } catch (...) {
+            errors[w] = std::current_exception();
+        }
+    };
+
+    // The calling thread encodes the first range itself
+    std::vector<std::thread> workers;
+    for (unsigned w = 1; w < n_workers; ++w) {
+        workers.emplace_back(run_worker, w);
+    }
+    run_worker(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
 
+    uint64_t cycles = 0;
+    uint64_t usec = 0;
+    for (unsigned w = 0; w < n_workers; ++w) {
+        if (errors[w]) {
+            std::rethrow_exception(errors[w]);
+        }
+        for (unsigned i = 0; i < n_outputs; ++i) {
+            parities_props[i].merge(workers_props[w][i]);
+        }
+        cycles += workers_cycles[w];
+        usec += workers_usec[w];
+    }
+    add_stats_enc(cycles, usec, n_pkts);
+}
+
+/** Allocate the state of encoding workers that is still missing
+ *
+ * @param n_workers number of workers
+ */
+template <typename T>
+void FecCode<T>::reserve_encode_workers(
+    Workspace<T>& workspace,
+    unsigned n_workers)
+{
+    while (workspace.enc_scratch.size() < n_workers) {
+        workspace.enc_scratch.push_back(std::make_unique<BlockScratch<T>>(
+            n_data,
+            get_n_outputs(),
+            pkt_size,
+            buf_size,
+            coded_buf_size,
+            true));
+    }
+    while (workspace.enc_workspaces.size() < n_workers) {
+        workspace.enc_workspaces.push_back(init_encode_workspace());
+    }
+}
+
+/** Get the encoding workspace of packets encoded without any workspace
+ *
+ * It is the one of the first worker of the default workspace.
+ */
+template <typename T>
+EncodeWorkspace<T>* FecCode<T>::get_default_encode_workspace()
+{
+    if (default_workspace.enc_workspaces.empty()) {
+        default_workspace.enc_workspaces.push_back(init_encode_workspace());
+    }
+    return default_workspace.enc_workspaces[0].get();
+}
+
+/** Get the buffers for intermediate symbols of systematic decoding
+ *
+ * @return nullptr for non-systematic codes
+ */
+template <typename T>
+vec::Buffers<T>* FecCode<T>::get_dec_inter_codeword(Workspace<T>& workspace)
+{
+    if (type == FecType::SYSTEMATIC
+        && workspace.dec_inter_codeword == nullptr) {
+        workspace.dec_inter_codeword =
+            std::make_unique<vec::Buffers<T>>(n, pkt_size);
+    }
+    return workspace.dec_inter_codeword.get();
+}
+
+/** Encode a range of packets of blocks
+ *
+ * Full packets are packed from the data blocks and unpacked into the wanted
+ * parity blocks directly, provided that blocks are aligned on words. If words
+ * are stored as T and blocks are aligned for SIMD, the blocks are even encoded
+ * in place, without any copy.
+ *
+ * @param workspace scratch state used to encode, nullptr to use the one of
+ * the default workspace
+ * @param scratch buffers used to process packets
+ * @param data_bufs vector size must be exactly n_data
+ * @param parities_bufs vector size must be exactly n_outputs
+ * @param parities_props vector size must be exactly n_outputs
+ * @param wanted_idxs bool array of len n_outputs indicating wanted fragments
+ * @param begin index of the first word to encode, multiple of pkt_size
+ * @param end index following the last word to encode
+ * @param cycles counter to which the encoding cycles are added
+ * @param usec counter to which the encoding time is added
+ */
+template <typename T>
+void FecCode<T>::encode_blocks_range(
+    EncodeWorkspace<T>* workspace,
+    BlockScratch<T>& scratch,
+    const std::vector<uint8_t*>& data_bufs,
+    const std::vector<uint8_t*>& parities_bufs,
+    std::vector<Properties>& parities_props,
+    const std::vector<bool>& wanted_idxs,
+    size_t begin,
+    size_t end,
+    uint64_t& cycles,
+    uint64_t& usec)
+{
     // vector of buffers storing data read from chunk
-    vec::Buffers<uint8_t> words_char(n_data, buf_size);
-    const std::vector<uint8_t*> words_mem_char = words_char.get_mem();
+    const std::vector<uint8_t*> words_mem_char = scratch.words_char.get_mem();
     // vector of buffers storing data that are performed in encoding, i.e. FFT
-    vec::Buffers<T> words(n_data, pkt_size);
+    vec::Buffers<T>& words = scratch.words;
     const std::vector<T*> words_mem_T = words.get_mem();
 
     int output_len = get_n_outputs();
 
     // vector of buffers storing data that are performed in encoding, i.e. FFT
-    vec::Buffers<T> output(output_len, pkt_size);
+    vec::Buffers<T>& output = *(scratch.output);
     const std::vector<T*> output_mem_T = output.get_mem();
     // vector of buffers storing data in output chunk
-    vec::Buffers<uint8_t> output_char(output_len, buf_size);
-    const std::vector<uint8_t*> output_mem_char = output_char.get_mem();
-
-    reset_stats_enc();
-
-    while (offset < block_size) {
-        size_t remain_size = block_size - offset;
-        size_t copy_size = std::min(pkt_size, remain_size);
-        for (unsigned i = 0; i < n_data; i++) {
-            memcpy(
-                reinterpret_cast<char*>(words_mem_char.at(i)),
-                data_bufs[i] + offset * word_size,
-                copy_size * word_size);
+    const std::vector<uint8_t*> output_mem_char =
+        scratch.output_char.get_mem();
+
+    // Pointers to the packets of blocks, the ones of not wanted outputs
+    // point to `output_char` (or `output` in zero-copy mode)
+    std::vector<uint8_t*> data_mem(n_data);
+    std::vector<uint8_t*> parities_mem(output_mem_char);
+    std::vector<T*> data_mem_T(n_data);
+    std::vector<T*> parities_mem_T(output_mem_T);
+
+    std::vector<uint8_t*> wanted_bufs;
+    for (unsigned i = 0; i < n_outputs; i++) {
+        if (wanted_idxs[i]) {
+            wanted_bufs.push_back(parities_bufs[i]);
         }
-
-        // Zero-out trailing part of data
-        if (copy_size < pkt_size) {
-            const size_t copy_bytes = copy_size * word_size;
-            const size_t trailing_bytes = buf_size - copy_bytes;
+    }
+    const bool aligned =
+        blocks_aligned(data_bufs, buf_size, word_size)
+        && blocks_aligned(wanted_bufs, coded_buf_size, coded_word_size);
+    const bool zero_copy =
+        word_size == sizeof(T) && coded_word_size == sizeof(T)
+        && blocks_aligned(data_bufs, buf_size, zero_copy_alignment)
+        && blocks_aligned(wanted_bufs, coded_buf_size, zero_copy_alignment);
+
+    for (size_t offset = begin; offset < end; offset += pkt_size) {
+        const size_t copy_size = std::min(pkt_size, end - offset);
+        const size_t copy_bytes = copy_size * word_size;
+        const size_t coded_copy_bytes = copy_size * coded_word_size;
+        const bool full = copy_size == pkt_size;
+        const bool direct = aligned && full;
+
+        if (zero_copy && full) {
+            // Blocks are used as is by the encoding
             for (unsigned i = 0; i < n_data; i++) {
-                memset(
-                    reinterpret_cast<char*>(words_mem_char.at(i)) + copy_bytes,
-                    0,
-                    trailing_bytes);
+                data_mem_T[i] =
+                    reinterpret_cast<T*>(data_bufs[i] + offset * word_size);
+            }
+            for (unsigned i = 0; i < n_outputs; i++) {
+                if (wanted_idxs[i]) {
+                    parities_mem_T[i] = reinterpret_cast<T*>(
+                        parities_bufs[i] + offset * coded_word_size);
+                }
             }
+            vec::Buffers<T> data_words(n_data, pkt_size, data_mem_T);
+            vec::Buffers<T> parities_words(
+                output_len, pkt_size, parities_mem_T);
+
+            timeval t1 = tick();
+            uint64_t start = hw_timer();
+            encode_packet(
+                workspace,
+                parities_words,
+                parities_props,
+                offset,
+                data_words,
+                wanted_idxs);
+            uint64_t stop = hw_timer();
+            uint64_t t2 = hrtime_usec(t1);
+
+            usec += t2;
+            cycles += (stop - start) / copy_bytes;
+            continue;
         }
 
-        vec::pack<uint8_t, T>(
-            words_mem_char, words_mem_T, n_data, pkt_size, word_size);
+        if (direct) {
+            for (unsigned i = 0; i < n_data; i++) {
+                data_mem[i] = data_bufs[i] + offset * word_size;
+            }
+            StageTimer timer(stage_stats, Stage::PACK, n_data * buf_size);
+            vec::pack<uint8_t, T>(
+                data_mem, words_mem_T, n_data, pkt_size, word_size);
+        } else {
+            {
+                StageTimer timer(stage_stats, Stage::COPY);
+                for (unsigned i = 0; i < n_data; i++) {
+                    memcpy(
+                        reinterpret_cast<char*>(words_mem_char.at(i)),
+                        data_bufs[i] + offset * word_size,
+                        copy_bytes);
+                    timer.add_bytes(copy_bytes);
+                }
+
+                // Zero-out trailing part of data
+                if (copy_size < pkt_size) {
+                    const size_t trailing_bytes = buf_size - copy_bytes;
+                    for (unsigned i = 0; i < n_data; i++) {
+                        memset(
+                            reinterpret_cast<char*>(words_mem_char.at(i))
+                                + copy_bytes,
+                            0,
+                            trailing_bytes);
+                    }
+                }
+            }
+
+            StageTimer timer(stage_stats, Stage::PACK, n_data * buf_size);
+            vec::pack<uint8_t, T>(
+                words_mem_char, words_mem_T, n_data, pkt_size, word_size);
+        }
 
         timeval t1 = tick();
         uint64_t start = hw_timer();
-        encode(output, parities_props, offset, words);
-        uint64_t end = hw_timer();
+        encode_packet(
+            workspace, output, parities_props, offset, words, wanted_idxs);
+        uint64_t stop = hw_timer();
         uint64_t t2 = hrtime_usec(t1);
 
-        total_enc_usec += t2;
-        total_encode_cycles += (end - start) / (copy_size * word_size);
-        n_encode_ops++;
+        usec += t2;
+        cycles += (stop - start) / copy_bytes;
 
-        vec::unpack<T, uint8_t>(
-            output_mem_T, output_mem_char, output_len, pkt_size, word_size);
+        if (direct) {
+            for (unsigned i = 0; i < n_outputs; i++) {
+                parities_mem[i] =
+                    wanted_idxs[i] ? parities_bufs[i] + offset * coded_word_size
+                                   : output_mem_char.at(i);
+            }
+            StageTimer timer(
+                stage_stats, Stage::UNPACK, output_len * coded_buf_size);
+            vec::unpack<T, uint8_t>(
+                output_mem_T,
+                parities_mem,
+                output_len,
+                pkt_size,
+                coded_word_size);
+        } else {
+            {
+                StageTimer timer(
+                    stage_stats, Stage::UNPACK, output_len * coded_buf_size);
+                vec::unpack<T, uint8_t>(
+                    output_mem_T,
+                    output_mem_char,
+                    output_len,
+                    pkt_size,
+                    coded_word_size);
+            }
 
-        for (unsigned i = 0; i < n_outputs; i++) {
-            if (wanted_idxs[i]) {
-                memcpy(
-                    parities_bufs[i] + offset * word_size,
-                    reinterpret_cast<char*>(output_mem_char.at(i)),
-                    copy_size * word_size);
+            StageTimer timer(stage_stats, Stage::COPY);
+            for (unsigned i = 0; i < n_outputs; i++) {
+                if (wanted_idxs[i]) {
+                    memcpy(
+                        parities_bufs[i] + offset * coded_word_size,
+                        reinterpret_cast<char*>(output_mem_char.at(i)),
+                        coded_copy_bytes);
+                    timer.add_bytes(coded_copy_bytes);
+                }
             }
         }
-        offset += pkt_size;
+    }
+}
+
+/** Check that every packet of the given blocks is aligned
+ *
+ * Packets start every `pkt_bytes` bytes from the beginning of blocks.
+ *
+ * @param bufs blocks, nullptr entries are ignored
+ * @param pkt_bytes size in bytes of packets in the blocks
+ * @param alignment alignment constraint in bytes
+ * @return true if all packets are aligned on `alignment` bytes
+ */
+template <typename T>
+bool FecCode<T>::blocks_aligned(
+    const std::vector<uint8_t*>& bufs,
+    size_t pkt_bytes,
+    size_t alignment) const
+{
+    if (pkt_bytes % alignment != 0) {
+        return false;
+    }
+    for (const uint8_t* buf : bufs) {
+        if (buf != nullptr
+            && reinterpret_cast<uintptr_t>(buf) % alignment != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Update parities after a write on a data fragment
+ *
+ * Codes are linear, hence each output is shifted by the difference between the
+ * new and the old data, times the coefficient binding the data fragment to
+ * this output. Only the updated range is read and written.
+ *
+ * @param frag_idx index of the updated data fragment
+ * @param old_data previous content of the updated range
+ * @param new_data new content of the updated range
+ * @param parities_bufs vector size must be exactly n_outputs, pointing to the
+ * beginning of blocks (set entries to nullptr when not wanted)
+ * @param parities_props vector size must be exactly n_outputs
+ * @param offset_bytes offset of the updated range in the data block, multiple
+ * of word_size
+ * @param size_bytes size of the updated range, multiple of word_size
+ *
+ * @note parities are updated at the matching offset of the coded blocks, see
+ * get_coded_size()
+ *
+ * @note for NON_SYSTEMATIC codes, all outputs depend on the data fragment
+ */
+template <typename T>
+void FecCode<T>::update_parities(
+    unsigned frag_idx,
+    const uint8_t* old_data,
+    const uint8_t* new_data,
+    std::vector<uint8_t*> parities_bufs,
+    std::vector<Properties>& parities_props,
+    size_t offset_bytes,
+    size_t size_bytes)
+{
+    assert(frag_idx < n_data);
+    assert(parities_bufs.size() == n_outputs);
+    assert(parities_props.size() == n_outputs);
+    assert(offset_bytes % word_size == 0);
+    assert(size_bytes % word_size == 0);
+    if (whole_packets) {
+        throw LogicError("FEC base: packets can't be updated per symbol");
+    }
+
+    const size_t offset = offset_bytes / word_size;
+    const size_t size = size_bytes / word_size;
+    if (size == 0) {
+        return;
+    }
+
+    const int output_len = get_n_outputs();
+    vec::Vector<T> column(*gf, output_len);
+    generator_column(frag_idx, column);
+
+    // `vec::pack` only reads from its source buffers
+    const std::vector<uint8_t*> data_mem = {const_cast<uint8_t*>(old_data),
+                                            const_cast<uint8_t*>(new_data)};
+    vec::Buffers<T> data_words(2, size);
+    vec::pack<uint8_t, T>(data_mem, data_words.get_mem(), 2, size, word_size);
+    const T* old_words = data_words.get(0);
+    const T* new_words = data_words.get(1);
+
+    std::vector<unsigned> updated_idxs;
+    std::vector<uint8_t*> parities_mem;
+    for (unsigned i = 0; i < n_outputs; i++) {
+        if (parities_bufs[i] != nullptr) {
+            updated_idxs.push_back(i);
+            parities_mem.push_back(parities_bufs[i] + offset * coded_word_size);
+        }
+    }
+    const unsigned n_updated = updated_idxs.size();
+    if (n_updated == 0) {
+        return;
+    }
+    vec::Buffers<T> parities_words(n_updated, size);
+    const std::vector<T*> parities_mem_T = parities_words.get_mem();
+    vec::pack<uint8_t, T>(
+        parities_mem, parities_mem_T, n_updated, size, coded_word_size);
+
+    vec::Vector<T> output(*gf, output_len);
+    for (size_t i = 0; i < size; ++i) {
+        const off_t loc = offset + i;
+        const T delta = gf->sub(
+            restore_symbol(new_words[i], 0), restore_symbol(old_words[i], 0));
+
+        output.zero_fill();
+        for (unsigned k = 0; k < n_updated; ++k) {
+            const unsigned j = updated_idxs[k];
+            Properties& props = parities_props[j];
+            const T symbol =
+                restore_symbol(parities_mem_T[k][i], props.get(loc));
+
+            output.set(j, gf->add(symbol, gf->mul(column.get(j), delta)));
+            props.remove(loc);
+        }
+        // mark and store out-of-range values as done by the encoding
+        encode_post_process(output, parities_props, loc);
+
+        for (unsigned k = 0; k < n_updated; ++k) {
+            parities_mem_T[k][i] = output.get(updated_idxs[k]);
+        }
+    }
+
+    vec::unpack<T, uint8_t>(
+        parities_mem_T, parities_mem, n_updated, size, coded_word_size);
+}
+
+/** Compute the coefficients binding a data fragment to each output
+ *
+ * It is the column of the generator matrix corresponding to the data fragment,
+ * obtained here by encoding the unit vector of the fragment.
+ *
+ * @param frag_idx index of the data fragment
+ * @param column output coefficients, of length get_n_outputs()
+ */
+template <typename T>
+void FecCode<T>::generator_column(unsigned frag_idx, vec::Vector<T>& column)
+{
+    vec::Vector<T> words(*gf, n_data);
+    words.zero_fill();
+    words.set(frag_idx, 1);
+
+    std::vector<Properties> props(get_n_outputs());
+    encode(column, props, 0, words);
+    for (int i = 0; i < column.get_n(); i++) {
+        column.set(i, restore_symbol(column.get(i), props[i].get(0)));
     }
 }
 
@@ -1156,20 +2176,26 @@ void FecCode<T>::encode_blocks_vertical(
  * only for data
  * - wanted blocks MUST BE allocated
  * by caller
- * @param block_size_bytes the block size in bytes
+ * @param block_size_bytes the size in bytes of data blocks, parity blocks are
+ * get_coded_size(block_size_bytes) bytes long
+ * @param workspace scratch state and decoding contexts used by this call
+ *
+ * @pre All data blocks must be of equal size
  *
- * @pre All blocks must be of equal size
+ * @note Concurrent calls on the same code are safe as long as each one uses
+ * its own workspace
  *
  * @return true if decode succeeded, else false
  */
 template <typename T>
 bool FecCode<T>::decode_blocks_vertical(
-    std::vector<uint8_t*> data_bufs,
-    std::vector<uint8_t*> parities_bufs,
+    const std::vector<uint8_t*>& data_bufs,
+    const std::vector<uint8_t*>& parities_bufs,
     const std::vector<Properties>& parities_props,
-    std::vector<int> missing_idxs,
-    std::vector<bool> wanted_idxs,
-    size_t block_size_bytes)
+    const std::vector<int>& missing_idxs,
+    const std::vector<bool>& wanted_idxs,
+    size_t block_size_bytes,
+    Workspace<T>& workspace)
 {
     size_t offset = 0;
     size_t block_size = block_size_bytes / word_size;
@@ -1183,6 +2209,7 @@ bool FecCode<T>::decode_blocks_vertical(
     }
     assert(parities_bufs.size() == n_outputs);
     assert(parities_props.size() == n_outputs);
+    check_whole_packets(block_size_bytes);
 
     // ids of received fragments, from 0 to codelen-1
     vec::Vector<T> fragments_ids(*(this->gf), n_data);
@@ -1226,81 +2253,141 @@ bool FecCode<T>::decode_blocks_vertical(
 
     decode_build();
 
+    if (workspace.dec_scratch == nullptr) {
+        workspace.dec_scratch = std::make_unique<BlockScratch<T>>(
+            n_data, n_data, pkt_size, coded_buf_size, buf_size, false);
+    }
+    vec::Buffers<T>* inter_codeword = get_dec_inter_codeword(workspace);
     // vector of buffers storing data read from chunk
-    vec::Buffers<uint8_t> words_char(n_data, buf_size);
-    const std::vector<uint8_t*> words_mem_char = words_char.get_mem();
+    const std::vector<uint8_t*> words_mem_char =
+        workspace.dec_scratch->words_char.get_mem();
     // vector of buffers storing data that are performed in encoding, i.e. FFT
-    vec::Buffers<T> words(n_data, pkt_size);
-    const std::vector<T*> words_mem_T = words.get_mem();
+    vec::Buffers<T>& words = workspace.dec_scratch->words;
 
     int output_len = n_data;
 
+    CachedDecodeContext<T>* cached;
+    {
+        StageTimer timer(stage_stats, Stage::CONTEXT, 0);
+        cached =
+            &get_context_dec(workspace.context_cache, fragments_ids, pkt_size);
+    }
+    const DecodeContext<T>* context = cached->context.get();
+
     // vector of buffers storing data that are performed in decoding, i.e. FFT
-    vec::Buffers<T> output(output_len, pkt_size);
+    vec::Buffers<T>& output = *(cached->output);
     const std::vector<T*> output_mem_T = output.get_mem();
     // vector of buffers storing data in output chunk
-    vec::Buffers<uint8_t> output_char(output_len, buf_size);
-    const std::vector<uint8_t*> output_mem_char = output_char.get_mem();
+    const std::vector<uint8_t*> output_mem_char =
+        workspace.dec_scratch->output_char.get_mem();
 
-    std::unique_ptr<DecodeContext<T>> context =
-        init_context_dec(fragments_ids, pkt_size, &output);
+    // Blocks of received fragments, in the order of `fragments_ids`
+    std::vector<uint8_t*> received_bufs(n_data);
+    for (unsigned i = 0; i < avail_data_nb; i++) {
+        received_bufs[i] = data_bufs[fragments_ids.get(i)];
+    }
+    for (unsigned i = 0; i < n_data - avail_data_nb; ++i) {
+        received_bufs[avail_data_nb + i] =
+            parities_bufs[avail_parity_ids.get(i)];
+    }
+    std::vector<uint8_t*> wanted_bufs;
+    for (unsigned i = 0; i < n_data; i++) {
+        if (wanted_idxs[i]) {
+            wanted_bufs.push_back(data_bufs[i]);
+        }
+    }
+    const bool aligned =
+        blocks_aligned(received_bufs, coded_buf_size, coded_word_size)
+        && blocks_aligned(wanted_bufs, buf_size, word_size);
+
+    // Pointers to the packets of blocks, the ones of not wanted outputs
+    // point to `output_char`
+    std::vector<uint8_t*> received_mem(n_data);
+    std::vector<uint8_t*> data_mem(output_mem_char);
 
     reset_stats_dec();
 
     while (offset < block_size) {
         size_t remain_size = block_size - offset;
         size_t copy_size = std::min(pkt_size, remain_size);
-        if (type == FecType::SYSTEMATIC) {
-            for (unsigned i = 0; i < avail_data_nb; i++) {
-                unsigned data_idx = fragments_ids.get(i);
-                memcpy(
-                    reinterpret_cast<char*>(words_mem_char.at(i)),
-                    data_bufs[data_idx] + offset * word_size,
-                    copy_size * word_size);
-            }
-        }
-        for (unsigned i = 0; i < n_data - avail_data_nb; ++i) {
-            unsigned parity_idx = avail_parity_ids.get(i);
-            memcpy(
-                reinterpret_cast<char*>(words_mem_char.at(avail_data_nb + i)),
-                parities_bufs[parity_idx] + offset * word_size,
-                copy_size * word_size);
-        }
+        const bool direct = aligned && copy_size == pkt_size;
 
-        // Zero-out trailing part of data
-        if (copy_size < pkt_size) {
-            const size_t copy_bytes = copy_size * word_size;
-            const size_t trailing_bytes = buf_size - copy_bytes;
+        if (direct) {
             for (unsigned i = 0; i < n_data; i++) {
-                memset(
-                    reinterpret_cast<char*>(words_mem_char.at(i)) + copy_bytes,
-                    0,
-                    trailing_bytes);
+                received_mem[i] = received_bufs[i] + offset * coded_word_size;
             }
-        }
+            StageTimer timer(stage_stats, Stage::PACK, n_data * coded_buf_size);
+            pack_prepare(*context, parities_props, offset, received_mem, words);
+        } else {
+            {
+                const size_t copy_bytes = copy_size * coded_word_size;
+                StageTimer timer(stage_stats, Stage::COPY);
+                for (unsigned i = 0; i < n_data; i++) {
+                    memcpy(
+                        reinterpret_cast<char*>(words_mem_char.at(i)),
+                        received_bufs[i] + offset * coded_word_size,
+                        copy_bytes);
+                    timer.add_bytes(copy_bytes);
+                }
 
-        vec::pack<uint8_t, T>(
-            words_mem_char, words_mem_T, n_data, pkt_size, word_size);
+                // Zero-out trailing part of data
+                if (copy_size < pkt_size) {
+                    const size_t trailing_bytes = coded_buf_size - copy_bytes;
+                    for (unsigned i = 0; i < n_data; i++) {
+                        memset(
+                            reinterpret_cast<char*>(words_mem_char.at(i))
+                                + copy_bytes,
+                            0,
+                            trailing_bytes);
+                    }
+                }
+            }
+
+            StageTimer timer(stage_stats, Stage::PACK, n_data * coded_buf_size);
+            pack_prepare(
+                *context, parities_props, offset, words_mem_char, words);
+        }
 
         timeval t1 = tick();
         uint64_t start = hw_timer();
-        decode(*context, output, parities_props, offset, words);
+        {
+            StageTimer timer(stage_stats, Stage::FFT, n_data * buf_size);
+            decode_prepared(*context, output, words, inter_codeword);
+        }
         uint64_t end = hw_timer();
         uint64_t t2 = hrtime_usec(t1);
 
-        total_dec_usec += t2;
-        total_decode_cycles += (end - start) / word_size;
-        n_decode_ops++;
+        add_stats_dec((end - start) / word_size, t2, 1);
 
-        vec::unpack<T, uint8_t>(
-            output_mem_T, output_mem_char, output_len, pkt_size, word_size);
+        if (direct) {
+            for (unsigned i = 0; i < n_data; i++) {
+                data_mem[i] = wanted_idxs[i] ? data_bufs[i] + offset * word_size
+                                             : output_mem_char.at(i);
+            }
+            StageTimer timer(stage_stats, Stage::UNPACK, output_len * buf_size);
+            vec::unpack<T, uint8_t>(
+                output_mem_T, data_mem, output_len, pkt_size, word_size);
+        } else {
+            {
+                StageTimer timer(
+                    stage_stats, Stage::UNPACK, output_len * buf_size);
+                vec::unpack<T, uint8_t>(
+                    output_mem_T,
+                    output_mem_char,
+                    output_len,
+                    pkt_size,
+                    word_size);
+            }
 
-        for (unsigned i = 0; i < n_data; i++) {
-            if (wanted_idxs[i]) {
-                memcpy(
-                    data_bufs[i] + offset * word_size,
-                    reinterpret_cast<char*>(output_mem_char.at(i)),
-                    copy_size * word_size);
+            StageTimer timer(stage_stats, Stage::COPY);
+            for (unsigned i = 0; i < n_data; i++) {
+                if (wanted_idxs[i]) {
+                    memcpy(
+                        data_bufs[i] + offset * word_size,
+                        reinterpret_cast<char*>(output_mem_char.at(i)),
+                        copy_size * word_size);
+                    timer.add_bytes(copy_size * word_size);
+                }
             }
         }
         offset += pkt_size;
@@ -1333,15 +2420,191 @@ void FecCode<T>::decode(
     // prepare for decoding
     decode_prepare(context, props, offset, words);
 
+    decode_prepared(
+        context, output, words, get_dec_inter_codeword(default_workspace));
+}
+
+/**
+ * Decode words already prepared by `decode_prepare`
+ *
+ * @param context decoding context
+ * @param output must be exactly n_data
+ * @param words prepared received words, must be exactly n_data
+ */
+template <typename T>
+void FecCode<T>::decode_prepared(
+    const DecodeContext<T>& context,
+    vec::Buffers<T>& output,
+    vec::Buffers<T>& words,
+    vec::Buffers<T>* inter_codeword)
+{
     // Lagrange interpolation
     decode_apply(context, output, words);
 
     if (type == FecType::SYSTEMATIC) {
-        this->fft->fft(*dec_inter_codeword, output);
+        this->fft->fft(*inter_codeword, output);
         for (unsigned i = 0; i < this->n_data; i++) {
-            output.copy(i, dec_inter_codeword->get(i));
+            output.copy(i, inter_codeword->get(i));
+        }
+    }
+}
+
+template <typename T>
+void FecCode<T>::init_systematic()
+{
+    // for encoding
+    enc_frag_ids = std::make_unique<vec::Vector<T>>(*gf, n_data);
+    // ids of received fragments, from 0 to codelen-1
+    for (unsigned i = 0; i < n_data; i++) {
+        enc_frag_ids->set(i, i);
+    }
+}
+
+template <typename T>
+std::unique_ptr<EncodeWorkspace<T>> FecCode<T>::init_sys_encode_workspace()
+{
+    if (type != FecType::SYSTEMATIC) {
+        return nullptr;
+    }
+    auto workspace = std::make_unique<SysEncodeWorkspace<T>>();
+    workspace->inter_words =
+        std::make_unique<vec::Buffers<T>>(n_data, pkt_size);
+    workspace->suffix_words =
+        std::make_unique<vec::Buffers<T>>(n - n_data - n_outputs, pkt_size);
+    workspace->prefix_words =
+        std::make_unique<vec::Buffers<T>>(n_data, pkt_size);
+    workspace->context = init_context_dec(
+        *enc_frag_ids, pkt_size, workspace->inter_words.get());
+
+    return workspace;
+}
+
+/** Interpolate words of the first `n_data` fragments
+ *
+ * Same as `decode_apply` but received fragments are known to be contiguous,
+ * so that the inverse FFT works on the first `n_data` symbols only.
+ *
+ * @param context decoding context of fragments 0 .. n_data-1
+ * @param output must be exactly n_data, bound to `context`
+ * @param words must be exactly n_data
+ */
+template <typename T>
+void FecCode<T>::decode_data(
+    const DecodeContext<T>& context,
+    vec::Buffers<T>& output,
+    vec::Buffers<T>& words)
+{
+    vec::Vector<T>& inv_A_i = context.get_vector(CtxVec::INV_A_I);
+    vec::Vector<T>& A_fft_2k = context.get_vector(CtxVec::A_FFT_2K);
+
+    vec::Buffers<T>& buf1_k = context.get_buffer(CtxBuf::K1);
+    vec::Buffers<T>& buf2_n = context.get_buffer(CtxBuf::N2);
+    vec::Buffers<T>& buf1_2k = context.get_buffer(CtxBuf::B2K1);
+    vec::Buffers<T>& buf2_2k = context.get_buffer(CtxBuf::B2K2);
+
+    // compute N'(x) = sum_i{n_i * x^z_i}
+    // where n_i=v_i/A'_i(x_i)
+    this->gf->mul_vec_to_vecp(inv_A_i, words, buf1_k);
+
+    // compute buf2_n
+    // Input `buf1_k` contains first `k` received symbols from 0 .. k-1
+    this->fft->fft_inv(buf2_n, buf1_k);
+
+    this->fft_2k->fft(buf1_2k, output);
+
+    // multiply FFT(A) and buf2_2k
+    this->gf->mul_vec_to_vecp(A_fft_2k, buf1_2k, buf1_2k);
+
+    this->fft_2k->ifft(buf2_2k, buf1_2k);
+
+    // negatize output
+    this->gf->neg(output);
+}
+
+/** Encode a packet by evaluating words over the codeword with `fft`
+ *
+ * It implements `encode_packet` of FFT-based codes whose FFT supports
+ * buffers. Data words of systematic codes are first interpolated with the
+ * context of `init_sys_encode_workspace`.
+ */
+template <typename T>
+void FecCode<T>::encode_packet_fft(
+    EncodeWorkspace<T>* workspace,
+    vec::Buffers<T>& output,
+    std::vector<Properties>& props,
+    off_t offset,
+    vec::Buffers<T>& words,
+    const std::vector<bool>& wanted_idxs)
+{
+    const bool pruned =
+        std::find(wanted_idxs.begin(), wanted_idxs.end(), false)
+        != wanted_idxs.end();
+    // outputs of the FFT that are wanted
+    std::vector<bool> fft_wanted;
+    if (pruned) {
+        const unsigned first = (type == FecType::SYSTEMATIC) ? n_data : 0;
+        fft_wanted.resize(n, false);
+        for (unsigned i = 0; i < n_outputs; ++i) {
+            fft_wanted[first + i] = wanted_idxs[i];
+        }
+    }
+
+    {
+        StageTimer timer(stage_stats, Stage::FFT, n_data * buf_size);
+        if (type == FecType::SYSTEMATIC) {
+            SysEncodeWorkspace<T>* sys_workspace =
+                static_cast<SysEncodeWorkspace<T>*>(
+                    workspace != nullptr ? workspace
+                                         : get_default_encode_workspace());
+            vec::Buffers<T>& inter_words = *(sys_workspace->inter_words);
+
+            decode_data(*(sys_workspace->context), inter_words, words);
+            // `words` may wrap the caller blocks: the FFT writes the data
+            // symbols of the codeword to `prefix_words` instead
+            vec::Buffers<T> _tmp(*(sys_workspace->prefix_words), output);
+            vec::Buffers<T> _output(_tmp, *(sys_workspace->suffix_words));
+            if (pruned) {
+                this->fft->fft_pruned(_output, inter_words, fft_wanted);
+            } else {
+                this->fft->fft(_output, inter_words);
+            }
+        } else if (pruned) {
+            this->fft->fft_pruned(output, words, fft_wanted);
+        } else {
+            this->fft->fft(output, words);
+        }
+    }
+
+    StageTimer timer(stage_stats, Stage::POST_PROCESS, n_outputs * buf_size);
+    if (pruned) {
+        for (unsigned i = 0; i < n_outputs; ++i) {
+            if (!wanted_idxs[i]) {
+                std::fill_n(output.get(i), pkt_size, 0);
+            }
         }
     }
+    encode_post_process(output, props, offset);
+}
+
+/** Compute a column of the generator matrix by encoding buffers
+ *
+ * Used by codes of which only the encoding of buffers is systematic.
+ */
+template <typename T>
+void FecCode<T>::generator_column_buffers(
+    unsigned frag_idx,
+    vec::Vector<T>& column)
+{
+    vec::Buffers<T> words(n_data, pkt_size);
+    vec::Buffers<T> output(n_outputs, pkt_size);
+    std::vector<Properties> props(n_outputs);
+    words.zero_fill();
+    words.get(frag_idx)[0] = 1;
+
+    encode(output, props, 0, words);
+    for (unsigned i = 0; i < n_outputs; ++i) {
+        column.set(i, restore_symbol(output.get(i)[0], props[i].get(0)));
+    }
 }
 
 /* Prepare for decoding
@@ -1354,12 +2617,9 @@ void FecCode<T>::decode_prepare(
     off_t offset,
     vec::Buffers<T>& words)
 {
-    // FIXME: could we integrate this preparation into vec::pack?
-    // It will reduce a loop on all data
     const vec::Vector<T>& fragments_ids = context.get_fragments_id();
     off_t offset_max = offset + pkt_size;
 
-    T thres = (this->gf->card() - 1);
     for (unsigned i = 0; i < this->n_data; i++) {
         unsigned frag_id = fragments_ids.get(i);
         if (type == FecType::SYSTEMATIC && frag_id < this->n_data) {
@@ -1369,23 +2629,17 @@ void FecCode<T>::decode_prepare(
         if (type == FecType::SYSTEMATIC) {
             frag_id -= this->n_data;
         }
-        // loop over marked symbols
-        for (auto const& data : props[frag_id].get_map()) {
-            off_t loc_offset = data.first;
-            if (loc_offset >= offset && loc_offset < offset_max) {
-                // As loc.offset := offset + j
-                const size_t j = (loc_offset - offset);
-
-                // Check if the symbol is a special case whick is marked by
-                // `OOR_MARK`.
-                // Note: this check is necessary when word_size is not large
-                // enough to cover all symbols of the field. Following check is
-                // used for FFT over FNT where the single special case symbol
-                // equals card - 1
-                if (data.second == OOR_MARK) {
-                    chunk[j] = thres;
-                }
-            }
+        // loop over marked symbols of the packet
+        const auto marks = props[frag_id].get_range(offset, offset_max);
+        for (auto it = marks.first; it != marks.second; ++it) {
+            // As loc.offset := offset + j
+            const size_t j = (it->first - offset);
+
+            // Restore the symbol marked as out of range, i.e. not fitting
+            // in word_size, e.g. `card - 1` for FFT over FNT.
+            // Note: this step is necessary when word_size is not large
+            // enough to cover all symbols of the field.
+            chunk[j] = restore_symbol(chunk[j], it->second);
         }
     }
 }
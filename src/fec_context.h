@@ -34,7 +34,10 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <list>
+#include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 #include <sys/time.h>
 
@@ -85,7 +88,7 @@ class DecodeContext {
         this->len_2k = this->gf->get_code_len_high_compo(2 * this->k);
         this->max_n_2k = (this->n > this->len_2k) ? this->n : this->len_2k;
 
-        this->fragments_ids = &fragments_ids;
+        copy_fragments_ids(fragments_ids);
 
         A = std::make_unique<vec::Poly<T>>(gf, n);
         A_fft_2k = std::make_unique<vec::Vector<T>>(gf, len_2k);
@@ -132,7 +135,31 @@ class DecodeContext {
         init(vx);
     }
 
-    ~DecodeContext() = default;
+    /** Context of codes decoding with a matrix, e.g. RsGf2n
+     *
+     * Only the ids of received fragments are kept: such codes need neither
+     * FFT nor interpolation polynomials.
+     */
+    DecodeContext(
+        const gf::Field<T>& gf,
+        const vec::Vector<T>& fragments_ids,
+        const int k,
+        const int n)
+    {
+        this->k = k;
+        this->n = n;
+        this->len_2k = 0;
+        this->max_n_2k = 0;
+        this->size = 0;
+        this->gf = &gf;
+        this->fft = nullptr;
+        this->fft_2k = nullptr;
+        this->vx_zero = -1;
+
+        copy_fragments_ids(fragments_ids);
+    }
+
+    virtual ~DecodeContext() = default;
 
     unsigned get_len_2k() const
     {
@@ -220,6 +247,16 @@ class DecodeContext {
     }
 
   private:
+    void copy_fragments_ids(const vec::Vector<T>& fragments_ids)
+    {
+        // own the ids as the context can outlive them, e.g. when it's cached
+        const int n_ids = fragments_ids.get_n();
+        this->fragments_ids = std::make_unique<vec::Vector<T>>(*gf, n_ids);
+        for (int i = 0; i < n_ids; ++i) {
+            this->fragments_ids->set(i, fragments_ids.get(i));
+        }
+    }
+
     void init(const vec::Vector<T>& vx)
     {
         // compute A(x) = prod_j(x-x_j)
@@ -277,7 +314,7 @@ class DecodeContext {
     fft::FourierTransform<T>* fft;
     fft::FourierTransform<T>* fft_2k;
 
-    const vec::Vector<T>* fragments_ids;
+    std::unique_ptr<vec::Vector<T>> fragments_ids = nullptr;
 
     std::unique_ptr<vec::Poly<T>> A = nullptr;
     std::unique_ptr<vec::Vector<T>> A_fft_2k = nullptr;
@@ -308,6 +345,116 @@ class DecodeContext {
     std::unique_ptr<vec::Buffers<T>> buf2_2k = nullptr;
 };
 
+/** A decoding context along with the buffers it writes decoded symbols to */
+template <typename T>
+struct CachedDecodeContext {
+    // Output buffers bound to `context`, nullptr for decoding of vectors
+    std::unique_ptr<vec::Buffers<T>> output = nullptr;
+    std::unique_ptr<DecodeContext<T>> context = nullptr;
+};
+
+/** A bounded cache of decoding contexts
+ *
+ * Contexts are keyed by the ids of received fragments and the size of the
+ * decoded buffers. When the cache is full, the least recently used context is
+ * evicted.
+ */
+template <typename T>
+class DecodeContextCache {
+  public:
+    explicit DecodeContextCache(size_t capacity = 16)
+    {
+        set_capacity(capacity);
+    }
+
+    /** Set the maximal number of contexts, at least one */
+    void set_capacity(size_t capacity)
+    {
+        this->capacity = std::max<size_t>(1, capacity);
+        evict();
+    }
+
+    size_t get_capacity() const
+    {
+        return capacity;
+    }
+
+    size_t get_size() const
+    {
+        return entries.size();
+    }
+
+    void clear()
+    {
+        index.clear();
+        entries.clear();
+    }
+
+    /** Find the context of given fragments
+     *
+     * @return nullptr if the context isn't cached
+     */
+    CachedDecodeContext<T>*
+    get(const vec::Vector<T>& fragments_ids, size_t size)
+    {
+        auto it = index.find(make_key(fragments_ids, size));
+        if (it == index.end()) {
+            return nullptr;
+        }
+        // mark the entry as the most recently used
+        entries.splice(entries.begin(), entries, it->second);
+        return &(it->second->second);
+    }
+
+    /** Insert the context of given fragments
+     *
+     * @return the cached context, valid until it gets evicted
+     */
+    CachedDecodeContext<T>& put(
+        const vec::Vector<T>& fragments_ids,
+        size_t size,
+        CachedDecodeContext<T> entry)
+    {
+        Key key = make_key(fragments_ids, size);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            entries.erase(it->second);
+            index.erase(it);
+        }
+        entries.emplace_front(key, std::move(entry));
+        index.emplace(std::move(key), entries.begin());
+        evict();
+        return entries.front().second;
+    }
+
+  private:
+    using Key = std::pair<size_t, std::vector<T>>;
+    using Entries = std::list<std::pair<Key, CachedDecodeContext<T>>>;
+
+    size_t capacity;
+    // entries from the most to the least recently used
+    Entries entries;
+    std::map<Key, typename Entries::iterator> index;
+
+    static Key make_key(const vec::Vector<T>& fragments_ids, size_t size)
+    {
+        const int n = fragments_ids.get_n();
+        std::vector<T> ids(n);
+        for (int i = 0; i < n; ++i) {
+            ids[i] = fragments_ids.get(i);
+        }
+        return Key(size, std::move(ids));
+    }
+
+    void evict()
+    {
+        while (entries.size() > capacity) {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+};
+
 } // namespace fec
 } // namespace quadiron
 
@@ -0,0 +1,212 @@
+/* -*- mode: c++ -*- */
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __QUAD_FEC_PLAN_H__
+#define __QUAD_FEC_PLAN_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include "fft_2n.h"
+#include "fft_base.h"
+#include "gf_base.h"
+#include "gf_goldilocks.h"
+#include "gf_nf4.h"
+#include "gf_prime.h"
+#include "vec_vector.h"
+
+namespace quadiron {
+namespace fec {
+
+/** Kinds of objects shared between codes */
+enum class PlanKind {
+    /** Prime field, keyed by its characteristic */
+    GF_PRIME = 0,
+    /** NF4 field, keyed by its number of sub-fields */
+    GF_NF4,
+    /** Goldilocks field, which has no parameter */
+    GF_GOLDILOCKS,
+    /** fft::Radix2 transform, keyed by its length and data length */
+    FFT_RADIX2,
+    /** Vector of powers of a root, keyed by the root and the vector length */
+    POWERS,
+};
+
+/** A process-wide registry of the immutable objects codes are built on
+ *
+ * Codes sharing the same parameters need the same field, FFTs and powers of
+ * their root, which are expensive to compute and to keep in memory. The
+ * registry hands out shared instances of them, built on first request.
+ *
+ * Only weak references are kept, so that an object is released with the last
+ * code using it. Objects bound to a field (FFTs, powers) are keyed by the
+ * field instance, which the caller must keep alive as long as them.
+ *
+ * Shared objects must not be modified, and their operations must not use any
+ * member scratch (e.g. fft::CooleyTukey does), so that codes can use them
+ * concurrently.
+ */
+template <typename T>
+class PlanRegistry {
+  public:
+    // fields and roots are keyed by their value, on as many bits as they use
+    using Key = std::tuple<PlanKind, const void*, T, uint64_t>;
+
+    static PlanRegistry<T>& get_instance()
+    {
+        static PlanRegistry<T> registry;
+        return registry;
+    }
+
+    /** Get the object of a given key, built by `create` if there is none
+     *
+     * @param key key of the object, whose kind determines `Object`
+     * @param create callable returning a `std::unique_ptr<Object>`
+     * @return the shared object
+     */
+    template <typename Object, typename Create>
+    std::shared_ptr<Object> get(const Key& key, Create create)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = plans.find(key);
+        if (it != plans.end()) {
+            std::shared_ptr<void> plan = it->second.lock();
+            if (plan != nullptr) {
+                return std::static_pointer_cast<Object>(plan);
+            }
+        }
+
+        std::shared_ptr<Object> plan = create();
+        purge();
+        plans[key] = plan;
+        return plan;
+    }
+
+    /** Number of objects currently alive */
+    size_t get_size()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        purge();
+        return plans.size();
+    }
+
+  private:
+    PlanRegistry() = default;
+
+    /// Forget objects released by all their users
+    void purge()
+    {
+        for (auto it = plans.begin(); it != plans.end();) {
+            if (it->second.expired()) {
+                it = plans.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    std::mutex mutex;
+    std::map<Key, std::weak_ptr<void>> plans;
+};
+
+/** Shared prime field of characteristic `p` */
+template <typename T>
+std::shared_ptr<gf::Field<T>> get_prime_field(T p)
+{
+    auto& registry = PlanRegistry<T>::get_instance();
+    return registry.template get<gf::Field<T>>(
+        std::make_tuple(PlanKind::GF_PRIME, nullptr, p, 0),
+        [p]() { return gf::alloc<gf::Field<T>, gf::Prime<T>>(p); });
+}
+
+/** Shared NF4 field made of `n` sub-fields */
+template <typename T>
+std::shared_ptr<gf::Field<T>> get_nf4_field(unsigned n)
+{
+    auto& registry = PlanRegistry<T>::get_instance();
+    return registry.template get<gf::Field<T>>(
+        std::make_tuple(PlanKind::GF_NF4, nullptr, n, 0),
+        [n]() { return gf::alloc<gf::Field<T>, gf::NF4<T>>(n); });
+}
+
+/** Shared field GF(2<sup>64</sup> - 2<sup>32</sup> + 1) */
+inline std::shared_ptr<gf::Field<uint64_t>> get_goldilocks_field()
+{
+    auto& registry = PlanRegistry<uint64_t>::get_instance();
+    return registry.template get<gf::Field<uint64_t>>(
+        std::make_tuple(PlanKind::GF_GOLDILOCKS, nullptr, 0, 0), []() {
+            return gf::alloc<gf::Field<uint64_t>, gf::Goldilocks>();
+        });
+}
+
+/** Shared fft::Radix2 transform over `gf`
+ *
+ * It transforms buffers whatever their size, hence codes of any packet size
+ * share it.
+ *
+ * @see fft::Radix2::Radix2
+ */
+template <typename T>
+std::shared_ptr<fft::FourierTransform<T>>
+get_radix2_fft(const gf::Field<T>& gf, int n, int data_len)
+{
+    auto& registry = PlanRegistry<T>::get_instance();
+    return registry.template get<fft::FourierTransform<T>>(
+        std::make_tuple(PlanKind::FFT_RADIX2, &gf, n, data_len),
+        [&gf, n, data_len]() {
+            return std::make_unique<fft::Radix2<T>>(gf, n, data_len);
+        });
+}
+
+/** Shared vector of the `len` first powers of `r` in `gf` */
+template <typename T>
+std::shared_ptr<vec::Vector<T>>
+get_powers(const gf::Field<T>& gf, T r, unsigned len)
+{
+    auto& registry = PlanRegistry<T>::get_instance();
+    return registry.template get<vec::Vector<T>>(
+        std::make_tuple(PlanKind::POWERS, &gf, r, len), [&gf, r, len]() {
+            auto powers = std::make_unique<vec::Vector<T>>(gf, len);
+            for (unsigned i = 0; i < len; i++) {
+                powers->set(i, gf.exp(r, i));
+            }
+            return powers;
+        });
+}
+
+} // namespace fec
+} // namespace quadiron
+
+#endif
@@ -33,6 +33,7 @@
 
 #include "arith.h"
 #include "fec_base.h"
+#include "fec_plan.h"
 #include "fft_2n.h"
 #include "gf_prime.h"
 #include "vec_buffers.h"
@@ -51,15 +52,6 @@ namespace fec {
 template <typename T>
 class RsFnt : public FecCode<T> {
   private:
-    // buffers for intermediate symbols used for systematic FNT
-    std::unique_ptr<vec::Buffers<T>> inter_words;
-    // buffers for suffix symbols of codewords used for systematic FNT
-    std::unique_ptr<vec::Buffers<T>> suffix_words;
-    // received fragments id for encoding of systematic FNT
-    std::unique_ptr<vec::Vector<T>> enc_frag_ids;
-    // decoding context used in encoding of systematic FNT
-    std::unique_ptr<DecodeContext<T>> enc_context;
-
     // Indices used for accelerated functions
     size_t simd_vec_len;
     size_t simd_trailing_len;
@@ -92,7 +84,7 @@ class RsFnt : public FecCode<T> {
     {
         // warning all fermat numbers >= to F_5 (2^32+1) are composite!!!
         T gf_p = (1ULL << (8 * this->word_size)) + 1;
-        this->gf = gf::alloc<gf::Field<T>, gf::Prime<T>>(gf_p);
+        this->gf = get_prime_field<T>(gf_p);
 
         assert(
             arith::jacobi<T>(this->gf->get_primitive_root(), this->gf->card())
@@ -111,12 +103,10 @@ class RsFnt : public FecCode<T> {
         this->r = this->gf->get_nth_root(this->n);
 
         int m = arith::ceil2<int>(this->n_data);
-        this->fft = std::make_unique<fft::Radix2<T>>(
-            *(this->gf), this->n, m, this->pkt_size);
+        this->fft = get_radix2_fft<T>(*(this->gf), this->n, m);
 
         unsigned len_2k = this->gf->get_code_len_high_compo(2 * this->n_data);
-        this->fft_2k = std::make_unique<fft::Radix2<T>>(
-            *(this->gf), len_2k, len_2k, this->pkt_size);
+        this->fft_2k = get_radix2_fft<T>(*(this->gf), len_2k, len_2k);
     }
 
     inline void init_others() override
@@ -124,36 +114,13 @@ class RsFnt : public FecCode<T> {
         // vector stores r^{-i} for i = 0, ... , k
         T inv_r = this->gf->inv(this->r);
         this->inv_r_powers =
-            std::make_unique<vec::Vector<T>>(*(this->gf), this->n_data + 1);
-        for (unsigned i = 0; i <= this->n_data; i++)
-            this->inv_r_powers->set(i, this->gf->exp(inv_r, i));
+            get_powers<T>(*(this->gf), inv_r, this->n_data + 1);
 
         // vector stores r^{i} for i = 0, ... , n-1
-        this->r_powers = std::make_unique<vec::Vector<T>>(*(this->gf), this->n);
-        for (unsigned i = 0; i < this->n; i++) {
-            this->r_powers->set(i, this->gf->exp(this->r, i));
-        }
+        this->r_powers = get_powers<T>(*(this->gf), this->r, this->n);
 
         if (this->type == FecType::SYSTEMATIC) {
-            // for encoding
-            enc_frag_ids =
-                std::make_unique<vec::Vector<T>>(*(this->gf), this->n_data);
-            // ids of received fragments, from 0 to codelen-1
-            for (unsigned i = 0; i < this->n_data; i++) {
-                enc_frag_ids->set(i, i);
-            }
-
-            inter_words =
-                std::make_unique<vec::Buffers<T>>(this->n_data, this->pkt_size);
-            suffix_words = std::make_unique<vec::Buffers<T>>(
-                this->n - this->n_data - this->n_outputs, this->pkt_size);
-
-            enc_context = this->init_context_dec(
-                *enc_frag_ids, this->pkt_size, inter_words.get());
-
-            // for decoding
-            this->dec_inter_codeword =
-                std::make_unique<vec::Buffers<T>>(this->n, this->pkt_size);
+            this->init_systematic();
         }
     }
 
@@ -196,53 +163,13 @@ class RsFnt : public FecCode<T> {
         }
     }
 
-    void decode_data(
-        const DecodeContext<T>& context,
-        vec::Buffers<T>& output,
-        vec::Buffers<T>& words)
-    {
-        vec::Vector<T>& inv_A_i = context.get_vector(CtxVec::INV_A_I);
-        vec::Vector<T>& A_fft_2k = context.get_vector(CtxVec::A_FFT_2K);
-
-        vec::Buffers<T>& buf1_k = context.get_buffer(CtxBuf::K1);
-        vec::Buffers<T>& buf2_n = context.get_buffer(CtxBuf::N2);
-        vec::Buffers<T>& buf1_2k = context.get_buffer(CtxBuf::B2K1);
-        vec::Buffers<T>& buf2_2k = context.get_buffer(CtxBuf::B2K2);
-
-        // compute N'(x) = sum_i{n_i * x^z_i}
-        // where n_i=v_i/A'_i(x_i)
-        this->gf->mul_vec_to_vecp(inv_A_i, words, buf1_k);
-
-        // compute buf2_n
-        // Input `buf1_k` contains first `k` received symbols from 0 .. k-1
-        this->fft->fft_inv(buf2_n, buf1_k);
-
-        this->fft_2k->fft(buf1_2k, output);
-
-        // multiply FFT(A) and buf2_2k
-        this->gf->mul_vec_to_vecp(A_fft_2k, buf1_2k, buf1_2k);
-
-        this->fft_2k->ifft(buf2_2k, buf1_2k);
-
-        // negatize output
-        this->gf->neg(output);
-    }
-
     void encode(
         vec::Buffers<T>& output,
         std::vector<Properties>& props,
         off_t offset,
         vec::Buffers<T>& words) override
     {
-        if (this->type == FecType::SYSTEMATIC) {
-            decode_data(*enc_context, *inter_words, words);
-            vec::Buffers<T> _tmp(words, output);
-            vec::Buffers<T> _output(_tmp, *suffix_words);
-            this->fft->fft(_output, *inter_words);
-        } else {
-            this->fft->fft(output, words);
-        }
-        encode_post_process(output, props, offset);
+        encode_packet(nullptr, output, props, offset, words, {});
     }
 
     void encode_post_process(
@@ -262,6 +189,82 @@ class RsFnt : public FecCode<T> {
             }
         }
     }
+
+  protected:
+    T restore_symbol(T value, uint32_t prop) override
+    {
+        // `card() - 1` is the only out-of-range value
+        return prop == OOR_MARK ? this->gf->card() - 1 : value;
+    }
+
+    void generator_column(unsigned frag_idx, vec::Vector<T>& column) override
+    {
+        if (this->type != FecType::SYSTEMATIC) {
+            FecCode<T>::generator_column(frag_idx, column);
+            return;
+        }
+        // only the encoding of buffers is systematic
+        this->generator_column_buffers(frag_idx, column);
+    }
+
+    /** Pack received packets and restore their out-of-range symbols in a
+     * single pass
+     */
+    void pack_prepare(
+        const DecodeContext<T>& context,
+        const std::vector<Properties>& props,
+        off_t offset,
+        const std::vector<uint8_t*>& src,
+        vec::Buffers<T>& words) override
+    {
+        const vec::Vector<T>& fragments_ids = context.get_fragments_id();
+        const off_t offset_max = offset + this->pkt_size;
+
+        // marks of the packet for each received fragment, none for data
+        // fragments of systematic codes
+        std::vector<std::pair<
+            Properties::const_iterator,
+            Properties::const_iterator>>
+            marks(this->n_data);
+        for (unsigned i = 0; i < this->n_data; ++i) {
+            unsigned frag_id = fragments_ids.get(i);
+            if (this->type == FecType::SYSTEMATIC) {
+                if (frag_id < this->n_data) {
+                    continue;
+                }
+                frag_id -= this->n_data;
+            }
+            marks[i] = props[frag_id].get_range(offset, offset_max);
+        }
+
+        // `card - 1` is the only out-of-range value
+        vec::pack_marked<uint8_t, T>(
+            src,
+            words.get_mem(),
+            this->n_data,
+            this->pkt_size,
+            this->coded_word_size,
+            marks,
+            offset,
+            this->gf->card() - 1);
+    }
+
+    std::unique_ptr<EncodeWorkspace<T>> init_encode_workspace() override
+    {
+        return this->init_sys_encode_workspace();
+    }
+
+    void encode_packet(
+        EncodeWorkspace<T>* workspace,
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset,
+        vec::Buffers<T>& words,
+        const std::vector<bool>& wanted_idxs) override
+    {
+        this->encode_packet_fft(
+            workspace, output, props, offset, words, wanted_idxs);
+    }
 };
 
 #ifdef QUADIRON_USE_SIMD
@@ -31,6 +31,10 @@
 #ifndef __QUAD_FEC_RS_GF2N_H__
 #define __QUAD_FEC_RS_GF2N_H__
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "fec_base.h"
 #include "gf_bin_ext.h"
 #include "vec_matrix.h"
@@ -39,7 +43,65 @@
 namespace quadiron {
 namespace fec {
 
-enum class RsMatrixType { VANDERMONDE, CAUCHY };
+/** Generator matrix of RsGf2n.
+ *
+ * `CAUCHY_BITMATRIX` uses the Cauchy matrix expanded into its binary form:
+ * each packet is split into `n` sub-packets (one per bit of GF(2<sup>n</sup>)
+ * symbols) and coding only XORs sub-packets. Packets are thus laid out
+ * differently than with `CAUCHY`, only symbol-wise (Vector) coding is the
+ * same.
+ */
+enum class RsMatrixType { VANDERMONDE, CAUCHY, CAUCHY_BITMATRIX };
+
+/** One step of a bit-matrix schedule: sub-packet `dest_sub` of output `dest`
+ *  is set to (`copy`) or XORed with sub-packet `src_sub` of `src`.
+ *
+ * Sources below the number of inputs are input packets, the next ones are
+ * output packets already computed by previous steps.
+ */
+struct XorOp {
+    unsigned src;
+    unsigned src_sub;
+    unsigned dest;
+    unsigned dest_sub;
+    bool copy;
+};
+
+/** Decoding context of RsGf2n
+ *
+ * Along with the ids of received fragments, it holds the matrix (and for
+ * `CAUCHY_BITMATRIX` the XOR schedule) yielding data from them, so that the
+ * matrix is built once per erasure pattern and cached with the context.
+ */
+template <typename T>
+class MatrixDecodeContext : public DecodeContext<T> {
+  public:
+    MatrixDecodeContext(
+        const gf::Field<T>& gf,
+        const vec::Vector<T>& fragments_ids,
+        const int k,
+        const int n,
+        std::unique_ptr<vec::Matrix<T>> mat,
+        std::vector<XorOp> schedule)
+        : DecodeContext<T>(gf, fragments_ids, k, n), mat(std::move(mat)),
+          schedule(std::move(schedule))
+    {
+    }
+
+    vec::Matrix<T>& get_matrix() const
+    {
+        return *mat;
+    }
+
+    const std::vector<XorOp>& get_schedule() const
+    {
+        return schedule;
+    }
+
+  private:
+    std::unique_ptr<vec::Matrix<T>> mat;
+    std::vector<XorOp> schedule;
+};
 
 /** Reed-Solomon (RS) Erasure code over GF(2<sup>n</sup>) (Cauchy or
  *  Vandermonde).
@@ -48,6 +110,8 @@ template <typename T>
 class RsGf2n : public FecCode<T> {
   public:
     using FecCode<T>::decode;
+    using FecCode<T>::decode_apply;
+    using FecCode<T>::decode_prepare;
     using FecCode<T>::encode;
 
     RsMatrixType mat_type;
@@ -56,8 +120,14 @@ class RsGf2n : public FecCode<T> {
         unsigned word_size,
         unsigned n_data,
         unsigned n_parities,
-        RsMatrixType type)
-        : FecCode<T>(FecType::SYSTEMATIC, word_size, n_data, n_parities)
+        RsMatrixType type,
+        size_t pkt_size = 8)
+        : FecCode<T>(
+              FecType::SYSTEMATIC,
+              word_size,
+              n_data,
+              n_parities,
+              pkt_size)
     {
         mat_type = type;
         this->fec_init();
@@ -67,10 +137,18 @@ class RsGf2n : public FecCode<T> {
     {
         assert(
             mat_type == RsMatrixType::VANDERMONDE
-            || mat_type == RsMatrixType::CAUCHY);
+            || mat_type == RsMatrixType::CAUCHY
+            || mat_type == RsMatrixType::CAUCHY_BITMATRIX);
 
         if (this->word_size > 16)
             assert(false); // not support yet
+
+        if (mat_type == RsMatrixType::CAUCHY_BITMATRIX
+            && this->pkt_size % (8 * this->word_size) != 0) {
+            throw InvalidArgument(
+                "RS GF2N: packet size must be a multiple of the number of "
+                "bits per symbol");
+        }
     }
 
     inline void init_gf() override
@@ -83,17 +161,20 @@ class RsGf2n : public FecCode<T> {
 
     inline void init_others() override
     {
+        // codewords are made of data and parities, there is no FFT
+        this->n = this->code_len;
+
         this->mat = std::unique_ptr<vec::Matrix<T>>(
             new vec::Matrix<T>(*(this->gf), this->n_parities, this->n_data));
-        if (mat_type == RsMatrixType::CAUCHY) {
-            mat->cauchy();
-        } else if (mat_type == RsMatrixType::VANDERMONDE) {
+        if (mat_type == RsMatrixType::VANDERMONDE) {
             mat->vandermonde_suitable_for_ec();
+        } else {
+            mat->cauchy();
+        }
+        if (mat_type == RsMatrixType::CAUCHY_BITMATRIX) {
+            this->whole_packets = true;
+            encode_schedule = make_schedule(to_bitmatrix(*mat), this->n_data);
         }
-
-        // has to be a n_data*n_data invertible square matrix
-        decode_mat = std::unique_ptr<vec::Matrix<T>>(new vec::Matrix<T>(
-            *(this->gf), mat->get_n_cols(), mat->get_n_cols()));
     }
 
     int get_n_outputs() override
@@ -110,50 +191,392 @@ class RsGf2n : public FecCode<T> {
         mat->mul(&output, &words);
     }
 
-    void decode_add_data(int fragment_index, int row) override
+    /** Encode buffers
+     *
+     * @param output must be n_parities
+     * @param words must be n_data
+     */
+    void encode(
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset,
+        vec::Buffers<T>& words) override
     {
-        // for each data available generate the corresponding identity
-        for (int j = 0; j < mat->get_n_cols(); j++) {
-            if (row == j)
-                decode_mat->set(fragment_index, j, 1);
-            else
-                decode_mat->set(fragment_index, j, 0);
-        }
+        encode_packet(nullptr, output, props, offset, words, {});
     }
 
-    void decode_add_parities(int fragment_index, int row) override
+    void decode(
+        const DecodeContext<T>& context,
+        vec::Vector<T>& output,
+        const std::vector<Properties>&,
+        off_t,
+        vec::Vector<T>& words) override
+    {
+        static_cast<const MatrixDecodeContext<T>&>(context).get_matrix().mul(
+            &output, &words);
+    }
+
+    /** Build the matrix yielding data from the received fragments
+     *
+     * With a Cauchy generator matrix, only the erased data are computed from
+     * a closed-form inverse. Otherwise the received rows of the generator
+     * matrix are inverted by Gauss-Jordan elimination.
+     */
+    std::unique_ptr<DecodeContext<T>> init_context_dec(
+        vec::Vector<T>& fragments_ids,
+        size_t,
+        vec::Buffers<T>*) override
     {
-        // copy corresponding row in vandermonde matrix
-        for (int j = 0; j < mat->get_n_cols(); j++) {
-            decode_mat->set(fragment_index, j, mat->get(row, j));
+        std::unique_ptr<vec::Matrix<T>> decode_mat =
+            mat_type == RsMatrixType::VANDERMONDE
+                ? invert_received_rows(fragments_ids)
+                : invert_cauchy(fragments_ids);
+        std::vector<XorOp> schedule;
+        if (mat_type == RsMatrixType::CAUCHY_BITMATRIX) {
+            schedule = make_schedule(to_bitmatrix(*decode_mat), this->n_data);
         }
+        return std::make_unique<MatrixDecodeContext<T>>(
+            *(this->gf),
+            fragments_ids,
+            this->n_data,
+            this->n,
+            std::move(decode_mat),
+            std::move(schedule));
     }
 
-    void decode_build() override
+  protected:
+    /** Compute each parity packet as a linear combination of data packets */
+    void encode_packet(
+        EncodeWorkspace<T>*,
+        vec::Buffers<T>& output,
+        std::vector<Properties>&,
+        off_t,
+        vec::Buffers<T>& words,
+        const std::vector<bool>& wanted_idxs) override
     {
-        decode_mat->inv();
+        StageTimer timer(
+            this->stage_stats, Stage::FFT, this->n_data * this->buf_size);
+        if (mat_type == RsMatrixType::CAUCHY_BITMATRIX) {
+            // the schedule reuses parities: not wanted ones are computed in
+            // their scratch packets too
+            run_schedule(encode_schedule, output, words);
+        } else {
+            mat->mul(&output, &words, wanted_idxs);
+        }
     }
 
-    void decode(
+    void decode_prepare(
         const DecodeContext<T>&,
-        vec::Vector<T>& output,
         const std::vector<Properties>&,
         off_t,
-        vec::Vector<T>& words) override
+        vec::Buffers<T>&) override
+    {
+        // nothing to do: words cover all symbols of the field
+    }
+
+    void decode_apply(
+        const DecodeContext<T>& context,
+        vec::Buffers<T>& output,
+        vec::Buffers<T>& words) override
     {
-        decode_mat->mul(&output, &words);
+        const auto& mat_context =
+            static_cast<const MatrixDecodeContext<T>&>(context);
+        if (mat_type == RsMatrixType::CAUCHY_BITMATRIX) {
+            run_schedule(mat_context.get_schedule(), output, words);
+        } else {
+            mat_context.get_matrix().mul(&output, &words);
+        }
     }
 
-    std::unique_ptr<DecodeContext<T>>
-    init_context_dec(vec::Vector<T>&, size_t, vec::Buffers<T>*) override
+    void decode_prepared(
+        const DecodeContext<T>& context,
+        vec::Buffers<T>& output,
+        vec::Buffers<T>& words,
+        vec::Buffers<T>*) override
     {
-        std::unique_ptr<DecodeContext<T>> context;
-        return context;
+        // the decoding matrix directly yields the data
+        decode_apply(context, output, words);
     }
 
   private:
     std::unique_ptr<vec::Matrix<T>> mat = nullptr;
-    std::unique_ptr<vec::Matrix<T>> decode_mat = nullptr;
+    std::vector<XorOp> encode_schedule;
+
+    /** Invert the rows of the systematic generator matrix of received
+     *  fragments
+     */
+    std::unique_ptr<vec::Matrix<T>>
+    invert_received_rows(const vec::Vector<T>& fragments_ids)
+    {
+        const int k = this->n_data;
+        auto decode_mat = std::make_unique<vec::Matrix<T>>(*(this->gf), k, k);
+
+        for (int i = 0; i < k; ++i) {
+            const int id = fragments_ids.get(i);
+            for (int j = 0; j < k; ++j) {
+                if (id < k) {
+                    // identity row of a data fragment
+                    decode_mat->set(i, j, id == j ? 1 : 0);
+                } else {
+                    decode_mat->set(i, j, mat->get(id - k, j));
+                }
+            }
+        }
+        decode_mat->inv();
+        return decode_mat;
+    }
+
+    /** Compute the decoding matrix from the closed-form inverse of a Cauchy
+     *  matrix
+     *
+     * `mat` is the Cauchy matrix `1 / (x_i + y_j)`, with `x_i = i` and
+     * `y_j = n_parities + j`, whose rows and columns are scaled:
+     * `mat(i, j) = a_i * b_j / (x_i + y_j)`. With `e` erased data, the `e x e`
+     * sub-matrix of received parity rows and erased data columns is inverted
+     * in O(e<sup>2</sup>) by:
+     *
+     *     C^-1(j, r) = X(r) * Y(j) / ((x_r + y_j) * X'(r) * Y'(j))
+     *
+     * where `X(r)` (resp. `Y(j)`) is the product of `x_r + y_l` (resp.
+     * `x_l + y_j`) for all `l` and `X'(r)` (resp. `Y'(j)`) the one of
+     * `x_r + x_l` (resp. `y_j + y_l`) for all `l != r` (resp. `l != j`).
+     * Erased data are then the product of this inverse by the received
+     * parities minus the contribution of received data.
+     */
+    std::unique_ptr<vec::Matrix<T>>
+    invert_cauchy(const vec::Vector<T>& fragments_ids)
+    {
+        const gf::Field<T>& gf = *(this->gf);
+        const int k = this->n_data;
+        auto decode_mat = std::make_unique<vec::Matrix<T>>(gf, k, k);
+        decode_mat->zero_fill();
+
+        // positions of received data and parities among fragments
+        std::vector<int> data_pos(k, -1);
+        std::vector<int> parity_rows;
+        std::vector<int> parity_pos;
+        for (int i = 0; i < k; ++i) {
+            const int id = fragments_ids.get(i);
+            if (id < k) {
+                data_pos[id] = i;
+                decode_mat->set(id, i, 1);
+            } else {
+                parity_rows.push_back(id - k);
+                parity_pos.push_back(i);
+            }
+        }
+        std::vector<int> erased;
+        for (int j = 0; j < k; ++j) {
+            if (data_pos[j] < 0) {
+                erased.push_back(j);
+            }
+        }
+        const size_t e = erased.size();
+        assert(parity_rows.size() == e);
+        if (e == 0) {
+            return decode_mat;
+        }
+
+        const T n_rows = this->n_parities;
+        const auto x = [](int i) { return static_cast<T>(i); };
+        const auto y = [n_rows](int j) { return n_rows + static_cast<T>(j); };
+
+        // scaling factors of rows and columns, taking a_0 = 1
+        const T b_0 = gf.mul(mat->get(0, 0), gf.add(x(0), y(0)));
+        std::vector<T> inv_a(e);
+        std::vector<T> inv_b(e);
+        for (size_t r = 0; r < e; ++r) {
+            const int i = parity_rows[r];
+            const T a = gf.div(gf.mul(mat->get(i, 0), gf.add(x(i), y(0))), b_0);
+            inv_a[r] = gf.inv(a);
+        }
+        for (size_t c = 0; c < e; ++c) {
+            const int j = erased[c];
+            inv_b[c] = gf.inv(gf.mul(mat->get(0, j), gf.add(x(0), y(j))));
+        }
+
+        // products of the closed-form inverse
+        std::vector<T> num_x(e, 1);
+        std::vector<T> num_y(e, 1);
+        std::vector<T> den_x(e, 1);
+        std::vector<T> den_y(e, 1);
+        for (size_t r = 0; r < e; ++r) {
+            const T x_r = x(parity_rows[r]);
+            const T y_r = y(erased[r]);
+            for (size_t l = 0; l < e; ++l) {
+                const T x_l = x(parity_rows[l]);
+                const T y_l = y(erased[l]);
+                num_x[r] = gf.mul(num_x[r], gf.add(x_r, y_l));
+                num_y[r] = gf.mul(num_y[r], gf.add(x_l, y_r));
+                if (l != r) {
+                    den_x[r] = gf.mul(den_x[r], gf.add(x_r, x_l));
+                    den_y[r] = gf.mul(den_y[r], gf.add(y_r, y_l));
+                }
+            }
+        }
+
+        // inverse of the scaled sub-matrix, i.e. coefficients of parities
+        vec::Matrix<T> inv(gf, e, e);
+        for (size_t c = 0; c < e; ++c) {
+            const T y_c = y(erased[c]);
+            for (size_t r = 0; r < e; ++r) {
+                const T den = gf.mul(
+                    gf.mul(gf.add(x(parity_rows[r]), y_c), den_x[r]),
+                    den_y[c]);
+                T val = gf.div(gf.mul(num_x[r], num_y[c]), den);
+                val = gf.mul(gf.mul(val, inv_b[c]), inv_a[r]);
+                inv.set(c, r, val);
+                decode_mat->set(erased[c], parity_pos[r], val);
+            }
+        }
+
+        // subtract the contribution of received data to received parities
+        for (int j = 0; j < k; ++j) {
+            if (data_pos[j] < 0) {
+                continue;
+            }
+            for (size_t c = 0; c < e; ++c) {
+                T val = 0;
+                for (size_t r = 0; r < e; ++r) {
+                    const T coef = mat->get(parity_rows[r], j);
+                    val = gf.add(val, gf.mul(inv.get(c, r), coef));
+                }
+                decode_mat->set(erased[c], data_pos[j], val);
+            }
+        }
+        return decode_mat;
+    }
+
+    /** Expand a matrix over GF(2<sup>n</sup>) into its binary form
+     *
+     * Each entry `e` becomes a `n x n` block whose column `c` holds the bits
+     * of `e * 2^c`: bit `r` of `e * x` is then the XOR of the bits `c` of `x`
+     * selected by row `r` of the block.
+     *
+     * @return one vector of `n * cols` bits per row of bits
+     */
+    std::vector<std::vector<bool>> to_bitmatrix(vec::Matrix<T>& m) const
+    {
+        const unsigned w = 8 * this->word_size;
+        const int n_rows = m.get_n_rows();
+        const int n_cols = m.get_n_cols();
+        std::vector<std::vector<bool>> bits(
+            n_rows * w, std::vector<bool>(n_cols * w, false));
+
+        for (int i = 0; i < n_rows; ++i) {
+            for (int j = 0; j < n_cols; ++j) {
+                const T e = m.get(i, j);
+                for (unsigned c = 0; c < w; ++c) {
+                    const T col = this->gf->mul(e, static_cast<T>(1) << c);
+                    for (unsigned r = 0; r < w; ++r) {
+                        bits[i * w + r][j * w + c] = (col >> r) & 1;
+                    }
+                }
+            }
+        }
+        return bits;
+    }
+
+    /** Schedule the XORs computing the rows of a bit matrix
+     *
+     * Rows are computed cheapest first. A row is obtained either from the
+     * input sub-packets it selects, or from an already computed row plus the
+     * input sub-packets where both rows differ, whichever needs fewer XORs.
+     *
+     * @param bits bit matrix, see `to_bitmatrix`
+     * @param n_inputs number of input packets
+     */
+    std::vector<XorOp> make_schedule(
+        const std::vector<std::vector<bool>>& bits,
+        unsigned n_inputs) const
+    {
+        const unsigned w = 8 * this->word_size;
+        const size_t n_rows = bits.size();
+        const size_t n_cols = bits[0].size();
+        // number of sub-packets to combine, and the computed row to start
+        // from (`n_rows` if none)
+        std::vector<size_t> cost(n_rows);
+        std::vector<size_t> from(n_rows, n_rows);
+        std::vector<bool> done(n_rows, false);
+        std::vector<XorOp> ops;
+
+        for (size_t r = 0; r < n_rows; ++r) {
+            cost[r] = std::count(bits[r].begin(), bits[r].end(), true);
+        }
+
+        for (size_t step = 0; step < n_rows; ++step) {
+            size_t row = n_rows;
+            for (size_t r = 0; r < n_rows; ++r) {
+                if (!done[r] && (row == n_rows || cost[r] < cost[row])) {
+                    row = r;
+                }
+            }
+            done[row] = true;
+
+            const unsigned dest = row / w;
+            const unsigned dest_sub = row % w;
+            const size_t base = from[row];
+            bool copy = true;
+            if (base != n_rows) {
+                ops.push_back({static_cast<unsigned>(n_inputs + base / w),
+                               static_cast<unsigned>(base % w),
+                               dest,
+                               dest_sub,
+                               true});
+                copy = false;
+            }
+            for (size_t c = 0; c < n_cols; ++c) {
+                const bool in_base = base != n_rows && bits[base][c];
+                if (bits[row][c] != in_base) {
+                    ops.push_back({static_cast<unsigned>(c / w),
+                                   static_cast<unsigned>(c % w),
+                                   dest,
+                                   dest_sub,
+                                   copy});
+                    copy = false;
+                }
+            }
+            // rows of invertible or Cauchy bit matrices are never zero
+            assert(!copy);
+
+            for (size_t r = 0; r < n_rows; ++r) {
+                if (done[r]) {
+                    continue;
+                }
+                size_t diff = 1;
+                for (size_t c = 0; c < n_cols; ++c) {
+                    diff += bits[r][c] != bits[row][c];
+                }
+                if (diff < cost[r]) {
+                    cost[r] = diff;
+                    from[r] = row;
+                }
+            }
+        }
+        return ops;
+    }
+
+    /// Compute `output` from `input` packets by running a XOR schedule
+    void run_schedule(
+        const std::vector<XorOp>& schedule,
+        vec::Buffers<T>& output,
+        vec::Buffers<T>& input) const
+    {
+        const unsigned n_inputs = input.get_n();
+        const size_t sub_len = this->pkt_size / (8 * this->word_size);
+
+        for (const XorOp& op : schedule) {
+            T* src = op.src < n_inputs ? input.get(op.src)
+                                       : output.get(op.src - n_inputs);
+            src += op.src_sub * sub_len;
+            T* dest = output.get(op.dest) + op.dest_sub * sub_len;
+            if (op.copy) {
+                std::copy_n(src, sub_len, dest);
+            } else {
+                this->gf->add_two_bufs(src, dest, sub_len);
+            }
+        }
+    }
 };
 
 } // namespace fec
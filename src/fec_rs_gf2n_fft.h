@@ -34,13 +34,18 @@
 #include "fec_base.h"
 #include "fft_ct.h"
 #include "gf_bin_ext.h"
+#include "vec_buffers.h"
 #include "vec_vector.h"
 #include "vec_zero_ext.h"
 
 namespace quadiron {
 namespace fec {
 
-/** Reed-Solomon (RS) Erasure code over GF(2<sup>n</sup>)using FFT. */
+/** Reed-Solomon (RS) Erasure code over GF(2<sup>n</sup>)using FFT.
+ *
+ * Code lengths divide 2<sup>n</sup> - 1, e.g. 255 or 65535, so that the FFT is
+ * a mixed-radix fft::CooleyTukey, which also encodes and decodes packets.
+ */
 template <typename T>
 class RsGf2nFft : public FecCode<T> {
   public:
@@ -48,8 +53,17 @@ class RsGf2nFft : public FecCode<T> {
     using FecCode<T>::encode;
 
     // NOTE: only NON_SYSTEMATIC is supported now
-    RsGf2nFft(unsigned word_size, unsigned n_data, unsigned n_parities)
-        : FecCode<T>(FecType::NON_SYSTEMATIC, word_size, n_data, n_parities)
+    RsGf2nFft(
+        unsigned word_size,
+        unsigned n_data,
+        unsigned n_parities,
+        size_t pkt_size = 8)
+        : FecCode<T>(
+              FecType::NON_SYSTEMATIC,
+              word_size,
+              n_data,
+              n_parities,
+              pkt_size)
     {
         this->fec_init();
     }
@@ -121,6 +135,20 @@ class RsGf2nFft : public FecCode<T> {
         this->fft->fft(output, vwords);
     }
 
+    /** Encode buffers.
+     *
+     * @param output must be n
+     * @param words must be n_data
+     */
+    void encode(
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset,
+        vec::Buffers<T>& words) override
+    {
+        encode_packet(nullptr, output, props, offset, words, {});
+    }
+
     void decode_add_data(int, int) override
     {
         // not applicable
@@ -135,6 +163,19 @@ class RsGf2nFft : public FecCode<T> {
     {
         // nothing to do
     }
+
+  protected:
+    void encode_packet(
+        EncodeWorkspace<T>* workspace,
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset,
+        vec::Buffers<T>& words,
+        const std::vector<bool>& wanted_idxs) override
+    {
+        this->encode_packet_fft(
+            workspace, output, props, offset, words, wanted_idxs);
+    }
 };
 
 } // namespace fec
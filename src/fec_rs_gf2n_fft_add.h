@@ -35,13 +35,62 @@
 #include "fec_base.h"
 #include "fft_add.h"
 #include "gf_bin_ext.h"
+#include "vec_buffers.h"
+#include "vec_matrix.h"
 #include "vec_vector.h"
-#include "vec_zero_ext.h"
 
 namespace quadiron {
 namespace fec {
 
-/** Reed-Solomon (RS) Erasure code over GF(2<sup>n</sup>) using additive FFT. */
+/** Decoding context of RsGf2nFftAdd
+ *
+ * There is no fast interpolation over the additive FFT points, so vectors and
+ * buffers are interpolated with the matrix of the Lagrange polynomials of
+ * received fragments. It is built once per erasure pattern, in
+ * O(n_data<sup>2</sup>), and cached with the context.
+ *
+ * As other contexts, it also holds the scratch of decoding, i.e. the codeword
+ * over which systematic decoding of vectors evaluates interpolated words.
+ */
+template <typename T>
+class LagrangeDecodeContext : public DecodeContext<T> {
+  public:
+    LagrangeDecodeContext(
+        const gf::Field<T>& gf,
+        const vec::Vector<T>& fragments_ids,
+        const int k,
+        const int n,
+        std::unique_ptr<vec::Matrix<T>> mat)
+        : DecodeContext<T>(gf, fragments_ids, k, n), mat(std::move(mat))
+    {
+        codeword = std::make_unique<vec::Vector<T>>(gf, n);
+    }
+
+    vec::Matrix<T>& get_matrix() const
+    {
+        return *mat;
+    }
+
+    vec::Vector<T>& get_codeword() const
+    {
+        return *codeword;
+    }
+
+  private:
+    std::unique_ptr<vec::Matrix<T>> mat;
+    std::unique_ptr<vec::Vector<T>> codeword;
+};
+
+/** Reed-Solomon (RS) Erasure code over GF(2<sup>n</sup>) using additive FFT.
+ *
+ * The systematic code interpolates data words as if they were received in
+ * the first k fragments, then evaluates the polynomial over the codeword.
+ * Decoding evaluates the interpolated polynomial back at data fragments.
+ *
+ * Words are evaluated by the additive FFT, but interpolated with a matrix,
+ * see LagrangeDecodeContext. Data vectors are even encoded by a single matrix
+ * yielding their parities.
+ */
 template <typename T>
 class RsGf2nFftAdd : public FecCode<T> {
   public:
@@ -49,13 +98,22 @@ class RsGf2nFftAdd : public FecCode<T> {
     using FecCode<T>::decode_prepare;
     using FecCode<T>::encode;
 
-    // NOTE: only NON_SYSTEMATIC is supported now
-    RsGf2nFftAdd(unsigned word_size, unsigned n_data, unsigned n_parities)
-        : FecCode<T>(FecType::NON_SYSTEMATIC, word_size, n_data, n_parities)
+    RsGf2nFftAdd(
+        FecType type,
+        unsigned word_size,
+        unsigned n_data,
+        unsigned n_parities,
+        size_t pkt_size = 8)
+        : FecCode<T>(type, word_size, n_data, n_parities, pkt_size)
     {
         this->fec_init();
     }
 
+    RsGf2nFftAdd(unsigned word_size, unsigned n_data, unsigned n_parities)
+        : RsGf2nFftAdd(FecType::NON_SYSTEMATIC, word_size, n_data, n_parities)
+    {
+    }
+
     inline void check_params() override
     {
         if (this->word_size > 16)
@@ -76,26 +134,32 @@ class RsGf2nFftAdd : public FecCode<T> {
 
         T m = arith::log2<T>(this->n);
 
-        this->fft = std::unique_ptr<fft::Additive<T>>(
-            new fft::Additive<T>(*(this->gf), m));
-    }
+        auto fft_add = std::make_unique<fft::Additive<T>>(*(this->gf), m);
 
-    inline void init_others() override
-    {
         // subspace spanned by <beta_i>
         this->betas = std::unique_ptr<vec::Vector<T>>(
             new vec::Vector<T>(*(this->gf), this->n));
-        this->fft->compute_B(*betas);
+        fft_add->compute_B(*betas);
+
+        this->fft = std::move(fft_add);
+    }
+
+    inline void init_others() override
+    {
+        if (this->type == FecType::SYSTEMATIC) {
+            this->init_systematic();
+            enc_matrix = parity_matrix();
+        }
     }
 
     int get_n_outputs() override
     {
-        return this->n;
+        return (this->type == FecType::SYSTEMATIC) ? this->n_parities : this->n;
     }
 
     /** Encode vector.
      *
-     * @param output must be n
+     * @param output must be n, or n_parities for SYSTEMATIC
      * @param words must be n_data
      */
     void encode(
@@ -104,20 +168,71 @@ class RsGf2nFftAdd : public FecCode<T> {
         off_t,
         vec::Vector<T>& words) override
     {
-        vec::ZeroExtended<T> vwords(words, this->n);
-        this->fft->fft(output, vwords);
+        if (this->type != FecType::SYSTEMATIC) {
+            evaluate(output, words);
+        } else {
+            enc_matrix->mul(&output, &words);
+        }
     }
 
-    void decode_add_data(int, int) override
+    void encode(
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset,
+        vec::Buffers<T>& words) override
     {
-        // not applicable
-        assert(false);
+        encode_packet(nullptr, output, props, offset, words, {});
     }
 
   private:
     std::unique_ptr<vec::Vector<T>> betas = nullptr;
+    // matrix yielding parities from data words, used in systematic encoding of
+    // vectors. It is only read, so that concurrent encodings need no shared
+    // scratch.
+    std::unique_ptr<vec::Matrix<T>> enc_matrix = nullptr;
+
+    /** Evaluate a polynomial of degree lower than n_data over the codeword
+     *
+     * The additive FFT of vectors works on scratch owned by the transform,
+     * unlike the one of buffers: words are seen as buffers of one word, so
+     * that concurrent encodings share no state.
+     *
+     * @param output evaluations, must be n
+     * @param coefs coefficients of the polynomial, must be n_data
+     */
+    void evaluate(vec::Vector<T>& output, vec::Vector<T>& coefs)
+    {
+        std::vector<T*> output_mem(this->n);
+        std::vector<T*> coefs_mem(this->n_data);
+        for (unsigned i = 0; i < this->n; ++i) {
+            output_mem[i] = output.get_mem() + i;
+        }
+        for (unsigned i = 0; i < this->n_data; ++i) {
+            coefs_mem[i] = coefs.get_mem() + i;
+        }
+        vec::Buffers<T> voutput(this->n, 1, output_mem);
+        vec::Buffers<T> vcoefs(this->n_data, 1, coefs_mem);
+        this->fft->fft(voutput, vcoefs);
+    }
 
   protected:
+    std::unique_ptr<EncodeWorkspace<T>> init_encode_workspace() override
+    {
+        return this->init_sys_encode_workspace();
+    }
+
+    void encode_packet(
+        EncodeWorkspace<T>* workspace,
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset,
+        vec::Buffers<T>& words,
+        const std::vector<bool>& wanted_idxs) override
+    {
+        this->encode_packet_fft(
+            workspace, output, props, offset, words, wanted_idxs);
+    }
+
     std::unique_ptr<DecodeContext<T>> init_context_dec(
         vec::Vector<T>& fragments_ids,
         size_t,
@@ -130,31 +245,12 @@ class RsGf2nFftAdd : public FecCode<T> {
             throw LogicError("FEC FFT ADD: FFT must be initialized");
         }
 
-        int k = this->n_data; // number of fragments received
-        // vector x=(x_0, x_1, ..., x_k-1)
-        vec::Vector<T> vx(*(this->gf), k);
-
-        int vx_zero = -1;
-        for (unsigned i = 0; i < this->n_data; ++i) {
-            T val = betas->get(fragments_ids.get(i));
-            vx.set(i, val);
-            if (val == 0) {
-                vx_zero = i;
-            }
-        }
-
-        std::unique_ptr<DecodeContext<T>> context =
-            std::unique_ptr<DecodeContext<T>>(new DecodeContext<T>(
-                *(this->gf),
-                *fft,
-                *(this->fft_2k),
-                fragments_ids,
-                vx,
-                this->n_data,
-                this->n,
-                vx_zero));
-
-        return context;
+        return std::make_unique<LagrangeDecodeContext<T>>(
+            *(this->gf),
+            fragments_ids,
+            this->n_data,
+            this->n,
+            lagrange_matrix(fragments_ids));
     }
 
     void decode_prepare(
@@ -171,68 +267,122 @@ class RsGf2nFftAdd : public FecCode<T> {
         vec::Vector<T>& output,
         vec::Vector<T>& words) override
     {
-        const vec::Vector<T>& fragments_ids = context.get_fragments_id();
-        vec::Poly<T>& A = context.get_poly(CtxPoly::A);
-        vec::Vector<T>& inv_A_i = context.get_vector(CtxVec::INV_A_I);
-        vec::Vector<T>& vec1_n = context.get_vector(CtxVec::N1);
-        vec::Poly<T>& S = context.get_poly(CtxPoly::S);
+        static_cast<const LagrangeDecodeContext<T>&>(context)
+            .get_matrix()
+            .mul(&output, &words);
 
-        int k = this->n_data; // number of fragments received
-        int vx_zero = context.vx_zero;
-
-        // FIXME: split this step in decode_init as multiplicative FFT
-        vec::Vector<T> vx(*(this->gf), k);
-        for (unsigned i = 0; i < this->n_data; ++i) {
-            vx.set(i, this->betas->get(fragments_ids.get(i)));
+        if (this->type == FecType::SYSTEMATIC) {
+            // evaluate the polynomial at data fragments
+            vec::Vector<T>& codeword =
+                static_cast<const LagrangeDecodeContext<T>&>(context)
+                    .get_codeword();
+            evaluate(codeword, output);
+            for (unsigned i = 0; i < this->n_data; ++i) {
+                output.set(i, codeword.get(i));
+            }
         }
+    }
 
-        // compute N'(x) = sum_i{n_i * x^z_i}
-        // where n_i=v_i/A'_i(x_i)
-        vec1_n.zero_fill();
-        for (int i = 0; i <= k - 1; ++i) {
-            vec1_n.set(i, this->gf->mul(words.get(i), inv_A_i.get(i)));
+    void decode_apply(
+        const DecodeContext<T>& context,
+        vec::Buffers<T>& output,
+        vec::Buffers<T>& words) override
+    {
+        const auto& lagrange_context =
+            static_cast<const LagrangeDecodeContext<T>&>(context);
+        lagrange_context.get_matrix().mul(&output, &words);
+    }
+
+    void decode_data(
+        const DecodeContext<T>& context,
+        vec::Buffers<T>& output,
+        vec::Buffers<T>& words) override
+    {
+        decode_apply(context, output, words);
+    }
+
+    /** Compute the matrix interpolating words of received fragments
+     *
+     * Its i-th column holds the coefficients of the Lagrange polynomial
+     * \f$L_i(x) = \prod_{j \neq i}(x - x_j) / (x_i - x_j)\f$, i.e. of
+     * \f$A(x) / (x - x_i)\f$ divided by its value at \f$x_i\f$ where
+     * \f$A(x) = \prod_j(x - x_j)\f$.
+     *
+     * @param fragments_ids ids of received fragments, must be n_data
+     * @return a n_data x n_data matrix
+     */
+    std::unique_ptr<vec::Matrix<T>>
+    lagrange_matrix(const vec::Vector<T>& fragments_ids)
+    {
+        const unsigned k = this->n_data;
+        const gf::Field<T>& gf = *(this->gf);
+
+        vec::Vector<T> vx(gf, k);
+        // A(x) of degree k
+        vec::Vector<T> A(gf, k + 1);
+        A.zero_fill();
+        A.set(0, 1);
+        for (unsigned i = 0; i < k; ++i) {
+            const T x_i = betas->get(fragments_ids.get(i));
+            vx.set(i, x_i);
+            // A(x) *= (x - x_i)
+            for (unsigned j = i + 1; j >= 1; --j) {
+                A.set(j, gf.sub(A.get(j - 1), gf.mul(A.get(j), x_i)));
+            }
+            A.set(0, gf.sub(0, gf.mul(A.get(0), x_i)));
         }
 
-        // We have to find the numerator of the following expression:
-        // P(x)/A(x) = S(x) + R(x)
-        //  where S(x) = sum_{0 <= i <= k-1, i != vx_zero}(n_i/(x-x_i)) mod x^n
-        //        R(x) = _n[vx_zero] / x
-        // using Taylor series we rewrite the expression into
-        // S(x) = sum_i=0_k-1(sum_j=0_n-1(n_i*x_i^(-j-1)*x^j))
-        for (int j = 0; j <= k - 1; j++) {
+        auto mat = std::make_unique<vec::Matrix<T>>(gf, k, k);
+        vec::Vector<T> Q(gf, k);
+        for (unsigned i = 0; i < k; ++i) {
+            const T x_i = vx.get(i);
+            // Q(x) = A(x) / (x - x_i) by synthetic division
+            Q.set(k - 1, A.get(k));
+            for (unsigned j = k - 1; j >= 1; --j) {
+                Q.set(j - 1, gf.add(A.get(j), gf.mul(x_i, Q.get(j))));
+            }
+            // Q(x_i) = prod_{j != i}(x_i - x_j)
             T val = 0;
-            for (int i = 0; i <= k - 1; ++i) {
-                if (i == vx_zero)
-                    continue;
-                // perform Taylor series at 0
-                T xi_j_1 = this->gf->inv(this->gf->exp(vx.get(i), j));
-                val = this->gf->add(val, this->gf->mul(vec1_n.get(i), xi_j_1));
+            for (unsigned j = k; j-- > 0;) {
+                val = gf.add(gf.mul(val, x_i), Q.get(j));
+            }
+            const T inv_val = gf.inv(val);
+            for (unsigned j = 0; j < k; ++j) {
+                mat->set(j, i, gf.mul(Q.get(j), inv_val));
             }
-            S.set(j, val);
-        }
-        S.mul(&A, k - 1);
-        if (vx_zero > -1) {
-            assert(A.get(0) == 0);
-            // P(x) = A(x)*S(x) + _n[vx_zero] * A(x) / x
-            //  as S(x) does not include the term of vx_zero
-            // Note: A(0) = 0 since vx_zero exists
-            int deg = A.get_deg();
-            T val = vec1_n.get(vx_zero);
-            for (int i = 1; i <= deg; ++i)
-                S.set(
-                    i - 1,
-                    this->gf->add(S.get(i - 1), this->gf->mul(val, A.get(i))));
         }
-
-        // No need to mod x^n since only last n_data coefs are obtained
-        // output is n_data length
-        for (unsigned i = 0; i < this->n_data; ++i)
-            output.set(i, S.get(i));
+        return mat;
     }
 
-  private:
-    // this overwrite multiplicative FFT
-    std::unique_ptr<fft::Additive<T>> fft = nullptr;
+    /** Compute the matrix yielding parities from data words
+     *
+     * Its j-th column holds the evaluations over parity fragments of the
+     * polynomial taking one at the j-th data fragment and zero at the other
+     * ones, i.e. of the j-th Lagrange polynomial of data fragments.
+     *
+     * @return a n_parities x n_data matrix
+     */
+    std::unique_ptr<vec::Matrix<T>> parity_matrix()
+    {
+        const unsigned k = this->n_data;
+        const gf::Field<T>& gf = *(this->gf);
+
+        std::unique_ptr<vec::Matrix<T>> lagrange =
+            lagrange_matrix(*(this->enc_frag_ids));
+        auto mat = std::make_unique<vec::Matrix<T>>(gf, this->n_parities, k);
+        vec::Vector<T> coefs(gf, k);
+        vec::Vector<T> codeword(gf, this->n);
+        for (unsigned j = 0; j < k; ++j) {
+            for (unsigned i = 0; i < k; ++i) {
+                coefs.set(i, lagrange->get(i, j));
+            }
+            evaluate(codeword, coefs);
+            for (unsigned i = 0; i < this->n_parities; ++i) {
+                mat->set(i, j, codeword.get(k + i));
+            }
+        }
+        return mat;
+    }
 };
 
 } // namespace fec
@@ -33,10 +33,12 @@
 
 #include "arith.h"
 #include "fec_base.h"
+#include "fec_plan.h"
 #include "fft_2n.h"
 #include "fft_base.h"
 #include "fft_ct.h"
 #include "gf_prime.h"
+#include "vec_buffers.h"
 #include "vec_vector.h"
 #include "vec_zero_ext.h"
 
@@ -69,20 +71,36 @@ namespace fec {
  *    Y[i] = Y<sub>p</sub>[i] + 2<sup>8*word_size</sup>
  *
  * Because p < 2 * 2<sup>8*word_size</sup>, a single bool is enough as flag.
+ *
+ * The systematic code interpolates data words as if they were received in
+ * the first k fragments, then evaluates the polynomial over the whole
+ * codeword. Decoding of vectors evaluates the interpolated polynomial back at
+ * data fragments.
  */
 template <typename T>
 class RsGfpFft : public FecCode<T> {
   public:
+    using FecCode<T>::decode_apply;
     using FecCode<T>::decode_prepare;
     using FecCode<T>::encode_post_process;
     using FecCode<T>::encode;
 
-    RsGfpFft(unsigned word_size, unsigned n_data, unsigned n_parities)
-        : FecCode<T>(FecType::NON_SYSTEMATIC, word_size, n_data, n_parities)
+    RsGfpFft(
+        FecType type,
+        unsigned word_size,
+        unsigned n_data,
+        unsigned n_parities,
+        size_t pkt_size = 8)
+        : FecCode<T>(type, word_size, n_data, n_parities, pkt_size)
     {
         this->fec_init();
     }
 
+    RsGfpFft(unsigned word_size, unsigned n_data, unsigned n_parities)
+        : RsGfpFft(FecType::NON_SYSTEMATIC, word_size, n_data, n_parities)
+    {
+    }
+
     inline void check_params() override {}
 
     inline void init_gf() override
@@ -104,7 +122,7 @@ class RsGfpFft : public FecCode<T> {
         // we choose gf_p for a simple implementation
         assert(gf_p / 2 < this->limit_value);
 
-        this->gf = gf::alloc<gf::Field<T>, gf::Prime<T>>(gf_p);
+        this->gf = get_prime_field<T>(gf_p);
         assert(
             arith::jacobi<T>(this->gf->get_primitive_root(), this->gf->card())
             == -1);
@@ -122,20 +140,20 @@ class RsGfpFft : public FecCode<T> {
         this->r = this->gf->get_nth_root(this->n);
 
         if (arith::is_power_of_2<T>(this->n)) {
-            this->fft = std::unique_ptr<fft::Radix2<T>>(
-                new fft::Radix2<T>(*(this->gf), this->n));
+            int m = arith::ceil2<int>(this->n_data);
+            this->fft = get_radix2_fft<T>(*(this->gf), this->n, m);
         } else {
+            // CooleyTukey uses member scratch, hence it isn't shared
             this->fft = std::unique_ptr<fft::CooleyTukey<T>>(
                 new fft::CooleyTukey<T>(*(this->gf), this->n));
         }
 
         unsigned len_2k = this->gf->get_code_len_high_compo(2 * this->n_data);
         if (arith::is_power_of_2<T>(len_2k)) {
-            this->fft_2k = std::unique_ptr<fft::Radix2<T>>(
-                new fft::Radix2<T>(*(this->gf), len_2k, len_2k));
+            this->fft_2k = get_radix2_fft<T>(*(this->gf), len_2k, len_2k);
         } else {
             this->fft_2k = std::unique_ptr<fft::CooleyTukey<T>>(
-                new fft::CooleyTukey<T>(*(this->gf), len_2k, len_2k));
+                new fft::CooleyTukey<T>(*(this->gf), len_2k));
         }
     }
 
@@ -143,29 +161,30 @@ class RsGfpFft : public FecCode<T> {
     {
         // vector stores r^{-i} for i = 0, ... , k
         T inv_r = this->gf->inv(this->r);
-        this->inv_r_powers = std::unique_ptr<vec::Vector<T>>(
-            new vec::Vector<T>(*(this->gf), this->n_data + 1));
-        for (unsigned i = 0; i <= this->n_data; i++)
-            this->inv_r_powers->set(i, this->gf->exp(inv_r, i));
+        this->inv_r_powers =
+            get_powers<T>(*(this->gf), inv_r, this->n_data + 1);
 
         // vector stores r^{i} for i = 0, ... , k
-        this->r_powers = std::unique_ptr<vec::Vector<T>>(
-            new vec::Vector<T>(*(this->gf), this->n));
-        for (unsigned i = 0; i < this->n; i++) {
-            this->r_powers->set(i, this->gf->exp(this->r, i));
+        this->r_powers = get_powers<T>(*(this->gf), this->r, this->n);
+
+        if (this->type == FecType::SYSTEMATIC) {
+            this->init_systematic();
+            enc_context = this->init_context_dec(*(this->enc_frag_ids));
+            enc_coefs =
+                std::make_unique<vec::Vector<T>>(*(this->gf), this->n_data);
         }
     }
 
     int get_n_outputs() override
     {
-        return this->n;
+        return (this->type == FecType::SYSTEMATIC) ? this->n_parities : this->n;
     }
 
     /**
      * Encode vector
      *
-     * @param output must be n
-     * @param props must be exactly n
+     * @param output must be n, or n_parities for SYSTEMATIC
+     * @param props must be exactly n, or n_parities for SYSTEMATIC
      * @param offset used to locate special values
      * @param words must be n_data
      */
@@ -175,8 +194,18 @@ class RsGfpFft : public FecCode<T> {
         off_t offset,
         vec::Vector<T>& words) override
     {
-        vec::ZeroExtended<T> vwords(words, this->n);
-        this->fft->fft(output, vwords);
+        if (this->type != FecType::SYSTEMATIC) {
+            evaluate(output, words);
+        } else {
+            // polynomial taking the data words at the first n_data points
+            FecCode<T>::decode_apply(*enc_context, *enc_coefs, words);
+            // the scratch of the context is free once words are interpolated
+            vec::Vector<T>& codeword = enc_context->get_vector(CtxVec::N1);
+            evaluate(codeword, *enc_coefs);
+            for (unsigned i = 0; i < this->n_parities; ++i) {
+                output.set(i, codeword.get(this->n_data + i));
+            }
+        }
         encode_post_process(output, props, offset);
     }
 
@@ -186,7 +215,7 @@ class RsGfpFft : public FecCode<T> {
         off_t offset) override
     {
         // check for out of range value in output
-        for (unsigned i = 0; i < this->code_len; i++) {
+        for (unsigned i = 0; i < this->n_outputs; i++) {
             if (output.get(i) >= this->limit_value) {
                 props[i].add(offset, OOR_MARK);
                 output.set(i, output.get(i) % this->limit_value);
@@ -194,17 +223,74 @@ class RsGfpFft : public FecCode<T> {
         }
     }
 
-    void decode_add_data(int, int) override
+    void encode(
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset,
+        vec::Buffers<T>& words) override
+    {
+        encode_packet(nullptr, output, props, offset, words, {});
+    }
+
+    void encode_post_process(
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset) override
     {
-        // not applicable
-        assert(false);
+        // out of range values are truncated to word_size bytes by unpacking
+        const unsigned size = output.get_size();
+        for (unsigned i = 0; i < this->n_outputs; ++i) {
+            const T* chunk = output.get(i);
+            for (unsigned j = 0; j < size; ++j) {
+                if (chunk[j] >= limit_value) {
+                    props[i].add(offset + j, OOR_MARK);
+                }
+            }
+        }
     }
 
   private:
     // fft::FourierTransform<T>* fft = nullptr;
     T limit_value;
+    // context interpolating data fragments, and coefficients of the
+    // interpolated polynomial, used in systematic encoding of vectors
+    std::unique_ptr<DecodeContext<T>> enc_context = nullptr;
+    std::unique_ptr<vec::Vector<T>> enc_coefs = nullptr;
+
+    /** Evaluate a polynomial of degree lower than n_data over the codeword
+     *
+     * @param output evaluations, must be n
+     * @param coefs coefficients of the polynomial, must be n_data
+     */
+    void evaluate(vec::Vector<T>& output, vec::Vector<T>& coefs)
+    {
+        vec::ZeroExtended<T> vcoefs(coefs, this->n);
+        this->fft->fft(output, vcoefs);
+    }
 
   protected:
+    T restore_symbol(T value, uint32_t prop) override
+    {
+        return prop == OOR_MARK ? value + limit_value : value;
+    }
+
+    std::unique_ptr<EncodeWorkspace<T>> init_encode_workspace() override
+    {
+        return this->init_sys_encode_workspace();
+    }
+
+    void encode_packet(
+        EncodeWorkspace<T>* workspace,
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset,
+        vec::Buffers<T>& words,
+        const std::vector<bool>& wanted_idxs) override
+    {
+        this->encode_packet_fft(
+            workspace, output, props, offset, words, wanted_idxs);
+    }
+
     /* Prepare for decoding
      * It supports for FEC using multiplicative FFT over FNT
      */
@@ -215,10 +301,17 @@ class RsGfpFft : public FecCode<T> {
         vec::Vector<T>& words) override
     {
         const vec::Vector<T>& fragments_ids = context.get_fragments_id();
-        int k = this->n_data; // number of fragments received
-        for (int i = 0; i < k; ++i) {
-            const int j = fragments_ids.get(i);
-            auto data = props[j].get(offset);
+        const bool systematic = this->type == FecType::SYSTEMATIC;
+        for (unsigned i = 0; i < this->n_data; ++i) {
+            unsigned frag_id = fragments_ids.get(i);
+            // Systematic data fragments are stored as is, without properties.
+            if (systematic && frag_id < this->n_data) {
+                continue;
+            }
+            if (systematic) {
+                frag_id -= this->n_data;
+            }
+            auto data = props[frag_id].get(offset);
 
             // Check if the symbol is a special case whick is marked by
             // `OOR_MARK`. In encoded data, its value was subtracted by the
@@ -228,6 +321,24 @@ class RsGfpFft : public FecCode<T> {
             }
         }
     }
+
+    void decode_apply(
+        const DecodeContext<T>& context,
+        vec::Vector<T>& output,
+        vec::Vector<T>& words) override
+    {
+        FecCode<T>::decode_apply(context, output, words);
+
+        if (this->type == FecType::SYSTEMATIC) {
+            // evaluate the polynomial at data fragments, over the scratch of
+            // the context that is free once words are interpolated
+            vec::Vector<T>& codeword = context.get_vector(CtxVec::N1);
+            evaluate(codeword, output);
+            for (unsigned i = 0; i < this->n_data; ++i) {
+                output.set(i, codeword.get(i));
+            }
+        }
+    }
 };
 
 } // namespace fec
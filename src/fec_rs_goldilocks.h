@@ -0,0 +1,172 @@
+/* -*- mode: c++ -*- */
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __QUAD_FEC_RS_GOLDILOCKS_H__
+#define __QUAD_FEC_RS_GOLDILOCKS_H__
+
+#include "arith.h"
+#include "fec_base.h"
+#include "fec_plan.h"
+#include "fft_2n.h"
+#include "gf_goldilocks.h"
+#include "vec_buffers.h"
+#include "vec_vector.h"
+
+namespace quadiron {
+namespace fec {
+
+/** Reed-Solomon (RS) erasure code over GF(2<sup>64</sup> - 2<sup>32</sup> + 1)
+ * and FFT.
+ *
+ * The field has power-of-two roots of unity up to 2<sup>32</sup>, hence codes
+ * run on radix-2 FFTs for any `word_size` from 4 to 7 bytes. Lengths of FFTs
+ * are `int`, so that codes are up to 2<sup>30</sup> long, with up to
+ * 2<sup>29</sup> data fragments.
+ *
+ * Data words are lower than p, but encoded symbols need up to 64 bits, hence
+ * coded fragments are stored on 8-byte words whatever `word_size`: a coded
+ * block is get_coded_size() bytes long, and no property is ever emitted.
+ */
+class RsGoldilocks : public FecCode<uint64_t> {
+  public:
+    using T = uint64_t;
+    using FecCode<T>::encode;
+
+    RsGoldilocks(
+        unsigned word_size,
+        unsigned n_data,
+        unsigned n_parities,
+        size_t pkt_size = 8)
+        : FecCode<T>(
+              FecType::NON_SYSTEMATIC,
+              word_size,
+              n_data,
+              n_parities,
+              pkt_size)
+    {
+        this->set_coded_word_size(sizeof(T));
+        this->fec_init();
+    }
+
+    inline void check_params() override
+    {
+        assert(this->word_size >= 4 && this->word_size < sizeof(T));
+        // lengths of the FFTs, n and 2k rounded up to powers of two, are int
+        assert(T(this->n_data) + this->n_parities <= (T(1) << 30));
+        assert(this->n_data <= (1U << 29));
+    }
+
+    inline void init_gf() override
+    {
+        this->gf = get_goldilocks_field();
+    }
+
+    inline void init_fft() override
+    {
+        // divisors of p - 1 up to 2^32 are powers of two
+        this->n = this->gf->get_code_len_high_compo(
+            T(this->n_parities) + this->n_data);
+
+        // compute root of order n-1 such as r^(n-1) mod q == 1
+        this->r = this->gf->get_nth_root(this->n);
+
+        int m = arith::ceil2<int>(this->n_data);
+        this->fft = get_radix2_fft<T>(*(this->gf), this->n, m);
+
+        T len_2k = this->gf->get_code_len_high_compo(2 * T(this->n_data));
+        this->fft_2k = get_radix2_fft<T>(*(this->gf), len_2k, len_2k);
+    }
+
+    inline void init_others() override
+    {
+        // vector stores r^{-i} for i = 0, ... , k
+        T inv_r = this->gf->inv(this->r);
+        this->inv_r_powers =
+            get_powers<T>(*(this->gf), inv_r, this->n_data + 1);
+
+        // vector stores r^{i} for i = 0, ... , n-1
+        this->r_powers = get_powers<T>(*(this->gf), this->r, this->n);
+    }
+
+    int get_n_outputs() override
+    {
+        return this->n;
+    }
+
+    /**
+     * Encode vector
+     *
+     * @param output must be n
+     * @param props must be exactly n
+     * @param offset unused, symbols need no property
+     * @param words must be n_data
+     */
+    void encode(
+        vec::Vector<T>& output,
+        std::vector<Properties>&,
+        off_t,
+        vec::Vector<T>& words) override
+    {
+        this->fft->fft(output, words);
+    }
+
+    void encode(
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset,
+        vec::Buffers<T>& words) override
+    {
+        encode_packet(nullptr, output, props, offset, words, {});
+    }
+
+    void decode_add_data(int, int) override
+    {
+        // not applicable
+        assert(false);
+    }
+
+  protected:
+    void encode_packet(
+        EncodeWorkspace<T>* workspace,
+        vec::Buffers<T>& output,
+        std::vector<Properties>& props,
+        off_t offset,
+        vec::Buffers<T>& words,
+        const std::vector<bool>& wanted_idxs) override
+    {
+        this->encode_packet_fft(
+            workspace, output, props, offset, words, wanted_idxs);
+    }
+};
+
+} // namespace fec
+} // namespace quadiron
+
+#endif
@@ -34,6 +34,7 @@
 #include <string>
 
 #include "fec_base.h"
+#include "fec_plan.h"
 #include "fft_2n.h"
 #include "gf_base.h"
 #include "gf_nf4.h"
@@ -70,7 +71,7 @@ class RsNf4 : public FecCode<T> {
     inline void init_gf() override
     {
         gf_n = this->word_size / 2;
-        this->gf = gf::alloc<gf::Field<T>, gf::NF4<T>>(gf_n);
+        this->gf = get_nf4_field<T>(gf_n);
         ngff4 = static_cast<gf::NF4<T>*>(this->gf.get());
         sub_field = &(ngff4->get_sub_field());
     }
@@ -87,29 +88,20 @@ class RsNf4 : public FecCode<T> {
         this->r = ngff4->get_nth_root(this->n);
 
         int m = arith::ceil2<int>(this->n_data);
-        this->fft = std::unique_ptr<fft::Radix2<T>>(
-            new fft::Radix2<T>(*ngff4, this->n, m, this->pkt_size));
+        this->fft = get_radix2_fft<T>(*ngff4, this->n, m);
 
         unsigned len_2k = this->gf->get_code_len_high_compo(2 * this->n_data);
-        this->fft_2k = std::unique_ptr<fft::Radix2<T>>(
-            new fft::Radix2<T>(*ngff4, len_2k, len_2k, this->pkt_size));
+        this->fft_2k = get_radix2_fft<T>(*ngff4, len_2k, len_2k);
     }
 
     inline void init_others() override
     {
         // vector stores r^{-i} for i = 0, ... , k
         const T inv_r = ngff4->inv(this->r);
-        this->inv_r_powers = std::unique_ptr<vec::Vector<T>>(
-            new vec::Vector<T>(*ngff4, this->n_data + 1));
-        for (unsigned i = 0; i <= this->n_data; i++)
-            this->inv_r_powers->set(i, ngff4->exp(inv_r, i));
+        this->inv_r_powers = get_powers<T>(*ngff4, inv_r, this->n_data + 1);
 
         // vector stores r^{i} for i = 0, ... , k
-        this->r_powers = std::unique_ptr<vec::Vector<T>>(
-            new vec::Vector<T>(*ngff4, this->n));
-        for (unsigned i = 0; i < this->n; i++) {
-            this->r_powers->set(i, ngff4->exp(this->r, i));
-        }
+        this->r_powers = get_powers<T>(*ngff4, this->r, this->n);
     }
 
     int get_n_outputs() override
@@ -173,6 +165,19 @@ class RsNf4 : public FecCode<T> {
     int gf_n;
 
   protected:
+    T restore_symbol(T value, uint32_t prop) override
+    {
+        return prop ? ngff4->pack(value, prop) : ngff4->pack(value);
+    }
+
+    void generator_column(unsigned frag_idx, vec::Vector<T>& column) override
+    {
+        vec::Vector<T> words(*ngff4, this->n_data);
+        words.zero_fill();
+        words.set(frag_idx, ngff4->get_unit());
+        this->fft->fft(column, words);
+    }
+
     std::unique_ptr<DecodeContext<T>> init_context_dec(
         vec::Vector<T>& fragments_ids,
         size_t size,
@@ -299,32 +304,20 @@ class RsNf4 : public FecCode<T> {
             const int frag_id = fragments_ids.get(i);
             T* chunk = words.get(i);
 
-            // the vector will contain marked symbols that will be packed
-            // firstly. Since locations are stored in unordered map, the vector
-            // will be sorted later to facilitate packing un-marked symbols
-            std::vector<size_t> packed_symbs;
-            // pack marked symbols
-            for (auto const& data : props[frag_id].get_map()) {
-                const off_t loc_offset = data.first;
-                if (loc_offset >= offset && loc_offset < offset_max) {
-                    // As loc.offset := offset + j
-                    const size_t j = loc_offset - offset;
-                    packed_symbs.push_back(j);
-                    // pack symbol at index `j`
-                    chunk[j] = ngff4->pack(chunk[j], data.second);
-                }
-            }
-            // sort the list of packed symbols
-            std::sort(packed_symbs.begin(), packed_symbs.end());
+            // marked symbols of the packet, sorted by location
+            const auto marks = props[frag_id].get_range(offset, offset_max);
 
-            // pack un-marked symbols
             size_t curr_frag_index = 0;
-            for (auto const& done_id : packed_symbs) {
-                // pack symbols from `curr_frag_index` to `j-1`
-                for (; curr_frag_index < done_id; ++curr_frag_index) {
+            for (auto it = marks.first; it != marks.second; ++it) {
+                // As loc.offset := offset + j
+                const size_t j = it->first - offset;
+                // pack un-marked symbols from `curr_frag_index` to `j-1`
+                for (; curr_frag_index < j; ++curr_frag_index) {
                     chunk[curr_frag_index] =
                         ngff4->pack(chunk[curr_frag_index]);
                 }
+                // pack marked symbol at index `j`
+                chunk[j] = ngff4->pack(chunk[j], it->second);
                 curr_frag_index++;
             }
             // pack last symbols from `curr_frag_index` to `this->pkt_size-1`
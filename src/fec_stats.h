@@ -0,0 +1,166 @@
+/* -*- mode: c++ -*- */
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __QUAD_FEC_STATS_H__
+#define __QUAD_FEC_STATS_H__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "misc.h"
+
+namespace quadiron {
+namespace fec {
+
+/** Stages of block encoding and decoding */
+enum class Stage {
+    /** Copy of packets from/to blocks, including zero-padding */
+    COPY = 0,
+    /** Conversion of bytes into words, including the restoration of marked
+     * symbols for decoding */
+    PACK,
+    /** Transform, i.e. FFT or matrix multiplication */
+    FFT,
+    /** Out-of-range symbols detection */
+    POST_PROCESS,
+    /** Conversion of words into bytes */
+    UNPACK,
+    /** Lookup or build of decoding context */
+    CONTEXT,
+};
+
+/** Number of stages */
+static constexpr size_t n_stages = static_cast<size_t>(Stage::CONTEXT) + 1;
+
+/** Cycle and byte counters of each stage of block coding
+ *
+ * Counters are only updated when built with `QUADIRON_STAGE_STATS`, they
+ * stay null otherwise and the instrumentation compiles to nothing.
+ *
+ * Counters can be updated concurrently by the workers of a same operation.
+ */
+class StageStats {
+  public:
+    /** Whether counters are updated in this build */
+#ifdef QUADIRON_STAGE_STATS
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    void add(Stage stage, uint64_t cycles, uint64_t bytes)
+    {
+        Counters& counters = stages[static_cast<size_t>(stage)];
+        counters.cycles.fetch_add(cycles, std::memory_order_relaxed);
+        counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        counters.calls.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** Cycles spent in a stage */
+    uint64_t get_cycles(Stage stage) const
+    {
+        return stages[static_cast<size_t>(stage)].cycles;
+    }
+
+    /** Bytes processed by a stage */
+    uint64_t get_bytes(Stage stage) const
+    {
+        return stages[static_cast<size_t>(stage)].bytes;
+    }
+
+    /** Number of times a stage was run */
+    uint64_t get_calls(Stage stage) const
+    {
+        return stages[static_cast<size_t>(stage)].calls;
+    }
+
+    void reset()
+    {
+        for (auto& counters : stages) {
+            counters.cycles = 0;
+            counters.bytes = 0;
+            counters.calls = 0;
+        }
+    }
+
+  private:
+    struct Counters {
+        std::atomic<uint64_t> cycles{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> calls{0};
+    };
+
+    std::array<Counters, n_stages> stages;
+};
+
+/** Scoped timer adding its lifetime to a stage of a `StageStats`
+ *
+ * Bytes are either known upfront, or added by the stage as it processes
+ * them, e.g. by copies of which some are skipped.
+ */
+class StageTimer {
+  public:
+#ifdef QUADIRON_STAGE_STATS
+    StageTimer(StageStats& stats, Stage stage, uint64_t bytes = 0)
+        : stats(stats), stage(stage), bytes(bytes), start(hw_timer())
+    {
+    }
+
+    ~StageTimer()
+    {
+        stats.add(stage, hw_timer() - start, bytes);
+    }
+
+    void add_bytes(uint64_t n)
+    {
+        bytes += n;
+    }
+
+  private:
+    StageStats& stats;
+    const Stage stage;
+    uint64_t bytes;
+    const uint64_t start;
+#else
+    StageTimer(StageStats&, Stage, uint64_t = 0) {}
+
+    void add_bytes(uint64_t) {}
+#endif
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+};
+
+} // namespace fec
+} // namespace quadiron
+
+#endif
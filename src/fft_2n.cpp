@@ -43,23 +43,28 @@ namespace quadiron {
 namespace fft {
 
 template <>
-void Radix2<uint16_t>::butterfly_ct_two_layers_step(
+void Radix2<uint16_t>::butterfly_ct_radix4_step(
     vec::Buffers<uint16_t>& buf,
     unsigned start,
     unsigned m)
 {
-    const unsigned coefIndex = start * this->n / m / 2;
-    const uint16_t r1 = vec_W[coefIndex];
-    const uint16_t r2 = vec_W[coefIndex / 2];
-    const uint16_t r3 = vec_W[coefIndex / 2 + this->n / 4];
+    const unsigned coef_index = start * (this->n / m / 4);
+    const uint16_t r1 = vec_W[2 * coef_index];
+    const uint16_t r2 = vec_W[coef_index];
+    const uint16_t r3 = vec_W[3 * coef_index];
+    const uint16_t j = vec_W[this->n / 4];
+
+    const size_t len = buf.get_size();
+    const size_t vec_len = len / simd::countof<uint16_t>();
+    const size_t offset = vec_len * simd::countof<uint16_t>();
 
     // perform vector operations
-    simd::butterfly_ct_two_layers_step(
-        buf, r1, r2, r3, start, m, simd_vec_len, card);
+    simd::butterfly_ct_radix4_step(
+        buf, r1, r2, r3, j, start, m, vec_len, card);
 
     // for last elements, perform as non-SIMD method
-    if (simd_trailing_len > 0) {
-        butterfly_ct_two_layers_step_slow(buf, start, m, simd_offset);
+    if (offset < len) {
+        butterfly_ct_radix4_step_slow(buf, start, m, offset);
     }
 }
 
@@ -71,12 +76,16 @@ void Radix2<uint16_t>::butterfly_ct_step(
     unsigned m,
     unsigned step)
 {
+    const size_t len = buf.get_size();
+    const size_t vec_len = len / simd::countof<uint16_t>();
+    const size_t offset = vec_len * simd::countof<uint16_t>();
+
     // perform vector operations
-    simd::butterfly_ct_step(buf, r, start, m, step, simd_vec_len, card);
+    simd::butterfly_ct_step(buf, r, start, m, step, vec_len, card);
 
     // for last elements, perform as non-SIMD method
-    if (simd_trailing_len > 0) {
-        butterfly_ct_step_slow(buf, r, start, m, step, simd_offset);
+    if (offset < len) {
+        butterfly_ct_step_slow(buf, r, start, m, step, offset);
     }
 }
 
@@ -88,12 +97,16 @@ void Radix2<uint16_t>::butterfly_gs_step(
     unsigned m,
     unsigned step)
 {
+    const size_t len = buf.get_size();
+    const size_t vec_len = len / simd::countof<uint16_t>();
+    const size_t offset = vec_len * simd::countof<uint16_t>();
+
     // perform vector operations
-    simd::butterfly_gs_step(buf, coef, start, m, simd_vec_len, card);
+    simd::butterfly_gs_step(buf, coef, start, m, vec_len, card);
 
     // for last elements, perform as non-SIMD method
-    if (simd_trailing_len > 0) {
-        butterfly_gs_step_slow(buf, coef, start, m, step, simd_offset);
+    if (offset < len) {
+        butterfly_gs_step_slow(buf, coef, start, m, step, offset);
     }
 }
 
@@ -105,33 +118,42 @@ void Radix2<uint16_t>::butterfly_gs_step_simple(
     unsigned m,
     unsigned step)
 {
+    const size_t len = buf.get_size();
+    const size_t vec_len = len / simd::countof<uint16_t>();
+    const size_t offset = vec_len * simd::countof<uint16_t>();
+
     // perform vector operations
-    simd::butterfly_gs_step_simple(buf, coef, start, m, simd_vec_len, card);
+    simd::butterfly_gs_step_simple(buf, coef, start, m, vec_len, card);
 
     // for last elements, perform as non-SIMD method
-    if (simd_trailing_len > 0) {
-        butterfly_gs_step_simple_slow(buf, coef, start, m, step, simd_offset);
+    if (offset < len) {
+        butterfly_gs_step_simple_slow(buf, coef, start, m, step, offset);
     }
 }
 
 template <>
-void Radix2<uint32_t>::butterfly_ct_two_layers_step(
+void Radix2<uint32_t>::butterfly_ct_radix4_step(
     vec::Buffers<uint32_t>& buf,
     unsigned start,
     unsigned m)
 {
-    const unsigned coefIndex = start * this->n / m / 2;
-    const uint32_t r1 = vec_W[coefIndex];
-    const uint32_t r2 = vec_W[coefIndex / 2];
-    const uint32_t r3 = vec_W[coefIndex / 2 + this->n / 4];
+    const unsigned coef_index = start * (this->n / m / 4);
+    const uint32_t r1 = vec_W[2 * coef_index];
+    const uint32_t r2 = vec_W[coef_index];
+    const uint32_t r3 = vec_W[3 * coef_index];
+    const uint32_t j = vec_W[this->n / 4];
+
+    const size_t len = buf.get_size();
+    const size_t vec_len = len / simd::countof<uint32_t>();
+    const size_t offset = vec_len * simd::countof<uint32_t>();
 
     // perform vector operations
-    simd::butterfly_ct_two_layers_step(
-        buf, r1, r2, r3, start, m, simd_vec_len, card);
+    simd::butterfly_ct_radix4_step(
+        buf, r1, r2, r3, j, start, m, vec_len, card);
 
     // for last elements, perform as non-SIMD method
-    if (simd_trailing_len > 0) {
-        butterfly_ct_two_layers_step_slow(buf, start, m, simd_offset);
+    if (offset < len) {
+        butterfly_ct_radix4_step_slow(buf, start, m, offset);
     }
 }
 
@@ -143,12 +165,16 @@ void Radix2<uint32_t>::butterfly_ct_step(
     unsigned m,
     unsigned step)
 {
+    const size_t len = buf.get_size();
+    const size_t vec_len = len / simd::countof<uint32_t>();
+    const size_t offset = vec_len * simd::countof<uint32_t>();
+
     // perform vector operations
-    simd::butterfly_ct_step(buf, r, start, m, step, simd_vec_len, card);
+    simd::butterfly_ct_step(buf, r, start, m, step, vec_len, card);
 
     // for last elements, perform as non-SIMD method
-    if (simd_trailing_len > 0) {
-        butterfly_ct_step_slow(buf, r, start, m, step, simd_offset);
+    if (offset < len) {
+        butterfly_ct_step_slow(buf, r, start, m, step, offset);
     }
 }
 
@@ -160,12 +186,16 @@ void Radix2<uint32_t>::butterfly_gs_step(
     unsigned m,
     unsigned step)
 {
+    const size_t len = buf.get_size();
+    const size_t vec_len = len / simd::countof<uint32_t>();
+    const size_t offset = vec_len * simd::countof<uint32_t>();
+
     // perform vector operations
-    simd::butterfly_gs_step(buf, coef, start, m, simd_vec_len, card);
+    simd::butterfly_gs_step(buf, coef, start, m, vec_len, card);
 
     // for last elements, perform as non-SIMD method
-    if (simd_trailing_len > 0) {
-        butterfly_gs_step_slow(buf, coef, start, m, step, simd_offset);
+    if (offset < len) {
+        butterfly_gs_step_slow(buf, coef, start, m, step, offset);
     }
 }
 
@@ -177,12 +207,16 @@ void Radix2<uint32_t>::butterfly_gs_step_simple(
     unsigned m,
     unsigned step)
 {
+    const size_t len = buf.get_size();
+    const size_t vec_len = len / simd::countof<uint32_t>();
+    const size_t offset = vec_len * simd::countof<uint32_t>();
+
     // perform vector operations
-    simd::butterfly_gs_step_simple(buf, coef, start, m, simd_vec_len, card);
+    simd::butterfly_gs_step_simple(buf, coef, start, m, vec_len, card);
 
     // for last elements, perform as non-SIMD method
-    if (simd_trailing_len > 0) {
-        butterfly_gs_step_simple_slow(buf, coef, start, m, step, simd_offset);
+    if (offset < len) {
+        butterfly_gs_step_simple_slow(buf, coef, start, m, step, offset);
     }
 }
 
@@ -75,12 +75,17 @@ class Radix2 : public FourierTransform<T> {
         const gf::Field<T>& gf,
         int n,
         int data_len = 0,
-        size_t pkt_size = 0);
+        size_t pkt_size = 0,
+        T _w = 0);
     ~Radix2() = default;
     void fft(vec::Vector<T>& output, vec::Vector<T>& input) override;
     void ifft(vec::Vector<T>& output, vec::Vector<T>& input) override;
     void fft_inv(vec::Vector<T>& output, vec::Vector<T>& input) override;
     void fft(vec::Buffers<T>& output, vec::Buffers<T>& input) override;
+    void fft_pruned(
+        vec::Buffers<T>& output,
+        vec::Buffers<T>& input,
+        const std::vector<bool>& wanted) override;
     void ifft(vec::Buffers<T>& output, vec::Buffers<T>& input) override;
     void fft_inv(vec::Buffers<T>& output, vec::Buffers<T>& input) override;
 
@@ -88,13 +93,21 @@ class Radix2 : public FourierTransform<T> {
     void init_bitrev();
     void bit_rev_permute(vec::Vector<T>& vec);
     void bit_rev_permute(vec::Buffers<T>& vec);
+    bool is_needed(
+        const std::vector<bool>& wanted,
+        unsigned residue,
+        unsigned modulus) const;
+    void fft_inv(
+        vec::Buffers<T>& output,
+        vec::Buffers<T>& input,
+        bool normalize);
     void butterfly_ct_step(
         vec::Buffers<T>& buf,
         T r,
         unsigned start,
         unsigned m,
         unsigned step);
-    void butterfly_ct_two_layers_step(
+    void butterfly_ct_radix4_step(
         vec::Buffers<T>& buf,
         unsigned start,
         unsigned m);
@@ -112,7 +125,7 @@ class Radix2 : public FourierTransform<T> {
         unsigned step);
 
     // Only used for non-vectorized elements
-    void butterfly_ct_two_layers_step_slow(
+    void butterfly_ct_radix4_step_slow(
         vec::Buffers<T>& buf,
         unsigned start,
         unsigned m,
@@ -144,13 +157,6 @@ class Radix2 : public FourierTransform<T> {
     T card_minus_one;
     T w;
     T inv_w;
-    size_t pkt_size;
-    size_t buf_size;
-
-    // Indices used for accelerated functions
-    size_t simd_vec_len;
-    size_t simd_trailing_len;
-    size_t simd_offset;
 
     std::unique_ptr<T[]> rev = nullptr;
     std::unique_ptr<vec::Vector<T>> W = nullptr;
@@ -160,24 +166,28 @@ class Radix2 : public FourierTransform<T> {
 
 /** Initialize the FFT object.
  *
- * n-th root will be constructed with primitive root
+ * Unless given, n-th root will be constructed with primitive root
  *
  * @param gf field associated to the FFT
  * @param n FFT length, for now must be a power of 2
  * @param data_len length of input vector without zero padding. It allows
  * shorterning operation cycles
- * @param pkt_size size of packet, i.e. number of symbols per chunk will be
- *  received and processed at a time
+ * @param pkt_size unused, buffers are transformed whatever their size
+ * @param _w n-th root of unity, e.g. the one required by a mixed-radix FFT
+ * using this FFT as inner DFT, 0 to construct it
  */
 template <typename T>
-Radix2<T>::Radix2(const gf::Field<T>& gf, int n, int data_len, size_t pkt_size)
+Radix2<T>::Radix2(
+    const gf::Field<T>& gf,
+    int n,
+    int data_len,
+    size_t /* pkt_size */,
+    T _w)
     : FourierTransform<T>(gf, n)
 {
-    w = gf.get_nth_root(n);
+    w = (_w != 0) ? _w : gf.get_nth_root(n);
     inv_w = gf.inv(w);
-    this->pkt_size = pkt_size;
     this->data_len = data_len > 0 ? data_len : n;
-    buf_size = pkt_size * sizeof(T);
 
     W = std::unique_ptr<vec::Vector<T>>(new vec::Vector<T>(gf, n));
     inv_W = std::unique_ptr<vec::Vector<T>>(new vec::Vector<T>(gf, n));
@@ -191,12 +201,6 @@ Radix2<T>::Radix2(const gf::Field<T>& gf, int n, int data_len, size_t pkt_size)
 
     rev = std::unique_ptr<T[]>(new T[n]);
     init_bitrev();
-
-    // Indices used for accelerated functions
-    const unsigned ratio = simd::countof<T>();
-    simd_vec_len = this->pkt_size / ratio;
-    simd_trailing_len = this->pkt_size - simd_vec_len * ratio;
-    simd_offset = simd_vec_len * ratio;
 }
 
 template <typename T>
@@ -211,12 +215,16 @@ void Radix2<T>::init_bitrev()
     }
 }
 
+// Elements are accessed by get/set, so that `vec` may be a vec::View, e.g. when
+// used as inner DFT of a mixed-radix FFT
 template <typename T>
 void Radix2<T>::bit_rev_permute(vec::Vector<T>& vec)
 {
     for (unsigned i = 0; i < static_cast<unsigned>(this->n); ++i) {
         if (rev[i] < i) {
-            vec.swap(i, rev[i]);
+            const T tmp = vec.get(i);
+            vec.set(i, vec.get(rev[i]));
+            vec.set(rev[i], tmp);
         }
     }
 }
@@ -313,8 +321,12 @@ template <typename T>
 void Radix2<T>::fft_inv(vec::Vector<T>& output, vec::Vector<T>& input)
 {
     const unsigned len = this->n;
+    const unsigned input_len = input.get_n();
 
-    output.copy(&input);
+    // copy by get/set as `input` and `output` may be vec::View
+    for (unsigned i = 0; i < len; ++i) {
+        output.set(i, i < input_len ? input.get(i) : 0);
+    }
 
     for (unsigned m = len / 2; m >= 1; m /= 2) {
         unsigned doubled_m = 2 * m;
@@ -345,6 +357,12 @@ void Radix2<T>::ifft(vec::Vector<T>& output, vec::Vector<T>& input)
 }
 
 /** Perform decimation-in-time FFT
+ *
+ * When `n` packets do not fit in cache, performing the butterfly layers one
+ * after the other would read and write all of them from memory at each layer.
+ * As symbols of a packet are independent, packets are rather split in tiles of
+ * `tile_len` symbols: all layers are performed on a tile, from the bit-reversal
+ * ordering, before moving to the next one.
  *
  * @param output - output buffers
  * @param input - input buffers
@@ -360,36 +378,139 @@ void Radix2<T>::fft(vec::Buffers<T>& output, vec::Buffers<T>& input)
 
     const std::vector<T*>& i_mem = input.get_mem();
     const std::vector<T*>& o_mem = output.get_mem();
+    const size_t pkt_size = output.get_size();
+    const size_t tile_len = get_tile_len<T>(len, pkt_size);
+    const size_t n_tiles = tile_len ? (pkt_size + tile_len - 1) / tile_len : 0;
+    vec::Buffers<T> tile(len, tile_len, o_mem);
+
+    for (size_t t = 0; t < n_tiles; ++t) {
+        const size_t offset = t * tile_len;
+        const size_t size = std::min(tile_len, pkt_size - offset);
+        tile.set_view(o_mem, offset, size);
+
+        for (unsigned idx = 0; idx < input_len; ++idx) {
+            // set output  = scramble(input), i.e. bit reversal ordering
+            for (unsigned i = rev[idx]; i < rev[idx] + group_len; ++i) {
+                memcpy(tile.get(i), i_mem[idx] + offset, size * sizeof(T));
+            }
+        }
+        for (unsigned idx = input_len; idx < data_len; ++idx) {
+            // set output  = scramble(input), i.e. bit reversal ordering
+            for (unsigned i = rev[idx]; i < rev[idx] + group_len; ++i) {
+                memset(tile.get(i), 0, size * sizeof(T));
+            }
+        }
 
-    for (unsigned idx = 0; idx < input_len; ++idx) {
-        // set output  = scramble(input), i.e. bit reversal ordering
-        for (unsigned i = rev[idx]; i < rev[idx] + group_len; ++i) {
-            memcpy(o_mem[i], i_mem[idx], buf_size);
+        // ----------------------
+        // Two layers at a time
+        // ----------------------
+        unsigned m = group_len;
+        const unsigned end = len / 2;
+        for (; m < end; m <<= 2) {
+            for (unsigned j = 0; j < m; ++j) {
+                butterfly_ct_radix4_step(tile, j, m);
+            }
         }
-    }
-    for (unsigned idx = input_len; idx < data_len; ++idx) {
-        // set output  = scramble(input), i.e. bit reversal ordering
-        for (unsigned i = rev[idx]; i < rev[idx] + group_len; ++i) {
-            memset(o_mem[i], 0, buf_size);
+        if (m < len) {
+            assert(m == end);
+            // perform the last butterfly operations
+            for (unsigned j = 0; j < m; ++j) {
+                const T r = W->get(j);
+                butterfly_ct_step(tile, r, j, m, len);
+            }
         }
     }
+}
 
-    // ----------------------
-    // Two layers at a time
-    // ----------------------
-    unsigned m = group_len;
-    const unsigned end = len / 2;
-    for (; m < end; m <<= 2) {
-        for (unsigned j = 0; j < m; ++j) {
-            butterfly_ct_two_layers_step(output, j, m);
+/** Check whether an element of the butterfly network is needed
+ *
+ * After the layer of groups of size `modulus`, the element `i` only
+ * contributes to the outputs `o` such that `o = i mod modulus`.
+ *
+ * @param wanted - flags of wanted outputs, missing entries are not wanted
+ * @param residue - index of the element modulo `modulus`
+ * @param modulus - size of the groups of the layer
+ * @return true if one of the outputs congruent to `residue` is wanted
+ */
+template <typename T>
+bool Radix2<T>::is_needed(
+    const std::vector<bool>& wanted,
+    unsigned residue,
+    unsigned modulus) const
+{
+    const size_t end = std::min<size_t>(this->n, wanted.size());
+    for (size_t o = residue; o < end; o += modulus) {
+        if (wanted[o]) {
+            return true;
         }
     }
-    if (m < len) {
-        assert(m == end);
-        // perform the last butterfly operations
-        for (unsigned j = 0; j < m; ++j) {
-            const T r = W->get(j);
-            butterfly_ct_step(output, r, j, m, len);
+    return false;
+}
+
+/** Perform decimation-in-time FFT computing only some outputs
+ *
+ * Walking the butterfly network backward from the wanted outputs gives the
+ * elements needed at each layer: the butterflies of the `j`-th group of a
+ * layer of half size `m` are performed only if an output `o = j mod m` is
+ * wanted. As needed elements only depend on `wanted` and on their residue,
+ * they are checked on the fly and nothing is allocated. For a single wanted
+ * output, it leads to a O(N) complexity.
+ *
+ * @param output - output buffers, the ones not wanted are left unspecified
+ * @param input - input buffers
+ * @param wanted - flags of wanted outputs, missing entries are not wanted
+ */
+template <typename T>
+void Radix2<T>::fft_pruned(
+    vec::Buffers<T>& output,
+    vec::Buffers<T>& input,
+    const std::vector<bool>& wanted)
+{
+    const unsigned len = this->n;
+    const unsigned input_len = input.get_n();
+    // to support FFT on input vectors of length greater than from `data_len`
+    const unsigned group_len =
+        (input_len > data_len) ? len / input_len : len / data_len;
+
+    const std::vector<T*>& i_mem = input.get_mem();
+    const std::vector<T*>& o_mem = output.get_mem();
+    const size_t pkt_size = output.get_size();
+    const size_t tile_len = get_tile_len<T>(len, pkt_size);
+    const size_t n_tiles = tile_len ? (pkt_size + tile_len - 1) / tile_len : 0;
+    vec::Buffers<T> tile(len, tile_len, o_mem);
+
+    const unsigned scrambled_len = std::max(input_len, data_len);
+    for (size_t t = 0; t < n_tiles; ++t) {
+        const size_t offset = t * tile_len;
+        const size_t size = std::min(tile_len, pkt_size - offset);
+        tile.set_view(o_mem, offset, size);
+
+        // set output  = scramble(input), i.e. bit reversal ordering, where
+        // `rev[idx]` is a multiple of `group_len`
+        for (unsigned res = 0; res < group_len; ++res) {
+            if (!is_needed(wanted, res, group_len)) {
+                continue;
+            }
+            for (unsigned idx = 0; idx < scrambled_len; ++idx) {
+                const unsigned i = rev[idx] + res;
+                if (idx < input_len) {
+                    memcpy(tile.get(i), i_mem[idx] + offset, size * sizeof(T));
+                } else {
+                    memset(tile.get(i), 0, size * sizeof(T));
+                }
+            }
+        }
+
+        // perform the needed butterfly operations, one layer at a time
+        for (unsigned m = group_len; m < len; m *= 2) {
+            const unsigned doubled_m = 2 * m;
+            const unsigned ratio = len / doubled_m;
+            for (unsigned j = 0; j < m; ++j) {
+                if (is_needed(wanted, j, m)) {
+                    const T r = W->get(j * ratio);
+                    butterfly_ct_step(tile, r, j, m, doubled_m);
+                }
+            }
         }
     }
 }
@@ -409,7 +530,7 @@ void Radix2<T>::butterfly_ct_step(
 }
 
 /**
- * Butterfly CT on two-layers at a time
+ * Radix-4 butterfly CT, i.e. two layers at a time
  *
  * For each quadruple
  * (P, Q, R, S) = (buf[i], buf[i + m], buf[i + 2 * m], buf[i + 3 * m])
@@ -421,50 +542,64 @@ void Radix2<T>::butterfly_ct_step(
  *      S = R - r1 * S
  * Second layer: butterfly on (P, R) and (Q, S) for step = 4 * m
  *      coef r2 = W[start * n / (4 * m)]
- *      coef r3 = W[(start + m) * n / (4 * m)]
+ *      coef r3 = W[(start + m) * n / (4 * m)] = j * r2, with j = W[n / 4]
  *      P = P + r2 * R
  *      R = P - r2 * R
  *      Q = Q + r3 * S
  *      S = Q - r3 * S
  *
+ * Both layers are computed at once from r1 * Q, r2 * R and r1 * r2 * S, then
+ * a multiplication by the 4th root of unity `j`, which is a shift for Fermat
+ * numbers in vectorized versions.
+ *
  * @param buf - working buffers
  * @param start - index of buffer among `m` ones
  * @param m - current group size
  */
 template <typename T>
-void Radix2<T>::butterfly_ct_two_layers_step(
+void Radix2<T>::butterfly_ct_radix4_step(
     vec::Buffers<T>& buf,
     unsigned start,
     unsigned m)
 {
-    butterfly_ct_two_layers_step_slow(buf, start, m);
+    butterfly_ct_radix4_step_slow(buf, start, m);
 }
 
 template <typename T>
-void Radix2<T>::butterfly_ct_two_layers_step_slow(
+void Radix2<T>::butterfly_ct_radix4_step_slow(
     vec::Buffers<T>& buf,
     unsigned start,
     unsigned m,
     size_t offset)
 {
     const unsigned step = m << 2;
-    //  ---------
-    // First layer
-    //  ---------
-    const T r1 = W->get(start * this->n / m / 2);
-    // first pair
-    butterfly_ct_step_slow(buf, r1, start, m, step, offset);
-    // second pair
-    butterfly_ct_step_slow(buf, r1, start + 2 * m, m, step, offset);
-    //  ---------
-    // Second layer
-    //  ---------
-    // first pair
-    const T r2 = W->get(start * this->n / m / 4);
-    butterfly_ct_step_slow(buf, r2, start, 2 * m, step, offset);
-    // second pair
-    const T r3 = W->get((start + m) * this->n / m / 4);
-    butterfly_ct_step_slow(buf, r3, start + m, 2 * m, step, offset);
+    const unsigned coef_index = start * (this->n / m / 4);
+    const T r1 = W->get(2 * coef_index);
+    const T r2 = W->get(coef_index);
+    const T r3 = W->get(3 * coef_index);
+    const T j = W->get(this->n / 4);
+
+    for (int i = start; i < this->n; i += step) {
+        T* p = buf.get(i);
+        T* q = buf.get(i + m);
+        T* r = buf.get(i + 2 * m);
+        T* s = buf.get(i + 3 * m);
+        for (size_t u = offset; u < buf.get_size(); ++u) {
+            const T b = this->gf->mul(r1, q[u]);
+            const T c = this->gf->mul(r2, r[u]);
+            const T d = this->gf->mul(r3, s[u]);
+
+            const T s0 = this->gf->add(p[u], b);
+            const T s1 = this->gf->sub(p[u], b);
+            const T s2 = this->gf->add(c, d);
+            const T s3 = this->gf->mul(j, this->gf->sub(c, d));
+
+            p[u] = this->gf->add(s0, s2);
+            r[u] = this->gf->sub(s0, s2);
+            q[u] = this->gf->add(s1, s3);
+            s[u] = this->gf->sub(s1, s3);
+        }
+    }
 }
 
 template <typename T>
@@ -480,7 +615,7 @@ void Radix2<T>::butterfly_ct_step_slow(
         T* a = buf.get(i);
         T* b = buf.get(i + m);
         // perform butterfly operation for Cooley-Tukey FFT algorithm
-        for (size_t j = offset; j < this->pkt_size; ++j) {
+        for (size_t j = offset; j < buf.get_size(); ++j) {
             T x = this->gf->mul(coef, b[j]);
             b[j] = this->gf->sub(a[j], x);
             a[j] = this->gf->add(a[j], x);
@@ -502,6 +637,24 @@ void Radix2<T>::butterfly_ct_step_slow(
  */
 template <typename T>
 void Radix2<T>::fft_inv(vec::Buffers<T>& output, vec::Buffers<T>& input)
+{
+    fft_inv(output, input, false);
+}
+
+/** Perform decimation-in-frequency FFT, tile by tile
+ *
+ * @see fft(vec::Buffers<T>&, vec::Buffers<T>&) for the tiling.
+ *
+ * @param output - output buffers
+ * @param input - input buffers
+ * @param normalize - whether output is divided by `n`, while the tile is still
+ * in cache
+ */
+template <typename T>
+void Radix2<T>::fft_inv(
+    vec::Buffers<T>& output,
+    vec::Buffers<T>& input,
+    bool normalize)
 {
     const unsigned len = this->n;
     const unsigned input_len = input.get_n();
@@ -509,38 +662,55 @@ void Radix2<T>::fft_inv(vec::Buffers<T>& output, vec::Buffers<T>& input)
     // 1st reversion of elements of output
     bit_rev_permute(output);
 
-    // copy input to output
     const std::vector<T*>& i_mem = input.get_mem();
     const std::vector<T*>& o_mem = output.get_mem();
-    unsigned i;
-    for (i = 0; i < input_len; ++i) {
-        memcpy(o_mem[i], i_mem[i], buf_size);
-    }
+    const size_t pkt_size = output.get_size();
+    const size_t tile_len = get_tile_len<T>(len, pkt_size);
+    const size_t n_tiles = tile_len ? (pkt_size + tile_len - 1) / tile_len : 0;
+    vec::Buffers<T> tile(len, tile_len, o_mem);
+
+    for (size_t t = 0; t < n_tiles; ++t) {
+        const size_t offset = t * tile_len;
+        const size_t size = std::min(tile_len, pkt_size - offset);
+        tile.set_view(o_mem, offset, size);
+
+        // copy input to output
+        unsigned i;
+        for (i = 0; i < input_len; ++i) {
+            memcpy(tile.get(i), i_mem[i] + offset, size * sizeof(T));
+        }
 
-    unsigned m = len / 2;
+        unsigned m = len / 2;
+
+        if (input_len < len) {
+            const unsigned input_len_power_2 =
+                arith::ceil2<unsigned>(input_len);
+            for (; i < input_len_power_2; ++i) {
+                memset(tile.get(i), 0, size * sizeof(T));
+            }
 
-    if (input_len < len) {
-        const unsigned input_len_power_2 = arith::ceil2<unsigned>(input_len);
-        for (; i < input_len_power_2; ++i) {
-            memset(o_mem[i], 0, buf_size);
+            // For Q are zeros only => Q = c * P
+            for (; m >= input_len; m /= 2) {
+                unsigned doubled_m = 2 * m;
+                for (unsigned j = 0; j < m; ++j) {
+                    const T r = inv_W->get(j * len / doubled_m);
+                    butterfly_gs_step_simple(tile, r, j, m, doubled_m);
+                }
+            }
         }
 
-        // For Q are zeros only => Q = c * P
-        for (; m >= input_len; m /= 2) {
+        // Next, normal butterlfy GS is performed
+        for (; m >= 1; m /= 2) {
             unsigned doubled_m = 2 * m;
             for (unsigned j = 0; j < m; ++j) {
                 const T r = inv_W->get(j * len / doubled_m);
-                butterfly_gs_step_simple(output, r, j, m, doubled_m);
+                butterfly_gs_step(tile, r, j, m, doubled_m);
             }
         }
-    }
 
-    // Next, normal butterlfy GS is performed
-    for (; m >= 1; m /= 2) {
-        unsigned doubled_m = 2 * m;
-        for (unsigned j = 0; j < m; ++j) {
-            const T r = inv_W->get(j * len / doubled_m);
-            butterfly_gs_step(output, r, j, m, doubled_m);
+        if (normalize) {
+            // We need to divide output to `N` for the inverse formular
+            this->gf->mul_vec_to_vecp(*(this->vec_inv_n), tile, tile);
         }
     }
 
@@ -588,7 +758,7 @@ void Radix2<T>::butterfly_gs_step_slow(
         T* a = buf.get(i);
         T* b = buf.get(i + m);
         // perform butterfly operation for Cooley-Tukey FFT algorithm
-        for (size_t j = offset; j < this->pkt_size; ++j) {
+        for (size_t j = offset; j < buf.get_size(); ++j) {
             T x = this->gf->sub(a[j], b[j]);
             a[j] = this->gf->add(a[j], b[j]);
             b[j] = this->gf->mul(coef, x);
@@ -609,7 +779,7 @@ void Radix2<T>::butterfly_gs_step_simple_slow(
         T* a = buf.get(i);
         T* b = buf.get(i + m);
         // perform butterfly operation for Cooley-Tukey FFT algorithm
-        for (size_t j = offset; j < this->pkt_size; ++j) {
+        for (size_t j = offset; j < buf.get_size(); ++j) {
             b[j] = this->gf->mul(coef, a[j]);
         }
     }
@@ -618,19 +788,14 @@ void Radix2<T>::butterfly_gs_step_simple_slow(
 template <typename T>
 void Radix2<T>::ifft(vec::Buffers<T>& output, vec::Buffers<T>& input)
 {
-    fft_inv(output, input);
-
-    /*
-     * We need to divide output to `N` for the inverse formular
-     */
-    this->gf->mul_vec_to_vecp(*(this->vec_inv_n), output, output);
+    fft_inv(output, input, true);
 }
 
 #ifdef QUADIRON_USE_SIMD
 
 /* Operations are vectorized by SIMD */
 template <>
-void Radix2<uint16_t>::butterfly_ct_two_layers_step(
+void Radix2<uint16_t>::butterfly_ct_radix4_step(
     vec::Buffers<uint16_t>& buf,
     unsigned start,
     unsigned m);
@@ -657,7 +822,7 @@ void Radix2<uint16_t>::butterfly_gs_step_simple(
     unsigned step);
 
 template <>
-void Radix2<uint32_t>::butterfly_ct_two_layers_step(
+void Radix2<uint32_t>::butterfly_ct_radix4_step(
     vec::Buffers<uint32_t>& buf,
     unsigned start,
     unsigned m);
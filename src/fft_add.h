@@ -31,7 +31,13 @@
 #ifndef __QUAD_FFT_ADD_H__
 #define __QUAD_FFT_ADD_H__
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
 #include "arith.h"
+#include "fft_2n.h"
 #include "fft_base.h"
 #include "gf_base.h"
 #include "vec_slice.h"
@@ -45,6 +51,9 @@ namespace fft {
  * It works on length of 2<sup>m</sup> for arbitrary `m`.
  *
  * This is an implementation of the algorithm 2 in @cite fft-add.
+ *
+ * Buffers are transformed packet-wise: each Taylor expansion and butterfly
+ * step XORs whole packets or multiplies them by a constant.
  */
 template <typename T>
 class Additive : public FourierTransform<T> {
@@ -63,6 +72,9 @@ class Additive : public FourierTransform<T> {
     void fft(vec::Vector<T>& output, vec::Vector<T>& input) override;
     void ifft(vec::Vector<T>& output, vec::Vector<T>& input) override;
     void fft_inv(vec::Vector<T>& output, vec::Vector<T>& input) override;
+    void fft(vec::Buffers<T>& output, vec::Buffers<T>& input) override;
+    void ifft(vec::Buffers<T>& output, vec::Buffers<T>& input) override;
+    void fft_inv(vec::Buffers<T>& output, vec::Buffers<T>& input) override;
     void taylor_expand_t2(vec::Vector<T>& input, int n, bool do_copy = false);
     void
     taylor_expand(vec::Vector<T>& output, vec::Vector<T>& input, int n, int t);
@@ -77,6 +89,12 @@ class Additive : public FourierTransform<T> {
     void mul_xt_x(vec::Vector<T>& vec, int t);
     void _fft(vec::Vector<T>& output, vec::Vector<T>& input);
     void _ifft(vec::Vector<T>& output, vec::Vector<T>& input);
+    void mul_add_buf(T coef, T* src, T* dest, T* tmp, size_t len);
+    void _taylor_expand_t2(vec::Buffers<T>& buf, unsigned start, unsigned len);
+    void
+    _inv_taylor_expand_t2(vec::Buffers<T>& buf, unsigned start, unsigned len);
+    void _fft(vec::Buffers<T>& buf, T* tmp);
+    void _ifft(vec::Buffers<T>& buf, T* tmp);
 
     bool create_betas;
     T m;
@@ -94,6 +112,7 @@ class Additive : public FourierTransform<T> {
     vec::Vector<T>* v = nullptr;
     vec::Vector<T>* mem = nullptr;
     Additive<T>* fft_add = nullptr;
+    std::unique_ptr<T[]> rev = nullptr;
 };
 
 template <typename T>
@@ -124,6 +143,11 @@ Additive<T>::Additive(const gf::Field<T>& gf, T m, vec::Vector<T>* betas)
 
     this->beta_m_powers = new vec::Vector<T>(gf, this->n);
     this->compute_beta_m_powers();
+
+    rev = std::unique_ptr<T[]>(new T[this->n]);
+    for (int i = 0; i < this->n; ++i) {
+        rev[i] = reverse_bitwise(i, this->n, m);
+    }
     if (m > 1) {
         this->m_k = arith::exp2<T>(m - 1);
 
@@ -550,8 +574,8 @@ inline int Additive<T>::find_k(int n, int t)
 {
     int k;
     int t2k = t; // init for t*2^k with k = 0
-    for (k = 0; k < n; k++) {
-        if (t2k < n && 2 * t2k >= n)
+    for (k = 0; k < n && t2k < n; k++) {
+        if (2 * t2k >= n)
             return k;
         // next t2k
         t2k *= 2;
@@ -654,6 +678,269 @@ void Additive<T>::inv_taylor_expand(
     }
 }
 
+/** Add `coef * src` to `dest`, using `tmp` as scratch */
+template <typename T>
+inline void
+Additive<T>::mul_add_buf(T coef, T* src, T* dest, T* tmp, size_t len)
+{
+    if (coef == 0) {
+        return;
+    }
+    if (coef == 1) {
+        this->gf->add_two_bufs(src, dest, len);
+    } else {
+        this->gf->mul_coef_to_buf(coef, src, tmp, len);
+        this->gf->add_two_bufs(tmp, dest, len);
+    }
+}
+
+/** Compute the additive FFT of buffers.
+ *
+ * Buffers are processed tile by tile, each one being transformed in place
+ * into the output buffers. As even and odd halves of the Taylor expansion are
+ * transformed where they lie, outputs come out in bit-reversed order: tiles of
+ * the output buffers are hence visited in bit-reversed order.
+ *
+ * @param output n buffers
+ * @param input at most n buffers, missing ones are zeros
+ */
+template <typename T>
+void Additive<T>::fft(vec::Buffers<T>& output, vec::Buffers<T>& input)
+{
+    const unsigned len = this->n;
+    const unsigned input_len = input.get_n();
+    assert(input_len <= len);
+
+    const size_t pkt_size = output.get_size();
+    const size_t tile_len = get_tile_len<T>(len, pkt_size);
+    const std::vector<T*>& i_mem = input.get_mem();
+    const std::vector<T*>& o_mem = output.get_mem();
+    std::vector<T*> tile_mem(len);
+    vec::Buffers<T> tmp(1, tile_len);
+
+    for (size_t offset = 0; offset < pkt_size; offset += tile_len) {
+        const size_t size = std::min(tile_len, pkt_size - offset);
+        for (unsigned i = 0; i < len; ++i) {
+            tile_mem[i] = o_mem[rev[i]] + offset;
+        }
+        for (unsigned i = 0; i < input_len; ++i) {
+            memcpy(tile_mem[i], i_mem[i] + offset, size * sizeof(T));
+        }
+        for (unsigned i = input_len; i < len; ++i) {
+            memset(tile_mem[i], 0, size * sizeof(T));
+        }
+        vec::Buffers<T> tile(len, size, tile_mem);
+        _fft(tile, tmp.get(0));
+    }
+}
+
+template <typename T>
+void Additive<T>::ifft(vec::Buffers<T>& output, vec::Buffers<T>& input)
+{
+    fft_inv(output, input);
+}
+
+/** Compute the inverse additive FFT of buffers.
+ *
+ * Inputs are loaded in bit-reversed order, so that the polynomial comes out
+ * in natural order.
+ *
+ * @param output n buffers
+ * @param input at most n buffers, missing ones are zeros
+ */
+template <typename T>
+void Additive<T>::fft_inv(vec::Buffers<T>& output, vec::Buffers<T>& input)
+{
+    const unsigned len = this->n;
+    const unsigned input_len = input.get_n();
+    assert(input_len <= len);
+
+    const size_t pkt_size = output.get_size();
+    const size_t tile_len = get_tile_len<T>(len, pkt_size);
+    const std::vector<T*>& i_mem = input.get_mem();
+    const std::vector<T*>& o_mem = output.get_mem();
+    std::vector<T*> tile_mem(len);
+    vec::Buffers<T> tmp(1, tile_len);
+
+    for (size_t offset = 0; offset < pkt_size; offset += tile_len) {
+        const size_t size = std::min(tile_len, pkt_size - offset);
+        for (unsigned i = 0; i < len; ++i) {
+            tile_mem[i] = o_mem[i] + offset;
+        }
+        for (unsigned i = 0; i < input_len; ++i) {
+            memcpy(tile_mem[rev[i]], i_mem[i] + offset, size * sizeof(T));
+        }
+        for (unsigned i = input_len; i < len; ++i) {
+            memset(tile_mem[rev[i]], 0, size * sizeof(T));
+        }
+        vec::Buffers<T> tile(len, size, tile_mem);
+        _ifft(tile, tmp.get(0));
+    }
+}
+
+/** Compute in place the additive FFT of a tile
+ *
+ * The i-th output is stored in `buf[rev[i]]`. As the sub-FFTs store theirs
+ * in the same way, u_i and v_i lie at `rev[i]` and `rev[i + k]`, i.e. where
+ * w_i and w_{k+i} go.
+ *
+ * @param buf n buffers of the polynomial, overwritten by its evaluations
+ * @param tmp scratch of the size of buffers
+ */
+template <typename T>
+void Additive<T>::_fft(vec::Buffers<T>& buf, T* tmp)
+{
+    const size_t size = buf.get_size();
+    const std::vector<T*>& mem = buf.get_mem();
+
+    if (m == 1) {
+        // (f(0), f(beta_1)) = (f0, f0 + beta_1 * f1)
+        this->gf->mul_coef_to_buf(beta_1, mem[1], mem[1], size);
+        this->gf->add_two_bufs(mem[0], mem[1], size);
+        return;
+    }
+
+    if (beta_m > 1) {
+        for (int i = 1; i < this->n; ++i) {
+            this->gf->mul_coef_to_buf(
+                beta_m_powers->get(i), mem[i], mem[i], size);
+        }
+    }
+
+    // g0 and g1 are interleaved by the Taylor expansion
+    _taylor_expand_t2(buf, 0, this->n);
+
+    std::vector<T*> g0_mem(m_k);
+    std::vector<T*> g1_mem(m_k);
+    for (unsigned i = 0; i < m_k; ++i) {
+        g0_mem[i] = mem[2 * i];
+        g1_mem[i] = mem[2 * i + 1];
+    }
+    vec::Buffers<T> _g0(m_k, size, g0_mem);
+    vec::Buffers<T> _g1(m_k, size, g1_mem);
+    fft_add->_fft(_g0, tmp);
+    fft_add->_fft(_g1, tmp);
+
+    // (u_i, v_i) -> (u_i + G[i] * v_i, u_i + G[i] * v_i + v_i)
+    for (unsigned i = 0; i < m_k; ++i) {
+        T* _u = mem[rev[i]];
+        T* _v = mem[rev[i + m_k]];
+        mul_add_buf(G->get(i), _v, _u, tmp, size);
+        this->gf->add_two_bufs(_u, _v, size);
+    }
+}
+
+/** Compute in place the inverse additive FFT of a tile
+ *
+ * It reverts `_fft(vec::Buffers<T>&, T*)` step by step.
+ *
+ * @param buf n buffers of evaluations in bit-reversed order, overwritten by
+ * the polynomial
+ * @param tmp scratch of the size of buffers
+ */
+template <typename T>
+void Additive<T>::_ifft(vec::Buffers<T>& buf, T* tmp)
+{
+    const size_t size = buf.get_size();
+    const std::vector<T*>& mem = buf.get_mem();
+
+    if (m == 1) {
+        // (w0, w1) -> (w0, (w0 + w1) * beta_1^-1)
+        this->gf->add_two_bufs(mem[0], mem[1], size);
+        this->gf->mul_coef_to_buf(inv_beta_1, mem[1], mem[1], size);
+        return;
+    }
+
+    // (w_i, w_{k+i}) -> (w_i + G[i] * v_i, v_i) where v_i = w_i + w_{k+i}
+    for (unsigned i = 0; i < m_k; ++i) {
+        T* _u = mem[rev[i]];
+        T* _v = mem[rev[i + m_k]];
+        this->gf->add_two_bufs(_u, _v, size);
+        mul_add_buf(G->get(i), _v, _u, tmp, size);
+    }
+
+    std::vector<T*> g0_mem(m_k);
+    std::vector<T*> g1_mem(m_k);
+    for (unsigned i = 0; i < m_k; ++i) {
+        g0_mem[i] = mem[2 * i];
+        g1_mem[i] = mem[2 * i + 1];
+    }
+    vec::Buffers<T> _g0(m_k, size, g0_mem);
+    vec::Buffers<T> _g1(m_k, size, g1_mem);
+    fft_add->_ifft(_g0, tmp);
+    fft_add->_ifft(_g1, tmp);
+
+    _inv_taylor_expand_t2(buf, 0, this->n);
+
+    if (beta_m > 1) {
+        T coef = inv_beta_m;
+        for (int i = 1; i < this->n; ++i) {
+            this->gf->mul_coef_to_buf(coef, mem[i], mem[i], size);
+            coef = this->gf->mul(coef, inv_beta_m);
+        }
+    }
+}
+
+/** Taylor expansion at (x^2 - x) of the polynomial held by buffers
+ *
+ * Same as `_taylor_expand_t2(vec::Vector<T>&, int, int, int)` on
+ * `buf[start .. start + len - 1]`, where `len` is a power of 2 at least 4.
+ * The i-th terms of g0 and g1 end up in `buf[start + 2i]` and
+ * `buf[start + 2i + 1]`.
+ */
+template <typename T>
+void Additive<T>::_taylor_expand_t2(
+    vec::Buffers<T>& buf,
+    unsigned start,
+    unsigned len)
+{
+    const size_t size = buf.get_size();
+    const std::vector<T*>& mem = buf.get_mem();
+    const unsigned deg2 = len / 4;
+    const unsigned deg0 = 2 * deg2;
+
+    // f = f0 + x^deg0 * (f1 + x^deg2 * f2): f1 += f2, then f0 += x^deg2 * f1
+    for (unsigned i = start + deg0; i < start + deg0 + deg2; ++i) {
+        this->gf->add_two_bufs(mem[i + deg2], mem[i], size);
+    }
+    for (unsigned i = start + deg2; i < start + deg0; ++i) {
+        this->gf->add_two_bufs(mem[i + deg2], mem[i], size);
+    }
+
+    if (deg0 > 2) {
+        _taylor_expand_t2(buf, start, deg0);
+        _taylor_expand_t2(buf, start + deg0, deg0);
+    }
+}
+
+/** Inverse of `_taylor_expand_t2(vec::Buffers<T>&, unsigned, unsigned)`
+ *
+ * Its steps being XORs, they are undone in reverse order.
+ */
+template <typename T>
+void Additive<T>::_inv_taylor_expand_t2(
+    vec::Buffers<T>& buf,
+    unsigned start,
+    unsigned len)
+{
+    const size_t size = buf.get_size();
+    const std::vector<T*>& mem = buf.get_mem();
+    const unsigned deg2 = len / 4;
+    const unsigned deg0 = 2 * deg2;
+
+    if (deg0 > 2) {
+        _inv_taylor_expand_t2(buf, start, deg0);
+        _inv_taylor_expand_t2(buf, start + deg0, deg0);
+    }
+
+    for (unsigned i = start + deg2; i < start + deg0; ++i) {
+        this->gf->add_two_bufs(mem[i + deg2], mem[i], size);
+    }
+    for (unsigned i = start + deg0; i < start + deg0 + deg2; ++i) {
+        this->gf->add_two_bufs(mem[i + deg2], mem[i], size);
+    }
+}
+
 } // namespace fft
 } // namespace quadiron
 
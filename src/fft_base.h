@@ -31,6 +31,9 @@
 #ifndef __QUAD_FFT_BASE_H__
 #define __QUAD_FFT_BASE_H__
 
+#include <algorithm>
+#include <vector>
+
 #include "gf_base.h"
 #include "vec_buffers.h"
 #include "vec_vector.h"
@@ -55,6 +58,19 @@ class FourierTransform {
     virtual void fft(vec::Vector<T>& output, vec::Vector<T>& input) = 0;
     virtual void
     fft(vec::Buffers<T>& /* output */, vec::Buffers<T>& /* input */){};
+    /** Compute only the wanted outputs of the Fourier Transform.
+     *
+     * Values of outputs that are not wanted are unspecified.
+     *
+     * @param wanted flags of wanted outputs, missing entries are not wanted
+     */
+    virtual void fft_pruned(
+        vec::Buffers<T>& output,
+        vec::Buffers<T>& input,
+        const std::vector<bool>& /* wanted */)
+    {
+        fft(output, input);
+    }
     /** Compute the Inverse Fourier Transform. */
     virtual void ifft(vec::Vector<T>& output, vec::Vector<T>& input) = 0;
     virtual void
@@ -110,6 +126,22 @@ const gf::Field<T>& FourierTransform<T>::get_gf()
     return *gf;
 }
 
+/** Number of symbols of the tiles of `n` packets of `pkt_size` symbols
+ *
+ * When `n` packets do not fit in cache, packet transforms are performed tile
+ * by tile: the `n` slices of a tile (128 KiB in total) stay in cache during
+ * the whole transform.
+ */
+template <typename T>
+inline size_t get_tile_len(unsigned n, size_t pkt_size)
+{
+    constexpr size_t tile_size = 128 * 1024;
+    // Tiles start on cache lines, which are also aligned for SIMD registers
+    const size_t quantum = std::max<size_t>(64, simd::ALIGNMENT) / sizeof(T);
+    const size_t len = tile_size / sizeof(T) / n / quantum * quantum;
+    return std::min(pkt_size, std::max(len, quantum));
+}
+
 } // namespace fft
 } // namespace quadiron
 
@@ -31,8 +31,12 @@
 #ifndef __QUAD_FFT_CT_H__
 #define __QUAD_FFT_CT_H__
 
+#include <algorithm>
+#include <vector>
+
 #include "arith.h"
 #include "fft_2.h"
+#include "fft_2n.h"
 #include "fft_base.h"
 #include "fft_naive.h"
 #include "gf_base.h"
@@ -81,6 +85,9 @@ namespace fft {
  * - Step1: calculate the inner DFT, i.e. \f$\sum_{i_2}\f$
  * - Step2: multiply to twiddle factors \f$w^{i_1 k_2}\f$
  * - Step3: calculate outer DFT, i.e. \f$\sum_{i_1}\f$
+ *
+ * On packets, the index mappings only select buffers and a twiddle factor
+ * multiplies a whole buffer, so that all steps are packet operations.
  */
 template <typename T>
 class CooleyTukey : public FourierTransform<T> {
@@ -99,9 +106,15 @@ class CooleyTukey : public FourierTransform<T> {
     void fft(vec::Vector<T>& output, vec::Vector<T>& input) override;
     void ifft(vec::Vector<T>& output, vec::Vector<T>& input) override;
     void fft_inv(vec::Vector<T>& output, vec::Vector<T>& input) override;
+    void fft(vec::Buffers<T>& output, vec::Buffers<T>& input) override;
+    void ifft(vec::Buffers<T>& output, vec::Buffers<T>& input) override;
+    void fft_inv(vec::Buffers<T>& output, vec::Buffers<T>& input) override;
 
   private:
     void _fft(vec::Vector<T>& output, vec::Vector<T>& input, bool inv);
+    void _fft(vec::Buffers<T>& output, vec::Buffers<T>& input, bool inv);
+    void
+    _fft_tiled(vec::Buffers<T>& output, vec::Buffers<T>& input, bool inv);
 
     bool loop;
     bool first_layer_fft;
@@ -115,6 +128,7 @@ class CooleyTukey : public FourierTransform<T> {
     FourierTransform<T>* dft_inner = nullptr;
     std::vector<T> prime_factors;
     void mul_twiddle_factors(bool inv);
+    void mul_twiddle_factors(vec::Buffers<T>& buf, bool inv);
 };
 
 /** Initialize the FFT.
@@ -143,7 +157,8 @@ CooleyTukey<T>::CooleyTukey(
         w = _w;
     }
     inv_w = gf.inv(w);
-    n1 = prime_factors[id];
+    // 1 has no prime factor: a transform of a single point is the identity
+    n1 = prime_factors.empty() ? 1 : prime_factors[id];
     n2 = n / n1;
 
     w1 = gf.exp(w, n2); // order of w1 = n1
@@ -157,12 +172,13 @@ CooleyTukey<T>::CooleyTukey(
         loop = true;
         w2 = gf.exp(w, n1); // order of w2 = n2
         T _n2 = n / n1;
-        // TODO: fix that fft::Radix2 does not work here
-        // if (_is_power_of_2<T>(_n2))
-        //   this->dft_inner = new fft::Radix2<T>(gf, _n2);
-        // else
-        this->dft_inner =
-            new CooleyTukey<T>(gf, _n2, id + 1, &this->prime_factors, w2);
+        if (arith::is_power_of_2<T>(_n2)) {
+            // the inner DFT must use `w2`, not its own n2-th root
+            this->dft_inner = new fft::Radix2<T>(gf, _n2, _n2, 0, w2);
+        } else {
+            this->dft_inner =
+                new CooleyTukey<T>(gf, _n2, id + 1, &this->prime_factors, w2);
+        }
         this->G = new vec::Vector<T>(gf, this->n);
         this->Y = new vec::View<T>(this->G);
         this->X = new vec::View<T>(this->G);
@@ -278,6 +294,160 @@ void CooleyTukey<T>::ifft(vec::Vector<T>& output, vec::Vector<T>& input)
     }
 }
 
+/** Multiply packets of the inner DFTs to twiddle factors
+ *
+ * @param buf - the `n` packets of the inner DFTs
+ * @param inv - whether twiddle factors of the inverse FFT are used
+ */
+template <typename T>
+void CooleyTukey<T>::mul_twiddle_factors(vec::Buffers<T>& buf, bool inv)
+{
+    const T _w = inv ? inv_w : w;
+    const size_t size = buf.get_size();
+    T base = 1;
+    for (T i1 = 1; i1 < n1; i1++) {
+        base = this->gf->mul(base, _w); // base = _w^i1
+        T factor = base;                // init factor = base^1
+        for (T k2 = 1; k2 < n2; k2++) {
+            T* mem = buf.get(i1 + n1 * k2);
+            this->gf->mul_coef_to_buf(factor, mem, mem, size);
+            // next factor = base^(k2+1)
+            factor = this->gf->mul(factor, base);
+        }
+    }
+}
+
+/** Perform the FFT on packets of `n` buffers
+ *
+ * Buffers of the index mappings are gathered in views, so that no packet is
+ * copied.
+ *
+ * @param output - output buffers, distinct from `input`
+ * @param input - input buffers
+ * @param inv - whether the inverse FFT formula is computed
+ */
+template <typename T>
+void CooleyTukey<T>::_fft(
+    vec::Buffers<T>& output,
+    vec::Buffers<T>& input,
+    bool inv)
+{
+    const size_t size = output.get_size();
+    vec::Buffers<T> g(this->n, size);
+    const std::vector<T*>& i_mem = input.get_mem();
+    const std::vector<T*>& o_mem = output.get_mem();
+    const std::vector<T*>& g_mem = g.get_mem();
+
+    std::vector<T*> x_mem(n2);
+    std::vector<T*> y_mem(n2);
+    for (T i1 = 0; i1 < n1; i1++) {
+        for (T i2 = 0; i2 < n2; i2++) {
+            x_mem[i2] = i_mem[i1 + n1 * i2];
+            y_mem[i2] = g_mem[i1 + n1 * i2];
+        }
+        vec::Buffers<T> x(n2, size, x_mem);
+        vec::Buffers<T> y(n2, size, y_mem);
+        if (inv)
+            this->dft_inner->fft_inv(y, x);
+        else
+            this->dft_inner->fft(y, x);
+    }
+
+    // multiply to twiddle factors
+    mul_twiddle_factors(g, inv);
+
+    x_mem.resize(n1);
+    y_mem.resize(n1);
+    for (T k2 = 0; k2 < n2; k2++) {
+        for (T k1 = 0; k1 < n1; k1++) {
+            y_mem[k1] = g_mem[k2 * n1 + k1];
+            x_mem[k1] = o_mem[k2 + n2 * k1];
+        }
+        vec::Buffers<T> y(n1, size, y_mem);
+        vec::Buffers<T> x(n1, size, x_mem);
+        if (inv)
+            this->dft_outer->fft_inv(x, y);
+        else
+            this->dft_outer->fft(x, y);
+    }
+}
+
+/** Perform the FFT on packets, tile by tile for the first layer
+ *
+ * Missing input buffers are considered as zero.
+ *
+ * @see get_tile_len()
+ *
+ * @param output - output buffers, distinct from `input`
+ * @param input - input buffers
+ * @param inv - whether the inverse FFT formula is computed
+ */
+template <typename T>
+void CooleyTukey<T>::_fft_tiled(
+    vec::Buffers<T>& output,
+    vec::Buffers<T>& input,
+    bool inv)
+{
+    const unsigned len = this->n;
+    if (static_cast<unsigned>(input.get_n()) < len) {
+        vec::Buffers<T> _input(input, 0, len);
+        _fft_tiled(output, _input, inv);
+        return;
+    }
+    if (!loop) {
+        if (inv)
+            dft_outer->fft_inv(output, input);
+        else
+            dft_outer->fft(output, input);
+        return;
+    }
+    if (!first_layer_fft) {
+        _fft(output, input, inv);
+        return;
+    }
+
+    const size_t pkt_size = output.get_size();
+    const size_t tile_len = get_tile_len<T>(len, pkt_size);
+    const std::vector<T*>& i_mem = input.get_mem();
+    const std::vector<T*>& o_mem = output.get_mem();
+    std::vector<T*> i_tile_mem(len);
+    std::vector<T*> o_tile_mem(len);
+
+    for (size_t offset = 0; offset < pkt_size; offset += tile_len) {
+        const size_t size = std::min(tile_len, pkt_size - offset);
+        for (unsigned i = 0; i < len; ++i) {
+            i_tile_mem[i] = i_mem[i] + offset;
+            o_tile_mem[i] = o_mem[i] + offset;
+        }
+        vec::Buffers<T> i_tile(len, size, i_tile_mem);
+        vec::Buffers<T> o_tile(len, size, o_tile_mem);
+        _fft(o_tile, i_tile, inv);
+    }
+}
+
+template <typename T>
+void CooleyTukey<T>::fft(vec::Buffers<T>& output, vec::Buffers<T>& input)
+{
+    _fft_tiled(output, input, false);
+}
+
+template <typename T>
+void CooleyTukey<T>::fft_inv(vec::Buffers<T>& output, vec::Buffers<T>& input)
+{
+    _fft_tiled(output, input, true);
+}
+
+template <typename T>
+void CooleyTukey<T>::ifft(vec::Buffers<T>& output, vec::Buffers<T>& input)
+{
+    fft_inv(output, input);
+
+    // We need to divide output to `N` for the inverse formular
+    if (this->first_layer_fft && (this->inv_n_mod_p > 1)) {
+        this->gf->mul_vec_to_vecp(*(this->vec_inv_n), output, output);
+    }
+}
+
 } // namespace fft
 } // namespace quadiron
 
@@ -31,6 +31,8 @@
 #ifndef __QUAD_FFT_GT_H__
 #define __QUAD_FFT_GT_H__
 
+#include <vector>
+
 #include "arith.h"
 #include "fft_2.h"
 #include "fft_2n.h"
@@ -93,6 +95,9 @@ namespace fft {
  * - Step1: calculate DFT of the inner parenthese, i.e. \f$\sum_{i_2}\f$
  * - Step2: calculate DFT of the outer parenthese, i.e. \f$\sum_{i_1}\f$
  *
+ * On packets, the CRT index mappings only select buffers, so that both steps
+ * are packet DFTs.
+ *
  * @see <a href="https://en.wikipedia.org/wiki/Prime-factor_FFT_algorithm">
  * Prime-factor FFT algorithm
  * </a>
@@ -114,9 +119,13 @@ class GoodThomas : public FourierTransform<T> {
     void fft(vec::Vector<T>& output, vec::Vector<T>& input) override;
     void ifft(vec::Vector<T>& output, vec::Vector<T>& input) override;
     void fft_inv(vec::Vector<T>& output, vec::Vector<T>& input) override;
+    void fft(vec::Buffers<T>& output, vec::Buffers<T>& input) override;
+    void ifft(vec::Buffers<T>& output, vec::Buffers<T>& input) override;
+    void fft_inv(vec::Buffers<T>& output, vec::Buffers<T>& input) override;
 
   private:
     void _fft(vec::Vector<T>& output, vec::Vector<T>& input, bool inv);
+    void _fft(vec::Buffers<T>& output, vec::Buffers<T>& input, bool inv);
     T _inverse_mod(T nb, T mod);
 
     bool loop;
@@ -157,7 +166,8 @@ GoodThomas<T>::GoodThomas(
         first_layer_fft = false;
         w = _w;
     }
-    n1 = prime_factors[id];
+    // 1 has no prime factor: a transform of a single point is the identity
+    n1 = prime_factors.empty() ? 1 : prime_factors[id];
     n2 = n / n1;
 
     a = n2;
@@ -177,7 +187,8 @@ GoodThomas<T>::GoodThomas(
         w2 = gf.exp(w, n1); // order of w2 = n2
         T _n2 = n / n1;
         if (arith::is_power_of_2<T>(_n2)) {
-            this->dft_inner = new fft::Radix2<T>(gf, _n2);
+            // the inner DFT must use `w2`, not its own n2-th root
+            this->dft_inner = new fft::Radix2<T>(gf, _n2, _n2, 0, w2);
         } else {
             this->dft_inner = new fft::CooleyTukey<T>(
                 gf, _n2, id + 1, &this->prime_factors, w2);
@@ -284,6 +295,94 @@ void GoodThomas<T>::ifft(vec::Vector<T>& output, vec::Vector<T>& input)
     }
 }
 
+/** Perform the FFT on packets of `n` buffers
+ *
+ * Buffers of the index mappings are gathered in views, so that no packet is
+ * copied. Missing input buffers are considered as zero.
+ *
+ * @param output - output buffers, distinct from `input`
+ * @param input - input buffers
+ * @param inv - whether the inverse FFT formula is computed
+ */
+template <typename T>
+void GoodThomas<T>::_fft(
+    vec::Buffers<T>& output,
+    vec::Buffers<T>& input,
+    bool inv)
+{
+    if (input.get_n() < this->n) {
+        vec::Buffers<T> _input(input, 0, this->n);
+        _fft(output, _input, inv);
+        return;
+    }
+    if (!loop) {
+        if (inv)
+            dft_outer->fft_inv(output, input);
+        else
+            dft_outer->fft(output, input);
+        return;
+    }
+
+    const size_t size = output.get_size();
+    vec::Buffers<T> g(this->n, size);
+    const std::vector<T*>& i_mem = input.get_mem();
+    const std::vector<T*>& o_mem = output.get_mem();
+    const std::vector<T*>& g_mem = g.get_mem();
+
+    std::vector<T*> x_mem(n2);
+    std::vector<T*> y_mem(n2);
+    for (T i1 = 0; i1 < n1; i1++) {
+        for (T i2 = 0; i2 < n2; i2++) {
+            x_mem[i2] = i_mem[(a * i1 + b * i2) % this->n];
+            y_mem[i2] = g_mem[i1 + n1 * i2];
+        }
+        vec::Buffers<T> x(n2, size, x_mem);
+        vec::Buffers<T> y(n2, size, y_mem);
+        if (inv)
+            this->dft_inner->fft_inv(y, x);
+        else
+            this->dft_inner->fft(y, x);
+    }
+
+    x_mem.resize(n1);
+    y_mem.resize(n1);
+    for (T k2 = 0; k2 < n2; k2++) {
+        for (T k1 = 0; k1 < n1; k1++) {
+            y_mem[k1] = g_mem[k2 * n1 + k1];
+            x_mem[k1] = o_mem[(d * k2 + c * k1) % this->n];
+        }
+        vec::Buffers<T> y(n1, size, y_mem);
+        vec::Buffers<T> x(n1, size, x_mem);
+        if (inv)
+            this->dft_outer->fft_inv(x, y);
+        else
+            this->dft_outer->fft(x, y);
+    }
+}
+
+template <typename T>
+void GoodThomas<T>::fft(vec::Buffers<T>& output, vec::Buffers<T>& input)
+{
+    _fft(output, input, false);
+}
+
+template <typename T>
+void GoodThomas<T>::fft_inv(vec::Buffers<T>& output, vec::Buffers<T>& input)
+{
+    _fft(output, input, true);
+}
+
+template <typename T>
+void GoodThomas<T>::ifft(vec::Buffers<T>& output, vec::Buffers<T>& input)
+{
+    fft_inv(output, input);
+
+    // We need to divide output to `N` for the inverse formular
+    if (this->first_layer_fft && (this->inv_n_mod_p > 1)) {
+        this->gf->mul_vec_to_vecp(*(this->vec_inv_n), output, output);
+    }
+}
+
 } // namespace fft
 } // namespace quadiron
 
@@ -60,7 +60,6 @@ class Naive : public FourierTransform<T> {
   private:
     T w;
     T inv_w;
-    size_t pkt_size;
     vec::Matrix<T>* W;
     vec::Matrix<T>* inv_W;
     void compute_W(vec::Matrix<T>* _W, T _w);
@@ -71,14 +70,13 @@ class Naive : public FourierTransform<T> {
 };
 
 template <typename T>
-Naive<T>::Naive(const gf::Field<T>& gf, int n, T w, size_t pkt_size)
+Naive<T>::Naive(const gf::Field<T>& gf, int n, T w, size_t /* pkt_size */)
     : FourierTransform<T>(gf, n)
 {
     this->w = w;
     this->inv_w = gf.inv(w);
     this->W = new vec::Matrix<T>(gf, this->n, this->n);
     this->inv_W = new vec::Matrix<T>(gf, this->n, this->n);
-    this->pkt_size = pkt_size;
 
     compute_W(W, w);
     compute_W(inv_W, this->inv_w);
@@ -142,25 +140,15 @@ void Naive<T>::ifft(vec::Vector<T>& output, vec::Vector<T>& input)
         output.mul_scalar(this->inv_n_mod_p);
 }
 
+/* Packets are multiplied chunk by chunk, so that the size of the buffers is
+ * used, which allows to transform tiles of packets */
 template <typename T>
 void Naive<T>::_fft(
     vec::Buffers<T>& output,
     vec::Buffers<T>& input,
     vec::Matrix<T>* _W)
 {
-    const unsigned len = this->n;
-    const unsigned size = this->pkt_size;
-    for (unsigned i = 0; i < len; ++i) {
-        output.fill(i, 0);
-        T* buf = output.get(i);
-        for (unsigned j = 0; j < len; ++j) {
-            T* ibuf = input.get(j);
-            T r = _W->get(i, j);
-            for (unsigned u = 0; u < size; ++u) {
-                buf[u] = this->gf->add(buf[u], this->gf->mul(r, ibuf[u]));
-            }
-        }
-    }
+    _W->mul(&output, &input);
 }
 
 /** Perform decimation-in-time FFT
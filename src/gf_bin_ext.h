@@ -31,11 +31,18 @@
 #ifndef __QUAD_GF_BIN_EXT_H__
 #define __QUAD_GF_BIN_EXT_H__
 
+#include <algorithm>
 #include <limits>
 
 #include "exceptions.h"
 #include "gf_base.h"
 
+#ifdef QUADIRON_USE_SIMD
+
+#include "simd.h"
+
+#endif // #ifdef QUADIRON_USE_SIMD
+
 namespace quadiron {
 namespace gf {
 
@@ -43,6 +50,8 @@ namespace gf {
 template <typename T>
 class BinExtension : public gf::Field<T> {
   public:
+    using gf::Field<T>::neg;
+
     ~BinExtension();
     void find_primitive_root();
     T card(void) const override;
@@ -56,6 +65,14 @@ class BinExtension : public gf::Field<T> {
     T exp(T a, T b) const override;
     T log(T a, T b) const override;
     void hadamard_mul(int n, T* x, T* y) const override;
+    void mul_coef_to_buf(T a, T* src, T* dest, size_t len) const override;
+    void mul_vec_to_vecp(
+        vec::Vector<T>& u,
+        vec::Buffers<T>& src,
+        vec::Buffers<T>& dest) const override;
+    void add_two_bufs(T* src, T* dest, size_t len) const override;
+    void sub_two_bufs(T* bufa, T* bufb, T* res, size_t len) const override;
+    void neg(size_t n, T* x) const override;
 
     BinExtension(BinExtension&&) = default;
 
@@ -89,6 +106,9 @@ class BinExtension : public gf::Field<T> {
     void init_mask();
     void setup_tables();
     void setup_split_tables();
+#ifdef QUADIRON_USE_SIMD
+    void setup_nibble_tables(T a, uint8_t* tables) const;
+#endif
 
     template <typename Class, typename... Args>
     friend Class create(Args... args);
@@ -590,6 +610,128 @@ inline void BinExtension<T>::hadamard_mul(int n, T* x, T* y) const
     }
 }
 
+#ifdef QUADIRON_USE_SIMD
+
+/** Compute the multiplication tables of `a` used by the SIMD kernels
+ *
+ * For GF(2^8) and GF(2^16), the products of `a` by the 16 values of each
+ * nibble of an element are split into bytes: the table of the k-th nibble and
+ * of the byte b starts at `(k * n / 8 + b) * 16`. As the multiplication is
+ * linear, each table is built from the products by 1, 2, 4 and 8.
+ */
+template <typename T>
+void BinExtension<T>::setup_nibble_tables(T a, uint8_t* tables) const
+{
+    const unsigned bytes_nb = n / 8;
+    T prod[16];
+
+    for (unsigned k = 0; k < n / 4; ++k) {
+        prod[0] = 0;
+        for (unsigned i = 1; i < 16; ++i) {
+            const unsigned low_bit = i & (~i + 1);
+            if (i == low_bit) {
+                prod[i] = mul(a, static_cast<T>(i) << (4 * k));
+            } else {
+                prod[i] = prod[low_bit] ^ prod[i ^ low_bit];
+            }
+        }
+        for (unsigned b = 0; b < bytes_nb; ++b) {
+            uint8_t* table = tables + (k * bytes_nb + b) * 16;
+            for (unsigned i = 0; i < 16; ++i) {
+                table[i] = static_cast<uint8_t>(prod[i] >> (8 * b));
+            }
+        }
+    }
+}
+
+#endif // #ifdef QUADIRON_USE_SIMD
+
+/** Multiply each element of `src` by `a` and store results into `dest`
+ *
+ * For GF(2^8) and GF(2^16), elements are multiplied a nibble at a time by
+ * looking up tables of the products of `a` with byte shuffles.
+ */
+template <typename T>
+void BinExtension<T>::mul_coef_to_buf(T a, T* src, T* dest, size_t len) const
+{
+#ifdef QUADIRON_USE_SIMD
+    if (n == 8 || n == 16) {
+        // Only the low n / 8 bytes of words are multiplied, upper ones being
+        // null.
+        uint8_t tables[128];
+        setup_nibble_tables(a, tables);
+        simd::gf2n_mul_coef_to_buf(
+            n,
+            sizeof(T),
+            tables,
+            reinterpret_cast<uint8_t*>(src),
+            reinterpret_cast<uint8_t*>(dest),
+            len * sizeof(T));
+        return;
+    }
+#endif // #ifdef QUADIRON_USE_SIMD
+    for (size_t i = 0; i < len; i++) {
+        dest[i] = mul(a, src[i]);
+    }
+}
+
+template <typename T>
+void BinExtension<T>::mul_vec_to_vecp(
+    vec::Vector<T>& u,
+    vec::Buffers<T>& src,
+    vec::Buffers<T>& dest) const
+{
+    assert(u.get_n() == src.get_n());
+    const int n_bufs = u.get_n();
+    const size_t len = src.get_size();
+
+    for (int i = 0; i < n_bufs; i++) {
+        const T coef = u.get(i);
+        if (coef == 0) {
+            dest.fill(i, 0);
+        } else if (coef == 1) {
+            dest.copy(i, src.get(i));
+        } else {
+            mul_coef_to_buf(coef, src.get(i), dest.get(i), len);
+        }
+    }
+}
+
+template <typename T>
+void BinExtension<T>::add_two_bufs(T* src, T* dest, size_t len) const
+{
+#ifdef QUADIRON_USE_SIMD
+    simd::gf2n_add_two_bufs(
+        reinterpret_cast<uint8_t*>(src),
+        reinterpret_cast<uint8_t*>(dest),
+        len * sizeof(T));
+#else
+    for (size_t i = 0; i < len; i++) {
+        dest[i] ^= src[i];
+    }
+#endif // #ifdef QUADIRON_USE_SIMD
+}
+
+/** Subtraction is the addition in characteristic 2 */
+template <typename T>
+void BinExtension<T>::sub_two_bufs(T* bufa, T* bufb, T* res, size_t len) const
+{
+    if (res == bufa) {
+        add_two_bufs(bufb, res, len);
+    } else {
+        if (res != bufb) {
+            std::copy_n(bufb, len, res);
+        }
+        add_two_bufs(bufa, res, len);
+    }
+}
+
+/** Elements are their own opposite in characteristic 2 */
+template <typename T>
+void BinExtension<T>::neg(size_t, T*) const
+{
+}
+
 } // namespace gf
 } // namespace quadiron
 
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gf_goldilocks.h"
+
+#ifdef QUADIRON_USE_SIMD
+#include "simd.h"
+#include "simd/simd.h"
+#endif
+
+namespace quadiron {
+namespace gf {
+
+#ifdef QUADIRON_USE_SIMD
+/* Operations are vectorized by SIMD */
+
+void Goldilocks::mul_coef_to_buf(
+    uint64_t a,
+    uint64_t* src,
+    uint64_t* dest,
+    size_t len) const
+{
+    simd::goldilocks_mul_coef_to_buf(a, src, dest, len);
+}
+
+void Goldilocks::add_two_bufs(uint64_t* src, uint64_t* dest, size_t len) const
+{
+    simd::goldilocks_add_two_bufs(src, dest, len);
+}
+
+void Goldilocks::sub_two_bufs(
+    uint64_t* bufa,
+    uint64_t* bufb,
+    uint64_t* res,
+    size_t len) const
+{
+    simd::goldilocks_sub_two_bufs(bufa, bufb, res, len);
+}
+
+void Goldilocks::hadamard_mul(int n, uint64_t* x, uint64_t* y) const
+{
+    simd::goldilocks_mul_two_bufs(y, x, n);
+}
+
+void Goldilocks::neg(size_t n, uint64_t* x) const
+{
+    simd::goldilocks_neg(n, x);
+}
+
+#else
+
+void Goldilocks::mul_coef_to_buf(
+    uint64_t a,
+    uint64_t* src,
+    uint64_t* dest,
+    size_t len) const
+{
+    gf::Field<uint64_t>::mul_coef_to_buf(a, src, dest, len);
+}
+
+void Goldilocks::add_two_bufs(uint64_t* src, uint64_t* dest, size_t len) const
+{
+    gf::Field<uint64_t>::add_two_bufs(src, dest, len);
+}
+
+void Goldilocks::sub_two_bufs(
+    uint64_t* bufa,
+    uint64_t* bufb,
+    uint64_t* res,
+    size_t len) const
+{
+    gf::Field<uint64_t>::sub_two_bufs(bufa, bufb, res, len);
+}
+
+void Goldilocks::hadamard_mul(int n, uint64_t* x, uint64_t* y) const
+{
+    gf::Field<uint64_t>::hadamard_mul(n, x, y);
+}
+
+void Goldilocks::neg(size_t n, uint64_t* x) const
+{
+    gf::Field<uint64_t>::neg(n, x);
+}
+
+#endif // #ifdef QUADIRON_USE_SIMD
+
+} // namespace gf
+} // namespace quadiron
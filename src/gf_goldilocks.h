@@ -0,0 +1,151 @@
+/* -*- mode: c++ -*- */
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __QUAD_GF_GOLDILOCKS_H__
+#define __QUAD_GF_GOLDILOCKS_H__
+
+#include "gf_base.h"
+#include "gf_prime.h"
+#include "vec_vector.h"
+
+namespace quadiron {
+namespace gf {
+
+/** The prime field GF(p) with p = 2<sup>64</sup> - 2<sup>32</sup> + 1.
+ *
+ * As p - 1 = 2<sup>32</sup> * 3 * 5 * 17 * 257 * 65537, it has roots of unity
+ * of every power-of-two order up to 2<sup>32</sup>.
+ *
+ * Products are reduced by shifts and subtractions, since
+ * 2<sup>64</sup> = 2<sup>32</sup> - 1 mod p and 2<sup>96</sup> = -1 mod p.
+ * As p > 2<sup>63</sup>, sums are checked for overflows.
+ */
+class Goldilocks : public gf::Field<uint64_t> {
+  public:
+    static constexpr uint64_t P = 0xFFFFFFFF00000001ULL;
+
+    using gf::Field<uint64_t>::neg;
+
+    Goldilocks(Goldilocks&&) = default;
+    uint64_t neg(uint64_t a) const override;
+    uint64_t add(uint64_t a, uint64_t b) const override;
+    uint64_t sub(uint64_t a, uint64_t b) const override;
+    uint64_t mul(uint64_t a, uint64_t b) const override;
+    uint64_t rand(void) const override;
+    void mul_coef_to_buf(uint64_t a, uint64_t* src, uint64_t* dest, size_t len)
+        const override;
+    void add_two_bufs(uint64_t* src, uint64_t* dest, size_t len) const override;
+    void sub_two_bufs(uint64_t* bufa, uint64_t* bufb, uint64_t* res, size_t len)
+        const override;
+    void hadamard_mul(int n, uint64_t* x, uint64_t* y) const override;
+    void neg(size_t n, uint64_t* x) const override;
+
+  private:
+    // 2^64 mod p
+    static constexpr uint64_t EPS = 0xFFFFFFFFULL;
+
+    Goldilocks() : gf::Field<uint64_t>(P, 1) {}
+
+    static uint64_t reduce(uint64_t lo, uint64_t hi);
+
+    template <typename Class, typename... Args>
+    friend Class create(Args... args);
+
+    template <typename Base, typename Class, typename... Args>
+    friend std::unique_ptr<Base> alloc(Args... args);
+};
+
+/// Reduce the 128-bit value `hi` * 2^64 + `lo` modulo p.
+inline uint64_t Goldilocks::reduce(uint64_t lo, uint64_t hi)
+{
+    const uint64_t hi_hi = hi >> 32;
+    const uint64_t hi_lo = hi & EPS;
+
+    // hi_hi * 2^96 = -hi_hi
+    uint64_t t0 = lo - hi_hi;
+    if (lo < hi_hi) {
+        t0 -= EPS;
+    }
+    // hi_lo * 2^64 = hi_lo * (2^32 - 1), that doesn't overflow
+    const uint64_t t1 = (hi_lo << 32) - hi_lo;
+    uint64_t res = t0 + t1;
+    if (res < t1) {
+        res += EPS;
+    }
+    return (res >= P) ? res - P : res;
+}
+
+inline uint64_t Goldilocks::neg(uint64_t a) const
+{
+    assert(check(a));
+
+    return (a == 0) ? 0 : P - a;
+}
+
+inline uint64_t Goldilocks::add(uint64_t a, uint64_t b) const
+{
+    assert(check(a));
+    assert(check(b));
+
+    const uint64_t c = a + b;
+    // a + b - p, either after an overflow or if a + b >= p
+    const uint64_t reduced = c + EPS;
+    return (c < a || reduced < c) ? reduced : c;
+}
+
+inline uint64_t Goldilocks::sub(uint64_t a, uint64_t b) const
+{
+    assert(check(a));
+    assert(check(b));
+
+    const uint64_t c = a - b;
+    return (a < b) ? c - EPS : c;
+}
+
+inline uint64_t Goldilocks::mul(uint64_t a, uint64_t b) const
+{
+    assert(check(a));
+    assert(check(b));
+
+    const __uint128_t prod = __uint128_t(a) * b;
+    return reduce(
+        static_cast<uint64_t>(prod), static_cast<uint64_t>(prod >> 64));
+}
+
+inline uint64_t Goldilocks::rand(void) const
+{
+    std::uniform_int_distribution<uint64_t> dis(1, P - 1);
+    return dis(prng());
+}
+
+} // namespace gf
+} // namespace quadiron
+
+#endif
@@ -31,8 +31,8 @@
 #ifndef __QUAD_GF_NF4_H__
 #define __QUAD_GF_NF4_H__
 
+#include <algorithm>
 #include <iostream>
-#include <vector>
 
 #include "gf_base.h"
 #include "gf_prime.h"
@@ -92,10 +92,17 @@ class NF4 : public gf::Field<T> {
     T h;
     std::unique_ptr<gf::Field<uint32_t>> sub_field;
 
-    // Scratch space for arithmetic operations.
-    // Note: those are not part of the externally visible state of the class.
-    mutable std::vector<uint16_t> scratch16;
-    mutable std::vector<uint32_t> scratch32;
+    // Maximal number of GF(65537) elements packed in a T.
+    // Arithmetic operations use stack arrays of this size as scratch space so
+    // that a field can be shared by concurrent threads.
+    static constexpr int max_n = sizeof(T) < 4 ? 1 : sizeof(T) / 4;
+
+    // Number of packed elements, bounded by `max_n` so that loops over the
+    // scratch arrays provably stay in bounds
+    int n_values() const
+    {
+        return std::min(this->n, max_n);
+    }
 
     bool check_n(unsigned n);
     explicit NF4(unsigned n);
@@ -112,6 +119,9 @@ class NF4 : public gf::Field<T> {
     void show_arr(uint32_t* arr);
 };
 
+template <typename T>
+constexpr int NF4<T>::max_n;
+
 template <typename T>
 NF4<T>::NF4(unsigned n) : gf::Field<T>(T(65537), n)
 {
@@ -126,9 +136,6 @@ NF4<T>::NF4(unsigned n) : gf::Field<T>(T(65537), n)
     unit = NF4<T>::replicate(1);
     q = NF4<T>::replicate(T(65537));
     h = NF4<T>::replicate(T(65536));
-
-    scratch16.reserve(this->n);
-    scratch32.reserve(this->n);
 }
 
 template <typename T>
@@ -150,8 +157,8 @@ bool NF4<T>::check_n(unsigned n)
 template <typename T>
 inline T NF4<T>::expand16(uint16_t* arr) const
 {
-    T c = arr[this->n - 1];
-    for (int i = this->n - 2; i >= 0; i--) {
+    T c = arr[n_values() - 1];
+    for (int i = n_values() - 2; i >= 0; i--) {
         c = (c << 16) | arr[i];
     }
     return c;
@@ -160,8 +167,8 @@ inline T NF4<T>::expand16(uint16_t* arr) const
 template <typename T>
 inline T NF4<T>::expand32(uint32_t* arr) const
 {
-    T c = arr[this->n - 1];
-    for (int i = this->n - 2; i >= 0; i--) {
+    T c = arr[n_values() - 1];
+    for (int i = n_values() - 2; i >= 0; i--) {
         c = ((c << 16) << 16) | arr[i];
     }
     return c;
@@ -214,16 +221,17 @@ inline T NF4<T>::neg(T a) const
 template <typename T>
 inline T NF4<T>::add(T a, T b) const
 {
+    uint32_t scratch32[max_n];
     scratch32[0] =
         (narrow_cast<uint32_t>(a) + narrow_cast<uint32_t>(b)) % 65537;
-    for (int i = 1; i < this->n; i++) {
+    for (int i = 1; i < n_values(); i++) {
         a = (a >> 16) >> 16;
         b = (b >> 16) >> 16;
         scratch32[i] =
             (narrow_cast<uint32_t>(a) + narrow_cast<uint32_t>(b)) % 65537;
     }
 
-    T c = expand32(scratch32.data());
+    T c = expand32(scratch32);
 
     return c;
 }
@@ -231,12 +239,13 @@ inline T NF4<T>::add(T a, T b) const
 template <typename T>
 inline T NF4<T>::sub(T a, T b) const
 {
+    uint32_t scratch32[max_n];
     uint32_t ae, be;
 
     ae = narrow_cast<uint32_t>(a);
     be = narrow_cast<uint32_t>(b);
     scratch32[0] = ae >= be ? ae - be : 65537 + ae - be;
-    for (int i = 1; i < this->n; i++) {
+    for (int i = 1; i < n_values(); i++) {
         a = (a >> 16) >> 16;
         b = (b >> 16) >> 16;
         ae = narrow_cast<uint32_t>(a);
@@ -244,7 +253,7 @@ inline T NF4<T>::sub(T a, T b) const
         scratch32[i] = ae >= be ? ae - be : 65537 + ae - be;
     }
 
-    T c = expand32(scratch32.data());
+    T c = expand32(scratch32);
 
     return c;
 }
@@ -252,13 +261,14 @@ inline T NF4<T>::sub(T a, T b) const
 template <typename T>
 inline T NF4<T>::mul(T a, T b) const
 {
+    uint32_t scratch32[max_n];
     uint64_t ae;
     uint32_t be;
 
     ae = static_cast<uint64_t>(a & MASK32);
     be = narrow_cast<uint32_t>(b);
     scratch32[0] = (ae == 65536 && be == 65536) ? 1 : (ae * be) % 65537;
-    for (int i = 1; i < this->n; i++) {
+    for (int i = 1; i < n_values(); i++) {
         a = (a >> 16) >> 16;
         b = (b >> 16) >> 16;
         ae = static_cast<uint64_t>(a & MASK32);
@@ -266,68 +276,72 @@ inline T NF4<T>::mul(T a, T b) const
         scratch32[i] = (ae == 65536 && be == 65536) ? 1 : (ae * be) % 65537;
     }
 
-    T c = expand32(scratch32.data());
+    T c = expand32(scratch32);
     return c;
 }
 
 template <typename T>
 inline T NF4<T>::div(T a, T b) const
 {
+    uint32_t scratch32[max_n];
     scratch32[0] =
         sub_field->div(narrow_cast<uint32_t>(a), narrow_cast<uint32_t>(b));
-    for (int i = 1; i < this->n; i++) {
+    for (int i = 1; i < n_values(); i++) {
         a = (a >> 16) >> 16;
         b = (b >> 16) >> 16;
         scratch32[i] =
             sub_field->div(narrow_cast<uint32_t>(a), narrow_cast<uint32_t>(b));
     }
 
-    T c = expand32(scratch32.data());
+    T c = expand32(scratch32);
     return c;
 }
 
 template <typename T>
 inline T NF4<T>::inv(T a) const
 {
+    uint32_t scratch32[max_n];
     scratch32[0] = sub_field->inv(narrow_cast<uint32_t>(a));
-    for (int i = 1; i < this->n; i++) {
+    for (int i = 1; i < n_values(); i++) {
         a = (a >> 16) >> 16;
         scratch32[i] = sub_field->inv(narrow_cast<uint32_t>(a));
     }
 
-    T c = expand32(scratch32.data());
+    T c = expand32(scratch32);
     return c;
 }
 
 template <typename T>
 inline T NF4<T>::exp(T a, T b) const
 {
+    uint32_t scratch32[max_n];
     scratch32[0] =
         sub_field->exp(narrow_cast<uint32_t>(a), narrow_cast<uint32_t>(b));
-    for (int i = 1; i < this->n; i++) {
+    for (int i = 1; i < n_values(); i++) {
         a = (a >> 16) >> 16;
         b = (b >> 16) >> 16;
         scratch32[i] =
             sub_field->exp(narrow_cast<uint32_t>(a), narrow_cast<uint32_t>(b));
     }
 
-    T c = expand32(scratch32.data());
+    T c = expand32(scratch32);
     return c;
 }
 
 template <typename T>
 inline T NF4<T>::log(T a, T b) const
 {
+    uint32_t scratch32[max_n];
     scratch32[0] =
         sub_field->log(narrow_cast<uint32_t>(a), narrow_cast<uint32_t>(b));
-    for (int i = 1; i < this->n; i++) {
+    for (int i = 1; i < n_values(); i++) {
         a = (a >> 16) >> 16;
         b = (b >> 16) >> 16;
         scratch32[i] =
             sub_field->log(narrow_cast<uint32_t>(a), narrow_cast<uint32_t>(b));
     }
 
-    T c = expand32(scratch32.data());
+    T c = expand32(scratch32);
     return c;
 }
 
@@ -354,13 +368,14 @@ T NF4<T>::unpacked_rand(void) const
 template <typename T>
 inline T NF4<T>::pack(T a) const
 {
+    uint32_t scratch32[max_n];
     scratch32[0] = static_cast<uint32_t>(a & MASK16);
-    for (int i = 1; i < this->n; i++) {
+    for (int i = 1; i < n_values(); i++) {
         a = (a >> 16);
         scratch32[i] = static_cast<uint32_t>(a & MASK16);
     }
 
-    T c = expand32(scratch32.data());
+    T c = expand32(scratch32);
     return c;
 }
 
@@ -371,14 +386,15 @@ inline T NF4<T>::pack(T a) const
 template <typename T>
 inline T NF4<T>::pack(T a, uint32_t flag) const
 {
+    uint32_t scratch32[max_n];
     scratch32[0] = (flag & 1) ? 65536 : static_cast<uint32_t>(a & MASK16);
-    for (int i = 1; i < this->n; i++) {
+    for (int i = 1; i < n_values(); i++) {
         flag >>= 1;
         a = (a >> 16);
         scratch32[i] = (flag & 1) ? 65536 : static_cast<uint32_t>(a & MASK16);
     }
 
-    T c = expand32(scratch32.data());
+    T c = expand32(scratch32);
     return c;
 }
 
@@ -390,6 +406,7 @@ inline T NF4<T>::pack(T a, uint32_t flag) const
 template <typename T>
 inline GroupedValues<T> NF4<T>::unpack(T a) const
 {
+    uint16_t scratch16[max_n];
     GroupedValues<T> b = GroupedValues<T>();
     uint32_t flag = 0;
     uint32_t ae;
@@ -401,7 +418,7 @@ inline GroupedValues<T> NF4<T>::unpack(T a) const
     } else {
         scratch16[0] = narrow_cast<uint16_t>(ae);
     }
-    for (int i = 1; i < this->n; i++) {
+    for (int i = 1; i < n_values(); i++) {
         a = (a >> 16) >> 16;
         ae = narrow_cast<uint32_t>(a);
         if (ae == 65536) {
@@ -413,13 +430,14 @@ inline GroupedValues<T> NF4<T>::unpack(T a) const
     }
 
     b.flag = flag;
-    b.values = expand16(scratch16.data());
+    b.values = expand16(scratch16);
     return b;
 }
 
 template <typename T>
 inline void NF4<T>::unpack(T a, GroupedValues<T>& b) const
 {
+    uint16_t scratch16[max_n];
     uint32_t flag = 0;
     uint32_t ae;
 
@@ -430,7 +448,7 @@ inline void NF4<T>::unpack(T a, GroupedValues<T>& b) const
     } else {
         scratch16[0] = narrow_cast<uint16_t>(ae);
     }
-    for (int i = 1; i < this->n; i++) {
+    for (int i = 1; i < n_values(); i++) {
         a = (a >> 16) >> 16;
         ae = narrow_cast<uint32_t>(a);
         if (ae == 65536) {
@@ -442,7 +460,7 @@ inline void NF4<T>::unpack(T a, GroupedValues<T>& b) const
     }
 
     b.flag = flag;
-    b.values = expand16(scratch16.data());
+    b.values = expand16(scratch16);
 }
 
 // Use for fft
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gf_prime.h"
+
+#ifdef QUADIRON_USE_SIMD
+#include "simd.h"
+#include "simd/simd.h"
+
+namespace quadiron {
+namespace gf {
+
+// Fermat numbers keep the kernels of RingModN, whose reduction is cheaper.
+template <>
+void Prime<uint32_t>::mul_coef_to_buf(
+    uint32_t a,
+    uint32_t* src,
+    uint32_t* dest,
+    size_t len) const
+{
+    if (this->_card == F3 || this->_card == F4 || !montgomery) {
+        gf::Field<uint32_t>::mul_coef_to_buf(a, src, dest, len);
+        return;
+    }
+    const uint32_t a_mont = (uint64_t(a) * r_mod_p) % this->_card;
+    simd::mont_mul_coef_to_buf(a_mont, src, dest, len, this->_card, card_inv);
+}
+
+template <>
+void Prime<uint32_t>::hadamard_mul(int n, uint32_t* x, uint32_t* y) const
+{
+    if (this->_card == F3 || this->_card == F4 || !montgomery) {
+        gf::Field<uint32_t>::hadamard_mul(n, x, y);
+        return;
+    }
+    simd::mont_mul_two_bufs(y, x, n, this->_card, card_inv, r2_mod_p);
+}
+
+template <>
+void Prime<uint64_t>::mul_coef_to_buf(
+    uint64_t a,
+    uint64_t* src,
+    uint64_t* dest,
+    size_t len) const
+{
+    if (!montgomery) {
+        gf::Field<uint64_t>::mul_coef_to_buf(a, src, dest, len);
+        return;
+    }
+    const uint64_t a_mont = (__uint128_t(a) * r_mod_p) % this->_card;
+    simd::mont_mul_coef_to_buf(a_mont, src, dest, len, this->_card, card_inv);
+}
+
+template <>
+void Prime<uint64_t>::add_two_bufs(uint64_t* src, uint64_t* dest, size_t len)
+    const
+{
+    if (!montgomery) {
+        gf::Field<uint64_t>::add_two_bufs(src, dest, len);
+        return;
+    }
+    simd::add_two_bufs(src, dest, len, this->_card);
+}
+
+template <>
+void Prime<uint64_t>::sub_two_bufs(
+    uint64_t* bufa,
+    uint64_t* bufb,
+    uint64_t* res,
+    size_t len) const
+{
+    if (!montgomery) {
+        gf::Field<uint64_t>::sub_two_bufs(bufa, bufb, res, len);
+        return;
+    }
+    simd::sub_two_bufs(bufa, bufb, res, len, this->_card);
+}
+
+template <>
+void Prime<uint64_t>::hadamard_mul(int n, uint64_t* x, uint64_t* y) const
+{
+    if (!montgomery) {
+        gf::Field<uint64_t>::hadamard_mul(n, x, y);
+        return;
+    }
+    simd::mont_mul_two_bufs(y, x, n, this->_card, card_inv, r2_mod_p);
+}
+
+} // namespace gf
+} // namespace quadiron
+
+#endif // #ifdef QUADIRON_USE_SIMD
@@ -36,16 +36,31 @@
 namespace quadiron {
 namespace gf {
 
-/** A Galois Field whose order is a prime number. */
+/** A Galois Field whose order is a prime number.
+ *
+ * Buffers of 32-bit or 64-bit words are multiplied by the Montgomery
+ * reduction when the prime is not a Fermat number handled by RingModN.
+ */
 template <typename T>
 class Prime : public gf::Field<T> {
   public:
     Prime(Prime&&) = default;
     T inv_exp(T a);
+    void mul_coef_to_buf(T a, T* src, T* dest, size_t len) const override;
+    void add_two_bufs(T* src, T* dest, size_t len) const override;
+    void sub_two_bufs(T* bufa, T* bufb, T* res, size_t len) const override;
+    void hadamard_mul(int n, T* x, T* y) const override;
 
   private:
     explicit Prime(T p);
 
+    // Montgomery reduction needs an odd modulus, lower than R / 2 so that
+    // sums don't overflow, with R = 2^(8 * sizeof(T))
+    bool montgomery;
+    T card_inv; // -1/p mod R
+    T r_mod_p; // R mod p
+    T r2_mod_p; // R^2 mod p
+
     template <typename Class, typename... Args>
     friend Class create(Args... args);
 
@@ -56,6 +71,25 @@ class Prime : public gf::Field<T> {
 template <typename T>
 Prime<T>::Prime(T p) : gf::Field<T>(p, 1)
 {
+    const unsigned bits = sizeof(T) * CHAR_BIT;
+    montgomery = (bits == 32 || bits == 64) && (p & 1) && !(p >> (bits - 1));
+    card_inv = 0;
+    r_mod_p = 0;
+    r2_mod_p = 0;
+    if (!montgomery) {
+        return;
+    }
+
+    // Newton's iteration doubles the number of correct low bits of 1/p,
+    // starting from 3 bits as p * p = 1 mod 8
+    const uint64_t p64 = static_cast<uint64_t>(p);
+    uint64_t inv = p64;
+    for (int i = 0; i < 5; ++i) {
+        inv *= 2 - p64 * inv;
+    }
+    card_inv = static_cast<T>(-inv);
+    r_mod_p = static_cast<T>(T(0) - p) % p;
+    r2_mod_p = static_cast<T>((DoubleSizeVal<T>(r_mod_p) * r_mod_p) % p);
 }
 
 /// Inverse by exponentiation.
@@ -67,6 +101,62 @@ T Prime<T>::inv_exp(T a)
     return this->exp(a, this->p - 2);
 }
 
+template <typename T>
+void Prime<T>::mul_coef_to_buf(T a, T* src, T* dest, size_t len) const
+{
+    gf::Field<T>::mul_coef_to_buf(a, src, dest, len);
+}
+
+template <typename T>
+void Prime<T>::add_two_bufs(T* src, T* dest, size_t len) const
+{
+    gf::Field<T>::add_two_bufs(src, dest, len);
+}
+
+template <typename T>
+void Prime<T>::sub_two_bufs(T* bufa, T* bufb, T* res, size_t len) const
+{
+    gf::Field<T>::sub_two_bufs(bufa, bufb, res, len);
+}
+
+template <typename T>
+void Prime<T>::hadamard_mul(int n, T* x, T* y) const
+{
+    gf::Field<T>::hadamard_mul(n, x, y);
+}
+
+#ifdef QUADIRON_USE_SIMD
+/* Operations are vectorized by SIMD */
+
+template <>
+void Prime<uint32_t>::mul_coef_to_buf(
+    uint32_t a,
+    uint32_t* src,
+    uint32_t* dest,
+    size_t len) const;
+template <>
+void Prime<uint32_t>::hadamard_mul(int n, uint32_t* x, uint32_t* y) const;
+
+template <>
+void Prime<uint64_t>::mul_coef_to_buf(
+    uint64_t a,
+    uint64_t* src,
+    uint64_t* dest,
+    size_t len) const;
+template <>
+void Prime<uint64_t>::add_two_bufs(uint64_t* src, uint64_t* dest, size_t len)
+    const;
+template <>
+void Prime<uint64_t>::sub_two_bufs(
+    uint64_t* bufa,
+    uint64_t* bufb,
+    uint64_t* res,
+    size_t len) const;
+template <>
+void Prime<uint64_t>::hadamard_mul(int n, uint64_t* x, uint64_t* y) const;
+
+#endif // #ifdef QUADIRON_USE_SIMD
+
 } // namespace gf
 } // namespace quadiron
 
@@ -28,6 +28,8 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+
 #include "gf_ring.h"
 
 #ifdef QUADIRON_USE_SIMD
@@ -56,6 +58,13 @@ void RingModN<uint32_t>::mul_coef_to_buf(
     uint32_t* dest,
     size_t len) const
 {
+    // SIMD products are wrong for (card - 1) * (card - 1), as for Fermat
+    // numbers it doesn't fit in twice the bits of the low half
+    if (a == this->_card - 1) {
+        std::copy_n(src, len, dest);
+        neg(len, dest);
+        return;
+    }
     simd::mul_coef_to_buf(a, src, dest, len, this->_card);
 }
 
@@ -83,6 +92,13 @@ void RingModN<uint16_t>::mul_coef_to_buf(
     uint16_t* dest,
     size_t len) const
 {
+    // SIMD products are wrong for (card - 1) * (card - 1), as for Fermat
+    // numbers it doesn't fit in twice the bits of the low half
+    if (a == this->_card - 1) {
+        std::copy_n(src, len, dest);
+        neg(len, dest);
+        return;
+    }
     simd::mul_coef_to_buf(a, src, dest, len, this->_card);
 }
 
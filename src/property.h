@@ -31,11 +31,14 @@
 #ifndef __QUAD_PROPERTY_H__
 #define __QUAD_PROPERTY_H__
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <iosfwd>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <netinet/in.h>
 #include <sys/types.h>
@@ -48,25 +51,49 @@ static constexpr unsigned OOR_MARK = 1;
  *
  * A property carries extra-information (whose interpretation is left to the
  * reader) related to a specific value (identified by its location).
- * It wraps a map whose each element is a key/value where
+ * It stores key/value entries where
  *  - key indicates the location of symbol whose value should be adjusted
  *  - value indicates value that could be used to adjust the symbol value
  * For prime fields, value is always 1.
  * For NF4, value is an uint32_t integer.
+ *
+ * Entries are kept sorted by location in a flat vector. Encoding produces
+ * locations in increasing order, so that adding one is a mere append, and the
+ * entries of a packet are found by a binary search.
  */
 class Properties {
   public:
     enum { FNT1 = 0x464E5431 };
 
+    using Entry = std::pair<off_t, uint32_t>;
+    using const_iterator = std::vector<Entry>::const_iterator;
+
     inline void add(const off_t loc, const uint32_t data)
     {
-        props[loc] = data;
+        if (props.empty() || props.back().first < loc) {
+            props.emplace_back(loc, data);
+            return;
+        }
+        auto it = lower_bound(loc);
+        if (it != props.end() && it->first == loc) {
+            it->second = data;
+        } else {
+            props.emplace(it, loc, data);
+        }
     }
 
     inline uint32_t get(const off_t loc) const
     {
-        auto it = props.find(loc);
-        return it != props.end() ? it->second : 0;
+        auto it = lower_bound(loc);
+        return it != props.end() && it->first == loc ? it->second : 0;
+    }
+
+    inline void remove(const off_t loc)
+    {
+        auto it = lower_bound(loc);
+        if (it != props.end() && it->first == loc) {
+            props.erase(it);
+        }
     }
 
     inline void clear()
@@ -74,9 +101,39 @@ class Properties {
         props.clear();
     }
 
+    inline size_t size() const
+    {
+        return props.size();
+    }
+
+    /** Add all entries of other properties.
+     *
+     * Entries already present are kept.
+     */
+    inline void merge(const Properties& other)
+    {
+        for (const Entry& entry : other.props) {
+            if (props.empty() || props.back().first < entry.first) {
+                props.push_back(entry);
+                continue;
+            }
+            auto it = lower_bound(entry.first);
+            if (it == props.end() || it->first != entry.first) {
+                props.insert(it, entry);
+            }
+        }
+    }
+
+    /** Get the entries located in [begin, end), sorted by location. */
+    inline std::pair<const_iterator, const_iterator>
+    get_range(const off_t begin, const off_t end) const
+    {
+        return std::make_pair(lower_bound(begin), lower_bound(end));
+    }
+
     std::unordered_map<off_t, uint32_t> const get_map() const
     {
-        return props;
+        return std::unordered_map<off_t, uint32_t>(props.begin(), props.end());
     }
 
     /**
@@ -126,7 +183,23 @@ class Properties {
     }
 
   private:
-    std::unordered_map<off_t, uint32_t> props;
+    inline std::vector<Entry>::iterator lower_bound(const off_t loc)
+    {
+        return std::lower_bound(
+            props.begin(), props.end(), loc, [](const Entry& e, off_t l) {
+                return e.first < l;
+            });
+    }
+
+    inline const_iterator lower_bound(const off_t loc) const
+    {
+        return std::lower_bound(
+            props.begin(), props.end(), loc, [](const Entry& e, off_t l) {
+                return e.first < l;
+            });
+    }
+
+    std::vector<Entry> props;
 
     friend std::istream& operator>>(std::istream& is, Properties& props);
     friend std::ostream& operator<<(std::ostream& os, const Properties& props);
@@ -396,6 +396,36 @@ int quadiron_fnt32_reconstruct(
     return 0;
 }
 
+int quadiron_fnt32_get_stage_stats(
+    struct QuadironFnt32* fecp,
+    enum QuadironStage stage,
+    uint64_t* cycles,
+    uint64_t* bytes)
+{
+    quadiron::fec::RsFnt<uint32_t>* fec =
+        reinterpret_cast<quadiron::fec::RsFnt<uint32_t>*>(fecp);
+    const size_t idx = static_cast<size_t>(stage);
+
+    if (!quadiron::fec::StageStats::enabled
+        || idx >= quadiron::fec::n_stages) {
+        return -1;
+    }
+
+    const quadiron::fec::Stage fec_stage =
+        static_cast<quadiron::fec::Stage>(idx);
+    *cycles = fec->stage_stats.get_cycles(fec_stage);
+    *bytes = fec->stage_stats.get_bytes(fec_stage);
+
+    return 0;
+}
+
+void quadiron_fnt32_reset_stage_stats(struct QuadironFnt32* fecp)
+{
+    quadiron::fec::RsFnt<uint32_t>* fec =
+        reinterpret_cast<quadiron::fec::RsFnt<uint32_t>*>(fecp);
+    fec->stage_stats.reset();
+}
+
 void quadiron_hex_dump(uint8_t* buf, size_t size)
 {
     quadiron::hex_dump(std::cerr, buf, size, true);
@@ -148,6 +148,41 @@ int quadiron_fnt32_reconstruct(
     unsigned int destination_idx,
     size_t block_size);
 
+/** Stages of block encoding and decoding */
+enum QuadironStage {
+    QUADIRON_STAGE_COPY = 0,
+    QUADIRON_STAGE_PACK,
+    QUADIRON_STAGE_FFT,
+    QUADIRON_STAGE_POST_PROCESS,
+    QUADIRON_STAGE_UNPACK,
+    QUADIRON_STAGE_CONTEXT,
+};
+
+/** Get statistics of a stage of block encoding and decoding
+ *
+ * Statistics are accumulated over all operations since the creation of the
+ * FEC or the last reset.
+ *
+ * @param[in] fecp the FEC instance
+ * @param[in] stage the stage
+ * @param[out] cycles cycles spent in the stage
+ * @param[out] bytes bytes processed by the stage
+ *
+ * @return 0 if succeeded, else -1 (library built without stage statistics or
+ * unknown stage)
+ */
+int quadiron_fnt32_get_stage_stats(
+    struct QuadironFnt32* fecp,
+    enum QuadironStage stage,
+    uint64_t* cycles,
+    uint64_t* bytes);
+
+/** Reset statistics of all stages
+ *
+ * @param[in] fecp the FEC instance
+ */
+void quadiron_fnt32_reset_stage_stats(struct QuadironFnt32* fecp);
+
 /** Dump a buffer on stderr (debug function)
  *
  * @param[in] buf the buffer
@@ -52,8 +52,17 @@ namespace simd {
 } // namespace simd
 } // namespace quadiron
 
+#if defined(QUADIRON_SIMD_DISPATCH) && !defined(__SSE4_1__)
+
+// Forward operations to the kernels picked at runtime
+#include "simd_dispatch.h"
+
+#else
+
 // Include essential operations that use SIMD functions
-#if defined(__AVX2__)
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+#include "simd_512.h"
+#elif defined(__AVX2__)
 #include "simd_256.h"
 #elif defined(__SSE4_1__)
 #include "simd_128.h"
@@ -68,6 +77,14 @@ namespace simd {
 // Include accelerated operations dedicated for NF4
 #include "simd_nf4.h"
 
+// Include accelerated operations dedicated for GF(2^8) and GF(2^16)
+#include "simd_gf2n.h"
+
+// Include accelerated operations dedicated for other prime fields
+#include "simd_prime.h"
+
+#endif // #if defined(QUADIRON_SIMD_DISPATCH) && !defined(__SSE4_1__)
+
 #endif // #ifdef QUADIRON_USE_SIMD
 
 #endif
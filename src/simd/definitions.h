@@ -62,23 +62,40 @@ namespace simd {
 
 /// Supported instruction set.
 enum class InstructionSet {
-    NONE, ///< No SIMD instruction (fallback).
-    SSE,  ///< SSE4.1
-    AVX,  ///< AVX2
+    NONE,   ///< No SIMD instruction (fallback).
+    SSE,    ///< SSE4.1
+    AVX,    ///< AVX2
+    AVX512, ///< AVX-512F and AVX-512BW
 };
 
+// Definitions for Intel AVX-512 {{{
+
+// AVX-512BW is required for operations on 16-bit elements (such as
+// `_mm512_add_epi16`).
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+
+using RegisterType = __m512;
+using MaskType = __m512i;
+
+static constexpr InstructionSet INSTRUCTION_SET = InstructionSet::AVX512;
+
+#define QUADIRON_SIMD_ISA avx512
+
+// }}}
 // Definitions for Intel AVX-256 {{{
 
 // We required AVX2 because we relies on some instructions (such as
 // `_mm256_add_epi16` and others) that aren't available in the first version of
 // AVX.
-#if defined(__AVX__) && defined(__AVX2__)
+#elif defined(__AVX__) && defined(__AVX2__)
 
 using RegisterType = __m256;
 using MaskType = __m256i;
 
 static constexpr InstructionSet INSTRUCTION_SET = InstructionSet::AVX;
 
+#define QUADIRON_SIMD_ISA avx
+
 // }}}
 // Definitions for Intel SSE {{{
 
@@ -89,6 +106,23 @@ using MaskType = __m128i;
 
 static constexpr InstructionSet INSTRUCTION_SET = InstructionSet::SSE;
 
+#define QUADIRON_SIMD_ISA sse
+
+// }}}
+// Definitions for runtime dispatch {{{
+
+// The unit isn't compiled for a given instruction set: kernels are picked at
+// runtime among the ones compiled separately (see simd_kernels.h). Memory is
+// laid out for the widest instruction set that may be picked.
+#elif defined(QUADIRON_SIMD_DISPATCH)
+
+using RegisterType = __m512;
+using MaskType = __m512i;
+
+static constexpr InstructionSet INSTRUCTION_SET = InstructionSet::AVX512;
+
+#define QUADIRON_SIMD_ISA dispatch
+
 // }}}
 // Definitions for scalar fallback {{{
 
@@ -105,13 +139,18 @@ using MaskType = uint32_t;
 
 static constexpr InstructionSet INSTRUCTION_SET = InstructionSet::NONE;
 
+#define QUADIRON_SIMD_ISA none
+
 #endif
 
 // }}}
 // Portable definitions {{{
 
-/// Alignment constraint (in bytes).
-static constexpr std::size_t ALIGNMENT = alignof(RegisterType);
+// QUADIRON_SIMD_ISA names the inline namespace of the kernels, so that kernels
+// compiled for several instruction sets can be linked in the same binary.
+
+/// Alignment constraint (in bytes): registers are aligned on their size.
+static constexpr std::size_t ALIGNMENT = sizeof(RegisterType);
 
 /// Register size (in bits).
 static constexpr std::size_t REG_BITSZ = sizeof(RegisterType) * CHAR_BIT;
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file dispatch.h
+ *
+ * Select, at runtime, the instruction set the SIMD kernels are run with.
+ */
+
+#ifndef __QUAD_SIMD_SIMD_DISPATCH_H__
+#define __QUAD_SIMD_SIMD_DISPATCH_H__
+
+#include "simd/definitions.h"
+
+namespace quadiron {
+namespace simd {
+
+/** Return the widest instruction set usable by the running CPU.
+ *
+ * Only relevant when kernels are compiled for several instruction sets (i.e.
+ * with `QUADIRON_SIMD_DISPATCH`): the environment variable `QUADIRON_SIMD`
+ * (`none`, `sse`, `avx` or `avx512`) then restricts the choice, e.g. for
+ * testing. `NONE` selects kernels without SIMD instructions. Otherwise the
+ * instruction set is the one the library is compiled for.
+ */
+InstructionSet detect_instruction_set();
+
+/** Return the instruction set the SIMD kernels are run with.
+ *
+ * It is detected once, on first use.
+ */
+InstructionSet get_instruction_set();
+
+} // namespace simd
+} // namespace quadiron
+
+#endif
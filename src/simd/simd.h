@@ -33,6 +33,7 @@
 
 #include "simd/allocator.h"
 #include "simd/definitions.h"
+#include "simd/dispatch.h"
 
 namespace quadiron {
 
@@ -43,6 +44,27 @@ namespace quadiron {
  */
 namespace simd {
 
+#if defined(QUADIRON_SIMD_DISPATCH) && !defined(__SSE4_1__)
+
+/// Return the number of element of type T that can fit into a SIMD register.
+template <typename T>
+inline std::size_t countof()
+{
+    switch (get_instruction_set()) {
+    case InstructionSet::SSE:
+        return 128 / (sizeof(T) * CHAR_BIT);
+    case InstructionSet::AVX:
+        return 256 / (sizeof(T) * CHAR_BIT);
+    case InstructionSet::AVX512:
+        return 512 / (sizeof(T) * CHAR_BIT);
+    case InstructionSet::NONE:
+        break;
+    }
+    return 1;
+}
+
+#else
+
 /// Return the number of element of type T that can fit into a SIMD register.
 template <typename T>
 static constexpr std::size_t countof()
@@ -54,6 +76,8 @@ static constexpr std::size_t countof()
     return REG_BITSZ / (sizeof(T) * CHAR_BIT);
 }
 
+#endif
+
 } // namespace simd
 } // namespace quadiron
 
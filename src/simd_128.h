@@ -35,40 +35,17 @@
 
 namespace quadiron {
 namespace simd {
+inline namespace QUADIRON_SIMD_ISA {
 
 typedef __m128i VecType;
 
-/* ============= Constant variable  ============ */
-
-// @note: using const leads to an lint error of initialization of 'variable'
-// with static storage duration may throw an exception that cannot be caught
-
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType F4_U32 = _mm_set1_epi32(65537);
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType F4_MINUS_ONE_U32 = _mm_set1_epi32(65536);
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType F3_U32 = _mm_set1_epi32(257);
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType F3_MINUS_ONE_U32 = _mm_set1_epi32(256);
-
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType F3_U16 = _mm_set1_epi16(257);
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType F3_MINUS_ONE_U16 = _mm_set1_epi16(256);
-
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType ZERO = _mm_setzero_si128();
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType ONE_U16 = _mm_set1_epi16(1);
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType ONE_U32 = _mm_set1_epi32(1);
-
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType MASK8_LO = _mm_set1_epi16(0x80);
-
 /* ============= Essential Operations for SSE w/ both u16 & u32 ============ */
 
+inline VecType zero()
+{
+    return _mm_setzero_si128();
+}
+
 inline VecType load_to_reg(VecType* address)
 {
     return _mm_load_si128(address);
@@ -77,6 +54,14 @@ inline void store_to_mem(VecType* address, VecType reg)
 {
     _mm_store_si128(address, reg);
 }
+inline VecType loadu_to_reg(VecType* address)
+{
+    return _mm_loadu_si128(address);
+}
+inline void storeu_to_mem(VecType* address, VecType reg)
+{
+    _mm_storeu_si128(address, reg);
+}
 
 inline VecType bit_and(VecType x, VecType y)
 {
@@ -96,7 +81,7 @@ inline bool and_is_zero(VecType x, VecType y)
 }
 inline bool is_zero(VecType x)
 {
-    return _mm_testc_si128(ZERO, x);
+    return _mm_testc_si128(zero(), x);
 }
 
 #define SHIFTR(x, imm8) (_mm_srli_si128(x, imm8))
@@ -117,6 +102,11 @@ inline VecType set_one(uint16_t val)
 {
     return _mm_set1_epi16(val);
 }
+template <>
+inline VecType set_one(uint64_t val)
+{
+    return _mm_set1_epi64x(val);
+}
 
 template <typename T>
 inline VecType add(VecType x, VecType y);
@@ -130,6 +120,11 @@ inline VecType add<uint16_t>(VecType x, VecType y)
 {
     return _mm_add_epi16(x, y);
 }
+template <>
+inline VecType add<uint64_t>(VecType x, VecType y)
+{
+    return _mm_add_epi64(x, y);
+}
 
 template <typename T>
 inline VecType sub(VecType x, VecType y);
@@ -143,6 +138,11 @@ inline VecType sub<uint16_t>(VecType x, VecType y)
 {
     return _mm_sub_epi16(x, y);
 }
+template <>
+inline VecType sub<uint64_t>(VecType x, VecType y)
+{
+    return _mm_sub_epi64(x, y);
+}
 
 template <typename T>
 inline VecType mul(VecType x, VecType y);
@@ -157,6 +157,32 @@ inline VecType mul<uint16_t>(VecType x, VecType y)
     return _mm_mullo_epi16(x, y);
 }
 
+template <typename T>
+inline VecType shift_left(VecType x, unsigned bits);
+template <>
+inline VecType shift_left<uint32_t>(VecType x, unsigned bits)
+{
+    return _mm_sll_epi32(x, _mm_cvtsi32_si128(bits));
+}
+template <>
+inline VecType shift_left<uint16_t>(VecType x, unsigned bits)
+{
+    return _mm_sll_epi16(x, _mm_cvtsi32_si128(bits));
+}
+template <>
+inline VecType shift_left<uint64_t>(VecType x, unsigned bits)
+{
+    return _mm_sll_epi64(x, _mm_cvtsi32_si128(bits));
+}
+
+template <typename T>
+inline VecType shift_right(VecType x, unsigned bits);
+template <>
+inline VecType shift_right<uint64_t>(VecType x, unsigned bits)
+{
+    return _mm_srl_epi64(x, _mm_cvtsi32_si128(bits));
+}
+
 template <typename T>
 inline VecType compare_eq(VecType x, VecType y);
 template <>
@@ -169,6 +195,11 @@ inline VecType compare_eq<uint16_t>(VecType x, VecType y)
 {
     return _mm_cmpeq_epi16(x, y);
 }
+template <>
+inline VecType compare_eq<uint64_t>(VecType x, VecType y)
+{
+    return _mm_cmpeq_epi64(x, y);
+}
 
 template <typename T>
 inline VecType min(VecType x, VecType y);
@@ -183,6 +214,96 @@ inline VecType min<uint16_t>(VecType x, VecType y)
     return _mm_min_epu16(x, y);
 }
 
+/* ============ Operations on 64-bit Elements for SSE ============ */
+
+inline VecType bit_or(VecType x, VecType y)
+{
+    return _mm_or_si128(x, y);
+}
+/// Bitwise AND of `y` with the complement of `x`.
+inline VecType bit_andnot(VecType x, VecType y)
+{
+    return _mm_andnot_si128(x, y);
+}
+/// Multiply the low 32 bits of 64-bit elements into 64-bit products.
+inline VecType mul_wide(VecType x, VecType y)
+{
+    return _mm_mul_epu32(x, y);
+}
+/// Select 64-bit elements of `y` where `mask` is negative, of `x` elsewhere.
+inline VecType blend_neg64(VecType x, VecType y, VecType mask)
+{
+    return _mm_castpd_si128(_mm_blendv_pd(
+        _mm_castsi128_pd(x), _mm_castsi128_pd(y), _mm_castsi128_pd(mask)));
+}
+
+/* ===================== Byte Operations for SSE ====================== */
+
+// Byte shuffles, packs and unpacks act on each 128-bit lane.
+
+/// Load a table of 16 bytes into each 128-bit lane.
+inline VecType load_table(const uint8_t* table)
+{
+    return _mm_loadu_si128(reinterpret_cast<const VecType*>(table));
+}
+/// Look up each byte of `idx` (its 4 low bits) in the table of its lane.
+inline VecType shuffle8(VecType table, VecType idx)
+{
+    return _mm_shuffle_epi8(table, idx);
+}
+inline VecType unpack_low8(VecType x, VecType y)
+{
+    return _mm_unpacklo_epi8(x, y);
+}
+inline VecType unpack_high8(VecType x, VecType y)
+{
+    return _mm_unpackhi_epi8(x, y);
+}
+inline VecType unpack_low64(VecType x, VecType y)
+{
+    return _mm_unpacklo_epi64(x, y);
+}
+inline VecType unpack_high64(VecType x, VecType y)
+{
+    return _mm_unpackhi_epi64(x, y);
+}
+inline VecType unpack_low16(VecType x, VecType y)
+{
+    return _mm_unpacklo_epi16(x, y);
+}
+inline VecType unpack_high16(VecType x, VecType y)
+{
+    return _mm_unpackhi_epi16(x, y);
+}
+inline VecType unpack_low32(VecType x, VecType y)
+{
+    return _mm_unpacklo_epi32(x, y);
+}
+inline VecType unpack_high32(VecType x, VecType y)
+{
+    return _mm_unpackhi_epi32(x, y);
+}
+/// Pack the low byte of the 16-bit elements of `x` then `y`, all below 256.
+inline VecType pack16(VecType x, VecType y)
+{
+    return _mm_packus_epi16(x, y);
+}
+/// Pack the low 16 bits of the 32-bit elements of `x` then `y`, all below
+/// 2^16.
+inline VecType pack32(VecType x, VecType y)
+{
+    return _mm_packus_epi32(x, y);
+}
+/// Pack the low 32 bits of the 64-bit elements of `x` then `y`.
+inline VecType pack64(VecType x, VecType y)
+{
+    return _mm_castps_si128(_mm_shuffle_ps(
+        _mm_castsi128_ps(x), _mm_castsi128_ps(y), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+#define SHIFTR_U16(x, imm8) (_mm_srli_epi16(x, imm8))
+
+} // namespace QUADIRON_SIMD_ISA
 } // namespace simd
 } // namespace quadiron
 
@@ -33,8 +33,8 @@
 
 #include <x86intrin.h>
 
-/* GCC doesn't include the split store intrinsics so define them here. */
-#if defined(__GNUC__) && !defined(__clang__)
+/* GCC < 10 doesn't include the split store intrinsics so define them here. */
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 10
 
 static inline void __attribute__((__always_inline__))
 _mm256_storeu2_m128i(__m128i* const hi, __m128i* const lo, const __m256i a)
@@ -47,41 +47,18 @@ _mm256_storeu2_m128i(__m128i* const hi, __m128i* const lo, const __m256i a)
 
 namespace quadiron {
 namespace simd {
+inline namespace QUADIRON_SIMD_ISA {
 
 typedef __m256i VecType;
 typedef __m128i HalfVecType;
 
-/* ============= Constant variable  ============ */
-
-// @note: using const leads to an lint error of initialization of 'variable'
-// with static storage duration may throw an exception that cannot be caught
-
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType F4_U32 = _mm256_set1_epi32(65537);
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType F4_MINUS_ONE_U32 = _mm256_set1_epi32(65536);
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType F3_U32 = _mm256_set1_epi32(257);
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType F3_MINUS_ONE_U32 = _mm256_set1_epi32(256);
-
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType F3_U16 = _mm256_set1_epi16(257);
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType F3_MINUS_ONE_U16 = _mm256_set1_epi16(256);
-
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType ZERO = _mm256_setzero_si256();
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType ONE_U16 = _mm256_set1_epi16(1);
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType ONE_U32 = _mm256_set1_epi32(1);
-
-// NOLINTNEXTLINE(cert-err58-cpp)
-const VecType MASK8_LO = _mm256_set1_epi16(0x80);
-
 /* ============= Essential Operations for AVX2 w/ both u16 & u32 ============ */
 
+inline VecType zero()
+{
+    return _mm256_setzero_si256();
+}
+
 inline VecType load_to_reg(VecType* address)
 {
     return _mm256_load_si256(address);
@@ -90,6 +67,14 @@ inline void store_to_mem(VecType* address, VecType reg)
 {
     _mm256_store_si256(address, reg);
 }
+inline VecType loadu_to_reg(VecType* address)
+{
+    return _mm256_loadu_si256(address);
+}
+inline void storeu_to_mem(VecType* address, VecType reg)
+{
+    _mm256_storeu_si256(address, reg);
+}
 
 inline VecType bit_and(VecType x, VecType y)
 {
@@ -109,7 +94,7 @@ inline bool and_is_zero(VecType x, VecType y)
 }
 inline bool is_zero(VecType x)
 {
-    return _mm256_testc_si256(ZERO, x);
+    return _mm256_testc_si256(zero(), x);
 }
 
 #define SHIFTR(x, imm8) (_mm256_srli_si256(x, imm8))
@@ -130,6 +115,11 @@ inline VecType set_one(uint16_t val)
 {
     return _mm256_set1_epi16(val);
 }
+template <>
+inline VecType set_one(uint64_t val)
+{
+    return _mm256_set1_epi64x(val);
+}
 
 template <typename T>
 inline VecType add(VecType x, VecType y);
@@ -143,6 +133,11 @@ inline VecType add<uint16_t>(VecType x, VecType y)
 {
     return _mm256_add_epi16(x, y);
 }
+template <>
+inline VecType add<uint64_t>(VecType x, VecType y)
+{
+    return _mm256_add_epi64(x, y);
+}
 
 template <typename T>
 inline VecType sub(VecType x, VecType y);
@@ -156,6 +151,11 @@ inline VecType sub<uint16_t>(VecType x, VecType y)
 {
     return _mm256_sub_epi16(x, y);
 }
+template <>
+inline VecType sub<uint64_t>(VecType x, VecType y)
+{
+    return _mm256_sub_epi64(x, y);
+}
 
 template <typename T>
 inline VecType mul(VecType x, VecType y);
@@ -170,6 +170,32 @@ inline VecType mul<uint16_t>(VecType x, VecType y)
     return _mm256_mullo_epi16(x, y);
 }
 
+template <typename T>
+inline VecType shift_left(VecType x, unsigned bits);
+template <>
+inline VecType shift_left<uint32_t>(VecType x, unsigned bits)
+{
+    return _mm256_sll_epi32(x, _mm_cvtsi32_si128(bits));
+}
+template <>
+inline VecType shift_left<uint16_t>(VecType x, unsigned bits)
+{
+    return _mm256_sll_epi16(x, _mm_cvtsi32_si128(bits));
+}
+template <>
+inline VecType shift_left<uint64_t>(VecType x, unsigned bits)
+{
+    return _mm256_sll_epi64(x, _mm_cvtsi32_si128(bits));
+}
+
+template <typename T>
+inline VecType shift_right(VecType x, unsigned bits);
+template <>
+inline VecType shift_right<uint64_t>(VecType x, unsigned bits)
+{
+    return _mm256_srl_epi64(x, _mm_cvtsi32_si128(bits));
+}
+
 template <typename T>
 inline VecType compare_eq(VecType x, VecType y);
 template <>
@@ -182,6 +208,11 @@ inline VecType compare_eq<uint16_t>(VecType x, VecType y)
 {
     return _mm256_cmpeq_epi16(x, y);
 }
+template <>
+inline VecType compare_eq<uint64_t>(VecType x, VecType y)
+{
+    return _mm256_cmpeq_epi64(x, y);
+}
 
 template <typename T>
 inline VecType min(VecType x, VecType y);
@@ -196,6 +227,101 @@ inline VecType min<uint16_t>(VecType x, VecType y)
     return _mm256_min_epu16(x, y);
 }
 
+/* ============ Operations on 64-bit Elements for AVX2 ============ */
+
+inline VecType bit_or(VecType x, VecType y)
+{
+    return _mm256_or_si256(x, y);
+}
+/// Bitwise AND of `y` with the complement of `x`.
+inline VecType bit_andnot(VecType x, VecType y)
+{
+    return _mm256_andnot_si256(x, y);
+}
+/// Multiply the low 32 bits of 64-bit elements into 64-bit products.
+inline VecType mul_wide(VecType x, VecType y)
+{
+    return _mm256_mul_epu32(x, y);
+}
+/// Select 64-bit elements of `y` where `mask` is negative, of `x` elsewhere.
+inline VecType blend_neg64(VecType x, VecType y, VecType mask)
+{
+    return _mm256_castpd_si256(_mm256_blendv_pd(
+        _mm256_castsi256_pd(x),
+        _mm256_castsi256_pd(y),
+        _mm256_castsi256_pd(mask)));
+}
+
+/* ===================== Byte Operations for AVX2 ===================== */
+
+// Byte shuffles, packs and unpacks act on each 128-bit lane.
+
+/// Load a table of 16 bytes into each 128-bit lane.
+inline VecType load_table(const uint8_t* table)
+{
+    return _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+}
+/// Look up each byte of `idx` (its 4 low bits) in the table of its lane.
+inline VecType shuffle8(VecType table, VecType idx)
+{
+    return _mm256_shuffle_epi8(table, idx);
+}
+inline VecType unpack_low8(VecType x, VecType y)
+{
+    return _mm256_unpacklo_epi8(x, y);
+}
+inline VecType unpack_high8(VecType x, VecType y)
+{
+    return _mm256_unpackhi_epi8(x, y);
+}
+inline VecType unpack_low64(VecType x, VecType y)
+{
+    return _mm256_unpacklo_epi64(x, y);
+}
+inline VecType unpack_high64(VecType x, VecType y)
+{
+    return _mm256_unpackhi_epi64(x, y);
+}
+inline VecType unpack_low16(VecType x, VecType y)
+{
+    return _mm256_unpacklo_epi16(x, y);
+}
+inline VecType unpack_high16(VecType x, VecType y)
+{
+    return _mm256_unpackhi_epi16(x, y);
+}
+inline VecType unpack_low32(VecType x, VecType y)
+{
+    return _mm256_unpacklo_epi32(x, y);
+}
+inline VecType unpack_high32(VecType x, VecType y)
+{
+    return _mm256_unpackhi_epi32(x, y);
+}
+/// Pack the low byte of the 16-bit elements of `x` then `y`, all below 256.
+inline VecType pack16(VecType x, VecType y)
+{
+    return _mm256_packus_epi16(x, y);
+}
+/// Pack the low 16 bits of the 32-bit elements of `x` then `y`, all below
+/// 2^16.
+inline VecType pack32(VecType x, VecType y)
+{
+    return _mm256_packus_epi32(x, y);
+}
+/// Pack the low 32 bits of the 64-bit elements of `x` then `y`.
+inline VecType pack64(VecType x, VecType y)
+{
+    return _mm256_castps_si256(_mm256_shuffle_ps(
+        _mm256_castsi256_ps(x),
+        _mm256_castsi256_ps(y),
+        _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+#define SHIFTR_U16(x, imm8) (_mm256_srli_epi16(x, imm8))
+
+} // namespace QUADIRON_SIMD_ISA
 } // namespace simd
 } // namespace quadiron
 
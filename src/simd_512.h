@@ -0,0 +1,330 @@
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __QUAD_SIMD_512_H__
+#define __QUAD_SIMD_512_H__
+
+#include <x86intrin.h>
+
+namespace quadiron {
+namespace simd {
+inline namespace QUADIRON_SIMD_ISA {
+
+typedef __m512i VecType;
+typedef __m128i HalfVecType;
+
+/* ========== Essential Operations for AVX-512 w/ both u16 & u32 ========== */
+
+inline VecType zero()
+{
+    return _mm512_setzero_si512();
+}
+
+inline VecType load_to_reg(VecType* address)
+{
+    return _mm512_load_si512(address);
+}
+inline void store_to_mem(VecType* address, VecType reg)
+{
+    _mm512_store_si512(address, reg);
+}
+inline VecType loadu_to_reg(VecType* address)
+{
+    return _mm512_loadu_si512(address);
+}
+inline void storeu_to_mem(VecType* address, VecType reg)
+{
+    _mm512_storeu_si512(address, reg);
+}
+
+inline VecType bit_and(VecType x, VecType y)
+{
+    return _mm512_and_si512(x, y);
+}
+inline VecType bit_xor(VecType x, VecType y)
+{
+    return _mm512_xor_si512(x, y);
+}
+inline uint64_t msb8_mask(VecType x)
+{
+    return _mm512_movepi8_mask(x);
+}
+inline bool and_is_zero(VecType x, VecType y)
+{
+    return _mm512_test_epi64_mask(x, y) == 0;
+}
+inline bool is_zero(VecType x)
+{
+    return _mm512_test_epi64_mask(x, x) == 0;
+}
+
+// Shifts and blends act on each 128-bit lane, as their SSE counterparts.
+#define SHIFTR(x, imm8) (_mm512_bsrli_epi128(x, imm8))
+#define BLEND8(x, y, mask)                                                     \
+    (_mm512_mask_blend_epi8(_mm512_movepi8_mask(mask), x, y))
+#define BLEND16(x, y, imm8)                                                    \
+    (_mm512_mask_blend_epi16(0x01010101U * (imm8), x, y))
+
+/* ================= Essential Operations for AVX-512 ================= */
+
+template <typename T>
+inline VecType set_one(T val);
+template <>
+inline VecType set_one(uint32_t val)
+{
+    return _mm512_set1_epi32(val);
+}
+template <>
+inline VecType set_one(uint16_t val)
+{
+    return _mm512_set1_epi16(val);
+}
+template <>
+inline VecType set_one(uint64_t val)
+{
+    return _mm512_set1_epi64(val);
+}
+
+template <typename T>
+inline VecType add(VecType x, VecType y);
+template <>
+inline VecType add<uint32_t>(VecType x, VecType y)
+{
+    return _mm512_add_epi32(x, y);
+}
+template <>
+inline VecType add<uint16_t>(VecType x, VecType y)
+{
+    return _mm512_add_epi16(x, y);
+}
+template <>
+inline VecType add<uint64_t>(VecType x, VecType y)
+{
+    return _mm512_add_epi64(x, y);
+}
+
+template <typename T>
+inline VecType sub(VecType x, VecType y);
+template <>
+inline VecType sub<uint32_t>(VecType x, VecType y)
+{
+    return _mm512_sub_epi32(x, y);
+}
+template <>
+inline VecType sub<uint16_t>(VecType x, VecType y)
+{
+    return _mm512_sub_epi16(x, y);
+}
+template <>
+inline VecType sub<uint64_t>(VecType x, VecType y)
+{
+    return _mm512_sub_epi64(x, y);
+}
+
+template <typename T>
+inline VecType mul(VecType x, VecType y);
+template <>
+inline VecType mul<uint32_t>(VecType x, VecType y)
+{
+    return _mm512_mullo_epi32(x, y);
+}
+template <>
+inline VecType mul<uint16_t>(VecType x, VecType y)
+{
+    return _mm512_mullo_epi16(x, y);
+}
+
+template <typename T>
+inline VecType shift_left(VecType x, unsigned bits);
+template <>
+inline VecType shift_left<uint32_t>(VecType x, unsigned bits)
+{
+    // Same as `_mm512_sll_epi32` that falsely triggers uninitialized warnings
+    // on GCC 12.
+    return _mm512_maskz_sll_epi32(0xFFFF, x, _mm_cvtsi32_si128(bits));
+}
+template <>
+inline VecType shift_left<uint16_t>(VecType x, unsigned bits)
+{
+    return _mm512_sll_epi16(x, _mm_cvtsi32_si128(bits));
+}
+template <>
+inline VecType shift_left<uint64_t>(VecType x, unsigned bits)
+{
+    // Masked for the same GCC 12 warnings as shift_left<uint32_t>.
+    return _mm512_maskz_sll_epi64(0xFF, x, _mm_cvtsi32_si128(bits));
+}
+
+template <typename T>
+inline VecType shift_right(VecType x, unsigned bits);
+template <>
+inline VecType shift_right<uint64_t>(VecType x, unsigned bits)
+{
+    // Masked for the same GCC 12 warnings as shift_left<uint32_t>.
+    return _mm512_maskz_srl_epi64(0xFF, x, _mm_cvtsi32_si128(bits));
+}
+
+// Comparisons yield mask registers, expanded to all-ones elements so that
+// results combine with the other operations as on SSE and AVX2.
+template <typename T>
+inline VecType compare_eq(VecType x, VecType y);
+template <>
+inline VecType compare_eq<uint32_t>(VecType x, VecType y)
+{
+    return _mm512_maskz_set1_epi32(_mm512_cmpeq_epi32_mask(x, y), -1);
+}
+template <>
+inline VecType compare_eq<uint16_t>(VecType x, VecType y)
+{
+    return _mm512_movm_epi16(_mm512_cmpeq_epi16_mask(x, y));
+}
+template <>
+inline VecType compare_eq<uint64_t>(VecType x, VecType y)
+{
+    return _mm512_maskz_set1_epi64(_mm512_cmpeq_epi64_mask(x, y), -1);
+}
+
+template <typename T>
+inline VecType min(VecType x, VecType y);
+template <>
+inline VecType min<uint32_t>(VecType x, VecType y)
+{
+    // Same as `_mm512_min_epu32` that falsely triggers uninitialized warnings
+    // on GCC 12.
+    return _mm512_maskz_min_epu32(0xFFFF, x, y);
+}
+template <>
+inline VecType min<uint16_t>(VecType x, VecType y)
+{
+    return _mm512_min_epu16(x, y);
+}
+
+/* ============ Operations on 64-bit Elements for AVX-512 ============ */
+
+inline VecType bit_or(VecType x, VecType y)
+{
+    return _mm512_or_si512(x, y);
+}
+/// Bitwise AND of `y` with the complement of `x`.
+inline VecType bit_andnot(VecType x, VecType y)
+{
+    // Masked for the same GCC 12 warnings as shift_left<uint32_t>.
+    return _mm512_maskz_andnot_epi64(0xFF, x, y);
+}
+/// Multiply the low 32 bits of 64-bit elements into 64-bit products.
+inline VecType mul_wide(VecType x, VecType y)
+{
+    // Masked for the same GCC 12 warnings as shift_left<uint32_t>.
+    return _mm512_maskz_mul_epu32(0xFF, x, y);
+}
+/// Select 64-bit elements of `y` where `mask` is negative, of `x` elsewhere.
+inline VecType blend_neg64(VecType x, VecType y, VecType mask)
+{
+    return _mm512_mask_blend_epi64(
+        _mm512_cmplt_epi64_mask(mask, zero()), x, y);
+}
+
+/* =================== Byte Operations for AVX-512 ==================== */
+
+// Byte shuffles, packs and unpacks act on each 128-bit lane. Masked variants
+// are used where unmasked ones falsely trigger uninitialized warnings on GCC
+// 12.
+
+/// Load a table of 16 bytes into each 128-bit lane.
+inline VecType load_table(const uint8_t* table)
+{
+    return _mm512_maskz_broadcast_i32x4(
+        0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+}
+/// Look up each byte of `idx` (its 4 low bits) in the table of its lane.
+inline VecType shuffle8(VecType table, VecType idx)
+{
+    return _mm512_shuffle_epi8(table, idx);
+}
+inline VecType unpack_low8(VecType x, VecType y)
+{
+    return _mm512_unpacklo_epi8(x, y);
+}
+inline VecType unpack_high8(VecType x, VecType y)
+{
+    return _mm512_unpackhi_epi8(x, y);
+}
+inline VecType unpack_low64(VecType x, VecType y)
+{
+    return _mm512_maskz_unpacklo_epi64(0xFF, x, y);
+}
+inline VecType unpack_high64(VecType x, VecType y)
+{
+    return _mm512_maskz_unpackhi_epi64(0xFF, x, y);
+}
+inline VecType unpack_low16(VecType x, VecType y)
+{
+    return _mm512_unpacklo_epi16(x, y);
+}
+inline VecType unpack_high16(VecType x, VecType y)
+{
+    return _mm512_unpackhi_epi16(x, y);
+}
+inline VecType unpack_low32(VecType x, VecType y)
+{
+    return _mm512_maskz_unpacklo_epi32(0xFFFF, x, y);
+}
+inline VecType unpack_high32(VecType x, VecType y)
+{
+    return _mm512_maskz_unpackhi_epi32(0xFFFF, x, y);
+}
+/// Pack the low byte of the 16-bit elements of `x` then `y`, all below 256.
+inline VecType pack16(VecType x, VecType y)
+{
+    return _mm512_packus_epi16(x, y);
+}
+/// Pack the low 16 bits of the 32-bit elements of `x` then `y`, all below
+/// 2^16.
+inline VecType pack32(VecType x, VecType y)
+{
+    return _mm512_packus_epi32(x, y);
+}
+/// Pack the low 32 bits of the 64-bit elements of `x` then `y`.
+inline VecType pack64(VecType x, VecType y)
+{
+    return _mm512_castps_si512(_mm512_maskz_shuffle_ps(
+        0xFFFF,
+        _mm512_castsi512_ps(x),
+        _mm512_castsi512_ps(y),
+        _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+#define SHIFTR_U16(x, imm8) (_mm512_srli_epi16(x, imm8))
+
+} // namespace QUADIRON_SIMD_ISA
+} // namespace simd
+} // namespace quadiron
+
+#endif
@@ -35,18 +35,19 @@
 
 namespace quadiron {
 namespace simd {
+inline namespace QUADIRON_SIMD_ISA {
 
 template <typename T>
 inline VecType card(T q);
 template <>
 inline VecType card<uint16_t>(uint16_t)
 {
-    return F3_U16;
+    return set_one<uint16_t>(F3);
 }
 template <>
 inline VecType card<uint32_t>(uint32_t q)
 {
-    return (q == F3) ? F3_U32 : F4_U32;
+    return set_one<uint32_t>(q);
 }
 
 template <typename T>
@@ -54,25 +55,26 @@ inline VecType card_minus_one(T q);
 template <>
 inline VecType card_minus_one<uint16_t>(uint16_t)
 {
-    return F3_MINUS_ONE_U16;
+    return set_one<uint16_t>(F3 - 1);
 }
 template <>
 inline VecType card_minus_one<uint32_t>(uint32_t q)
 {
-    return (q == F3) ? F3_MINUS_ONE_U32 : F4_MINUS_ONE_U32;
+    return set_one<uint32_t>(q - 1);
 }
 
 template <typename T>
 inline VecType get_low_half(VecType x, T q)
 {
-    return (q == F3) ? BLEND8(ZERO, x, MASK8_LO) : BLEND16(ZERO, x, 0x55);
+    return (q == F3) ? BLEND8(zero(), x, set_one<uint16_t>(0x80))
+                     : BLEND16(zero(), x, 0x55);
 }
 
 template <typename T>
 inline VecType get_high_half(VecType x, T q)
 {
-    return (q == F3) ? BLEND8(ZERO, SHIFTR(x, 1), MASK8_LO)
-                     : BLEND16(ZERO, SHIFTR(x, 2), 0x55);
+    return (q == F3) ? BLEND8(zero(), SHIFTR(x, 1), set_one<uint16_t>(0x80))
+                     : BLEND16(zero(), SHIFTR(x, 2), 0x55);
 }
 
 /* ================= Basic Operations ================= */
@@ -141,6 +143,27 @@ inline VecType mod_mul(VecType x, VecType y, T q)
     return mod_sub(lo, hi, q);
 }
 
+/**
+ * Modular multiplication by a power of two for packed unsigned integers
+ *
+ * The product is reduced as in `mod_mul`, hence it must fit in twice the bits
+ * of the low half, e.g. `x * 2^bits < 2^32` modulo F4. It's cheaper than
+ * `mod_mul` as the multiplication is a shift.
+ *
+ * @param x input register
+ * @param bits exponent of the power of two
+ * @param q modulo
+ * @return (x * 2^bits) mod q
+ */
+template <typename T>
+inline VecType mod_mul_pow2(VecType x, unsigned bits, T q)
+{
+    const VecType res = shift_left<T>(x, bits);
+    const VecType lo = get_low_half(res, q);
+    const VecType hi = get_high_half(res, q);
+    return mod_sub(lo, hi, q);
+}
+
 /**
  * Modular general multiplication for packed unsigned 32-bit integers
  *
@@ -164,8 +187,8 @@ inline VecType mod_mul_safe(VecType x, VecType y, T q)
     if (is_zero(cmp)) {
         return res;
     }
-    return (q == F3) ? bit_xor(res, bit_and(F4_U32, cmp))
-                     : add<T>(res, bit_and(ONE_U32, cmp));
+    return (q == F3) ? bit_xor(res, bit_and(set_one<uint32_t>(F4), cmp))
+                     : add<T>(res, bit_and(set_one<uint32_t>(1), cmp));
 }
 
 /**
@@ -188,13 +211,13 @@ inline void add_props(
 {
     const VecType b = compare_eq<T>(threshold, symb);
     const VecType c = bit_and(mask, b);
-    auto d = msb8_mask(c);
+    uint64_t d = msb8_mask(c);
     const unsigned element_size = sizeof(T);
     while (d > 0) {
-        const unsigned byte_idx = __builtin_ctz(d);
+        const unsigned byte_idx = __builtin_ctzll(d);
         const size_t _offset = offset + byte_idx / element_size;
         props.add(_offset, OOR_MARK);
-        d ^= 1 << byte_idx;
+        d &= d - 1;
     }
 }
 
@@ -327,6 +350,7 @@ inline void neg(size_t len, T* buf, T card)
     }
 }
 
+} // namespace QUADIRON_SIMD_ISA
 } // namespace simd
 } // namespace quadiron
 
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "exceptions.h"
+#include "simd/dispatch.h"
+
+#ifdef QUADIRON_SIMD_DISPATCH
+#include "simd_kernels.h"
+#endif
+
+namespace quadiron {
+namespace simd {
+
+#ifdef QUADIRON_SIMD_DISPATCH
+
+namespace {
+
+/// Return the widest instruction set supported by the CPU.
+InstructionSet cpu_instruction_set()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")
+        && __builtin_cpu_supports("avx512bw")) {
+        return InstructionSet::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::AVX;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return InstructionSet::SSE;
+    }
+    return InstructionSet::NONE;
+}
+
+/// Return the widest instruction set allowed by `QUADIRON_SIMD`.
+InstructionSet env_instruction_set()
+{
+    const char* name = std::getenv("QUADIRON_SIMD");
+
+    if (name == nullptr || *name == '\0'
+        || std::strcmp(name, "avx512") == 0) {
+        return InstructionSet::AVX512;
+    }
+    if (std::strcmp(name, "avx") == 0) {
+        return InstructionSet::AVX;
+    }
+    if (std::strcmp(name, "sse") == 0) {
+        return InstructionSet::SSE;
+    }
+    if (std::strcmp(name, "none") == 0) {
+        return InstructionSet::NONE;
+    }
+    throw InvalidArgument(
+        "QUADIRON_SIMD must be one of none, sse, avx or avx512");
+}
+
+const Kernels& select_kernels(InstructionSet instruction_set)
+{
+    switch (instruction_set) {
+    case InstructionSet::AVX512:
+        return avx512_kernels();
+    case InstructionSet::AVX:
+        return avx_kernels();
+    case InstructionSet::SSE:
+        return sse_kernels();
+    case InstructionSet::NONE:
+        break;
+    }
+    return scalar_kernels();
+}
+
+} // namespace
+
+InstructionSet detect_instruction_set()
+{
+    return std::min(cpu_instruction_set(), env_instruction_set());
+}
+
+const Kernels& get_kernels()
+{
+    static const Kernels& kernels = select_kernels(get_instruction_set());
+
+    return kernels;
+}
+
+#else
+
+InstructionSet detect_instruction_set()
+{
+    return INSTRUCTION_SET;
+}
+
+#endif
+
+InstructionSet get_instruction_set()
+{
+    static const InstructionSet instruction_set = detect_instruction_set();
+
+    return instruction_set;
+}
+
+} // namespace simd
+} // namespace quadiron
@@ -0,0 +1,315 @@
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file simd_dispatch.h
+ *
+ * Operations forwarded to the SIMD kernels of the instruction set detected at
+ * runtime (see simd_kernels.h).
+ *
+ * They have the same signatures as the ones of simd_basic.h, simd_fnt.h,
+ * simd_nf4.h, simd_gf2n.h and simd_prime.h, so that callers don't depend on how
+ * kernels are selected.
+ */
+
+#ifndef __QUAD_SIMD_DISPATCH_H__
+#define __QUAD_SIMD_DISPATCH_H__
+
+#include "simd_kernels.h"
+
+namespace quadiron {
+namespace simd {
+
+/* ==================== Operations for RingModN =================== */
+
+template <typename T>
+inline void mul_coef_to_buf(const T a, T* src, T* dest, size_t len, T card)
+{
+    ring_kernels<T>().mul_coef_to_buf(a, src, dest, len, card);
+}
+
+template <typename T>
+inline void add_two_bufs(T* src, T* dest, size_t len, T card)
+{
+    ring_kernels<T>().add_two_bufs(src, dest, len, card);
+}
+
+template <typename T>
+inline void sub_two_bufs(T* bufa, T* bufb, T* res, size_t len, T card)
+{
+    ring_kernels<T>().sub_two_bufs(bufa, bufb, res, len, card);
+}
+
+template <typename T>
+inline void mul_two_bufs(T* src, T* dest, size_t len, T card)
+{
+    ring_kernels<T>().mul_two_bufs(src, dest, len, card);
+}
+
+template <typename T>
+inline void neg(size_t len, T* buf, T card)
+{
+    ring_kernels<T>().neg(len, buf, card);
+}
+
+// 64-bit words are only supported by the prime kernels
+template <>
+inline void
+add_two_bufs(uint64_t* src, uint64_t* dest, size_t len, uint64_t card)
+{
+    prime_kernels<uint64_t>().add_two_bufs(src, dest, len, card);
+}
+
+template <>
+inline void sub_two_bufs(
+    uint64_t* bufa,
+    uint64_t* bufb,
+    uint64_t* res,
+    size_t len,
+    uint64_t card)
+{
+    prime_kernels<uint64_t>().sub_two_bufs(bufa, bufb, res, len, card);
+}
+
+/* ================= Vectorized Operations for FNT ================= */
+
+template <typename T>
+inline void butterfly_ct_step(
+    vec::Buffers<T>& buf,
+    T r,
+    unsigned start,
+    unsigned m,
+    unsigned step,
+    size_t len,
+    T card)
+{
+    ring_kernels<T>().butterfly_ct_step(
+        buf.get_mem().data(), buf.get_n(), r, start, m, step, len, card);
+}
+
+template <typename T>
+inline void butterfly_ct_radix4_step(
+    vec::Buffers<T>& buf,
+    T r1,
+    T r2,
+    T r3,
+    T j,
+    unsigned start,
+    unsigned m,
+    size_t len,
+    T card)
+{
+    ring_kernels<T>().butterfly_ct_radix4_step(
+        buf.get_mem().data(), buf.get_n(), r1, r2, r3, j, start, m, len, card);
+}
+
+template <typename T>
+inline void butterfly_gs_step(
+    vec::Buffers<T>& buf,
+    T r,
+    unsigned start,
+    unsigned m,
+    size_t len,
+    T card)
+{
+    ring_kernels<T>().butterfly_gs_step(
+        buf.get_mem().data(), buf.get_n(), r, start, m, len, card);
+}
+
+template <typename T>
+inline void butterfly_gs_step_simple(
+    vec::Buffers<T>& buf,
+    T r,
+    unsigned start,
+    unsigned m,
+    size_t len,
+    T card)
+{
+    ring_kernels<T>().butterfly_gs_step_simple(
+        buf.get_mem().data(), buf.get_n(), r, start, m, len, card);
+}
+
+/** Mark the symbols equal to `threshold` as out-of-range.
+ *
+ * Vectors holding such symbols are found by the kernels, which are then
+ * scanned to record each symbol into the properties of its fragment.
+ */
+template <typename T>
+inline void encode_post_process(
+    vec::Buffers<T>& output,
+    std::vector<Properties>& props,
+    off_t offset,
+    unsigned code_len,
+    T threshold,
+    size_t vecs_nb)
+{
+    const RingKernels<T>& kernels = ring_kernels<T>();
+    const size_t vec_size = countof<T>();
+
+    const std::vector<T*>& mem = output.get_mem();
+    for (unsigned frag_id = 0; frag_id < code_len; ++frag_id) {
+        T* buf = mem[frag_id];
+        size_t vec_id = kernels.find_value(buf, 0, vecs_nb, threshold);
+        while (vec_id < vecs_nb) {
+            const size_t begin = vec_id * vec_size;
+            for (size_t i = begin; i < begin + vec_size; ++i) {
+                if (buf[i] == threshold) {
+                    props[frag_id].add(offset + i, OOR_MARK);
+                }
+            }
+            vec_id = kernels.find_value(buf, vec_id + 1, vecs_nb, threshold);
+        }
+    }
+}
+
+/* ==================== Operations for NF4 =================== */
+
+inline __uint128_t expand16(uint16_t* arr, int n)
+{
+    return get_kernels().nf4.expand16(arr, n);
+}
+
+inline __uint128_t expand32(uint32_t* arr, int n)
+{
+    return get_kernels().nf4.expand32(arr, n);
+}
+
+inline __uint128_t add(__uint128_t a, __uint128_t b)
+{
+    return get_kernels().nf4.add(a, b);
+}
+
+inline __uint128_t sub(__uint128_t a, __uint128_t b)
+{
+    return get_kernels().nf4.sub(a, b);
+}
+
+inline __uint128_t mul(__uint128_t a, __uint128_t b)
+{
+    return get_kernels().nf4.mul(a, b);
+}
+
+inline void hadamard_mul(unsigned n, __uint128_t* x, __uint128_t* y)
+{
+    get_kernels().nf4.hadamard_mul(n, x, y);
+}
+
+inline GroupedValues<__uint128_t> unpack(__uint128_t a)
+{
+    return get_kernels().nf4.unpack(a);
+}
+
+inline void unpack(__uint128_t a, GroupedValues<__uint128_t>& b)
+{
+    b = get_kernels().nf4.unpack(a);
+}
+
+inline __uint128_t pack(__uint128_t a)
+{
+    return get_kernels().nf4.pack(a);
+}
+
+inline __uint128_t pack(__uint128_t a, uint32_t flag)
+{
+    return get_kernels().nf4.pack_with_flag(a, flag);
+}
+
+/* ============= Operations for GF(2^8) and GF(2^16) ============= */
+
+inline void gf2n_mul_coef_to_buf(
+    unsigned n,
+    unsigned word_size,
+    const uint8_t* tables,
+    uint8_t* src,
+    uint8_t* dest,
+    size_t len)
+{
+    get_kernels().gf2n.mul_coef_to_buf(n, word_size, tables, src, dest, len);
+}
+
+inline void gf2n_add_two_bufs(uint8_t* src, uint8_t* dest, size_t len)
+{
+    get_kernels().gf2n.add_two_bufs(src, dest, len);
+}
+
+/* ================= Operations for Prime fields ================= */
+
+template <typename T>
+inline void
+mont_mul_coef_to_buf(T a, T* src, T* dest, size_t len, T card, T card_inv)
+{
+    prime_kernels<T>().mul_coef_to_buf(a, src, dest, len, card, card_inv);
+}
+
+template <typename T>
+inline void
+mont_mul_two_bufs(T* src, T* dest, size_t len, T card, T card_inv, T r2)
+{
+    prime_kernels<T>().mul_two_bufs(src, dest, len, card, card_inv, r2);
+}
+
+/* ================ Operations for the Goldilocks field ================ */
+
+inline void goldilocks_mul_coef_to_buf(
+    uint64_t a,
+    uint64_t* src,
+    uint64_t* dest,
+    size_t len)
+{
+    get_kernels().goldilocks.mul_coef_to_buf(a, src, dest, len);
+}
+
+inline void goldilocks_mul_two_bufs(uint64_t* src, uint64_t* dest, size_t len)
+{
+    get_kernels().goldilocks.mul_two_bufs(src, dest, len);
+}
+
+inline void goldilocks_add_two_bufs(uint64_t* src, uint64_t* dest, size_t len)
+{
+    get_kernels().goldilocks.add_two_bufs(src, dest, len);
+}
+
+inline void goldilocks_sub_two_bufs(
+    uint64_t* bufa,
+    uint64_t* bufb,
+    uint64_t* res,
+    size_t len)
+{
+    get_kernels().goldilocks.sub_two_bufs(bufa, bufb, res, len);
+}
+
+inline void goldilocks_neg(size_t len, uint64_t* buf)
+{
+    get_kernels().goldilocks.neg(len, buf);
+}
+
+} // namespace simd
+} // namespace quadiron
+
+#endif
@@ -31,13 +31,39 @@
 #ifndef __QUAD_SIMD_FNT_H__
 #define __QUAD_SIMD_FNT_H__
 
+#include <cassert>
+
 #include <x86intrin.h>
 
 namespace quadiron {
 namespace simd {
+inline namespace QUADIRON_SIMD_ISA {
 
 /* ================= Vectorized Operations ================= */
 
+/**
+ * Multiplication by a twiddle factor
+ *
+ * Twiddle factors equal to 1 or q - 1 don't need any multiplication.
+ *
+ * @param rp1 coefficient `r` plus one
+ * @param c a register stores coefficient `r`
+ * @param x working register
+ * @param q modular
+ * @return r * x
+ */
+template <typename T>
+inline VecType mul_twiddle(T rp1, VecType c, VecType x, T q)
+{
+    if (rp1 == 2) {
+        return x;
+    } else if (rp1 < q) {
+        return mod_mul(c, x, q);
+    } else { // i.e. r == q - 1
+        return mod_neg(x, q);
+    }
+}
+
 /**
  * Butterfly Cooley-Tukey operation
  *
@@ -105,13 +131,7 @@ inline void butterfly_gs(T rp1, VecType c, VecType* x, VecType* y, T q)
 template <typename T>
 inline VecType butterfly_simple_gs(T rp1, VecType c, VecType x, T q)
 {
-    if (rp1 == 2) {
-        return x;
-    } else if (rp1 < q) {
-        return mod_mul(c, x, q);
-    } else {
-        return mod_neg(x, q);
-    }
+    return mul_twiddle(rp1, c, x, q);
 }
 
 /**
@@ -121,7 +141,8 @@ inline VecType butterfly_simple_gs(T rp1, VecType c, VecType x, T q)
  *      P = P + r * Q
  *      Q = P - r * Q
  *
- * @param buf - working buffers
+ * @param mem - working buffers
+ * @param bufs_nb - number of working buffers
  * @param r - coefficient
  * @param start - index of buffer among `m` ones
  * @param m - current group size
@@ -131,7 +152,8 @@ inline VecType butterfly_simple_gs(T rp1, VecType c, VecType x, T q)
  */
 template <typename T>
 inline void butterfly_ct_step(
-    vec::Buffers<T>& buf,
+    T* const* mem,
+    unsigned bufs_nb,
     T r,
     unsigned start,
     unsigned m,
@@ -146,8 +168,6 @@ inline void butterfly_ct_step(
     VecType c = set_one(r);
 
     const size_t end = (len > 1) ? len - 1 : 0;
-    const unsigned bufs_nb = buf.get_n();
-    const std::vector<T*>& mem = buf.get_mem();
     for (unsigned i = start; i < bufs_nb; i += step) {
         VecType x1, y1;
         VecType x2, y2;
@@ -185,25 +205,102 @@ inline void butterfly_ct_step(
     }
 }
 
+/** Coefficients of a radix-4 butterfly, see `butterfly_ct_radix4` */
 template <typename T>
-inline static void do_butterfly_ct_2_layers(
-    const std::vector<T*>& mem,
-    T r1,
-    T r2,
-    T r3,
+struct Radix4Coefs {
+    /**
+     * @param r1 twiddle factor of the 2nd input
+     * @param r2 twiddle factor of the 3rd input
+     * @param r3 twiddle factor of the 4th input, i.e. r1 * r2
+     * @param j 4th root of unity, either 2^h or q - 2^h
+     * @param q Fermat number 2^(2h) + 1
+     */
+    Radix4Coefs(T r1, T r2, T r3, T j, T q)
+        : r1p1(r1 + 1), r2p1(r2 + 1), r3p1(r3 + 1), c1(set_one(r1)),
+          c2(set_one(r2)), c3(set_one(r3)), h(fermat_half_exponent(q)),
+          j_neg(j != (1U << h))
+    {
+        assert(j == (1U << h) || j == q - (1U << h));
+    }
+
+    /// Exponent `h` of the Fermat number `q` = 2^(2h) + 1
+    static unsigned fermat_half_exponent(T q)
+    {
+        // Modular reductions of registers only support F3 and F4.
+        assert(q == F3 || q == F4);
+        unsigned h = 1;
+        while ((1U << (2 * h)) + 1 < q) {
+            ++h;
+        }
+        return h;
+    }
+
+    const T r1p1;
+    const T r2p1;
+    const T r3p1;
+    const VecType c1;
+    const VecType c2;
+    const VecType c3;
+    // `j` is 2^h, or -2^h when `j_neg`
+    const unsigned h;
+    const bool j_neg;
+};
+
+/**
+ * Radix-4 butterfly Cooley-Tukey operation
+ *
+ * It computes two layers of radix-2 butterflies on (x, y, u, v) with three
+ * multiplications by twiddle factors instead of four. The remaining factor is
+ * the 4th root of unity `j`, a power of two for Fermat numbers, hence its
+ * multiplication is a shift:
+ *
+ *      B = r1 * y, C = r2 * u, D = r3 * v
+ *      x <- (x + B) + (C + D)
+ *      u <- (x + B) - (C + D)
+ *      y <- (x - B) + j * (C - D)
+ *      v <- (x - B) - j * (C - D)
+ *
+ * @param coefs twiddle factors and root of unity
+ * @param x working register
+ * @param y working register
+ * @param u working register
+ * @param v working register
+ * @param q modular
+ */
+template <typename T>
+inline void butterfly_ct_radix4(
+    const Radix4Coefs<T>& coefs,
+    VecType* x,
+    VecType* y,
+    VecType* u,
+    VecType* v,
+    T q)
+{
+    const VecType b = mul_twiddle(coefs.r1p1, coefs.c1, *y, q);
+    const VecType c = mul_twiddle(coefs.r2p1, coefs.c2, *u, q);
+    const VecType d = mul_twiddle(coefs.r3p1, coefs.c3, *v, q);
+
+    const VecType s0 = mod_add(*x, b, q);
+    const VecType s1 = mod_sub(*x, b, q);
+    const VecType s2 = mod_add(c, d, q);
+    const VecType diff = coefs.j_neg ? mod_sub(d, c, q) : mod_sub(c, d, q);
+    const VecType s3 = mod_mul_pow2(diff, coefs.h, q);
+
+    *x = mod_add(s0, s2, q);
+    *u = mod_sub(s0, s2, q);
+    *y = mod_add(s1, s3, q);
+    *v = mod_sub(s1, s3, q);
+}
+
+template <typename T>
+inline static void do_butterfly_ct_radix4(
+    T* const* mem,
+    const Radix4Coefs<T>& coefs,
     unsigned start,
     unsigned m,
     size_t len,
     T card)
 {
-    const T r1p1 = r1 + 1;
-    const T r2p1 = r2 + 1;
-    const T r3p1 = r3 + 1;
-
-    VecType c1 = set_one(r1);
-    VecType c2 = set_one(r2);
-    VecType c3 = set_one(r3);
-
     VecType* p = reinterpret_cast<VecType*>(mem[start]);
     VecType* q = reinterpret_cast<VecType*>(mem[start + m]);
     VecType* r = reinterpret_cast<VecType*>(mem[start + 2 * m]);
@@ -211,60 +308,36 @@ inline static void do_butterfly_ct_2_layers(
 
     size_t j = 0;
     const size_t end = (len > 1) ? len - 1 : 0;
-    while (j < end) {
-        // First layer (c1, x, y) & (c1, u, v)
-        VecType x1 = load_to_reg(p);
-        VecType x2 = load_to_reg(p + 1);
-        VecType y1 = load_to_reg(q);
-        VecType y2 = load_to_reg(q + 1);
-
-        butterfly_ct(r1p1, c1, &x1, &y1, card);
-        butterfly_ct(r1p1, c1, &x2, &y2, card);
-
-        VecType u1 = load_to_reg(r);
-        VecType u2 = load_to_reg(r + 1);
-        VecType v1 = load_to_reg(s);
-        VecType v2 = load_to_reg(s + 1);
-
-        butterfly_ct(r1p1, c1, &u1, &v1, card);
-        butterfly_ct(r1p1, c1, &u2, &v2, card);
-
-        // Second layer (c2, x, u) & (c3, y, v)
-        butterfly_ct(r2p1, c2, &x1, &u1, card);
-        butterfly_ct(r2p1, c2, &x2, &u2, card);
+    for (; j < end; j += 2) {
+        VecType x1 = load_to_reg(p + j);
+        VecType x2 = load_to_reg(p + j + 1);
+        VecType y1 = load_to_reg(q + j);
+        VecType y2 = load_to_reg(q + j + 1);
+        VecType u1 = load_to_reg(r + j);
+        VecType u2 = load_to_reg(r + j + 1);
+        VecType v1 = load_to_reg(s + j);
+        VecType v2 = load_to_reg(s + j + 1);
 
-        butterfly_ct(r3p1, c3, &y1, &v1, card);
-        butterfly_ct(r3p1, c3, &y2, &v2, card);
+        butterfly_ct_radix4(coefs, &x1, &y1, &u1, &v1, card);
+        butterfly_ct_radix4(coefs, &x2, &y2, &u2, &v2, card);
 
         // Store back to memory
-        store_to_mem(p, x1);
-        store_to_mem(p + 1, x2);
-        store_to_mem(q, y1);
-        store_to_mem(q + 1, y2);
-
-        store_to_mem(r, u1);
-        store_to_mem(r + 1, u2);
-        store_to_mem(s, v1);
-        store_to_mem(s + 1, v2);
-        p = p + 2;
-        q = q + 2;
-        r = r + 2;
-        s = s + 2;
-        j = j + 2;
-    };
-
+        store_to_mem(p + j, x1);
+        store_to_mem(p + j + 1, x2);
+        store_to_mem(q + j, y1);
+        store_to_mem(q + j + 1, y2);
+        store_to_mem(r + j, u1);
+        store_to_mem(r + j + 1, u2);
+        store_to_mem(s + j, v1);
+        store_to_mem(s + j + 1, v2);
+    }
     for (; j < len; ++j) {
-        // First layer (c1, x, y) & (c1, u, v)
         VecType x1 = load_to_reg(p + j);
         VecType y1 = load_to_reg(q + j);
         VecType u1 = load_to_reg(r + j);
         VecType v1 = load_to_reg(s + j);
 
-        // BUTTERFLY_3_test(c1, &x1, &y1, &u1, &v1, card);
-        butterfly_ct(r1p1, c1, &x1, &y1, card);
-        butterfly_ct(r1p1, c1, &u1, &v1, card);
-        butterfly_ct(r2p1, c2, &x1, &u1, card);
-        butterfly_ct(r3p1, c3, &y1, &v1, card);
+        butterfly_ct_radix4(coefs, &x1, &y1, &u1, &v1, card);
 
         // Store back to memory
         store_to_mem(p + j, x1);
@@ -275,39 +348,36 @@ inline static void do_butterfly_ct_2_layers(
 }
 
 /**
- * Vectorized butterfly CT on two-layers at a time
+ * Vectorized radix-4 butterfly CT step
  *
  * For each quadruple
  * (P, Q, R, S) = (buf[i], buf[i + m], buf[i + 2 * m], buf[i + 3 * m])
- * First layer: butterfly on (P, Q) and (R, S) for step = 2 * m
+ * for step = 4 * m, it computes the two layers of radix-2 butterflies on
+ * (P, Q) & (R, S) then (P, R) & (Q, S) at once (see `butterfly_ct_radix4`):
  *      coef r1 = W[start * n / (2 * m)]
- *      P = P + r1 * Q
- *      Q = P - r1 * Q
- *      R = R + r1 * S
- *      S = R - r1 * S
- * Second layer: butterfly on (P, R) and (Q, S) for step = 4 * m
  *      coef r2 = W[start * n / (4 * m)]
- *      coef r3 = W[(start + m) * n / (4 * m)]
- *      P = P + r2 * R
- *      R = P - r2 * R
- *      Q = Q + r3 * S
- *      S = Q - r3 * S
+ *      coef r3 = r1 * r2 = W[3 * start * n / (4 * m)]
+ *      coef j = W[n / 4]
  *
- * @param buf - working buffers
- * @param r1 - coefficient for the 1st layer
- * @param r2 - 1st coefficient for the 2nd layer
- * @param r3 - 2nd coefficient for the 2nd layer
+ * @param mem - working buffers
+ * @param bufs_nb - number of working buffers
+ * @param r1 - coefficient of Q
+ * @param r2 - coefficient of R
+ * @param r3 - coefficient of S
+ * @param j - 4th root of unity, 2^h or card - 2^h for card = 2^(2h) + 1
  * @param start - index of buffer among `m` ones
  * @param m - current group size
  * @param len - number of vectors per buffer
  * @param card - modulo cardinal
  */
 template <typename T>
-inline void butterfly_ct_two_layers_step(
-    vec::Buffers<T>& buf,
+inline void butterfly_ct_radix4_step(
+    T* const* mem,
+    unsigned bufs_nb,
     T r1,
     T r2,
     T r3,
+    T j,
     unsigned start,
     unsigned m,
     size_t len,
@@ -317,11 +387,10 @@ inline void butterfly_ct_two_layers_step(
         return;
     }
     const unsigned step = m << 2;
-    const unsigned bufs_nb = buf.get_n();
+    const Radix4Coefs<T> coefs(r1, r2, r3, j, card);
 
-    const std::vector<T*>& mem = buf.get_mem();
     for (unsigned i = start; i < bufs_nb; i += step) {
-        do_butterfly_ct_2_layers(mem, r1, r2, r3, i, m, len, card);
+        do_butterfly_ct_radix4(mem, coefs, i, m, len, card);
     }
 }
 
@@ -332,7 +401,8 @@ inline void butterfly_ct_two_layers_step(
  *      P = P + Q
  *      Q = r * (P - Q)
  *
- * @param buf - working buffers
+ * @param mem - working buffers
+ * @param bufs_nb - number of working buffers
  * @param r - coefficient
  * @param start - index of buffer among `m` ones
  * @param m - current group size
@@ -341,7 +411,8 @@ inline void butterfly_ct_two_layers_step(
  */
 template <typename T>
 inline void butterfly_gs_step(
-    vec::Buffers<T>& buf,
+    T* const* mem,
+    unsigned bufs_nb,
     T r,
     unsigned start,
     unsigned m,
@@ -356,8 +427,6 @@ inline void butterfly_gs_step(
     VecType c = set_one(r);
 
     const size_t end = (len > 3) ? len - 3 : 0;
-    const unsigned bufs_nb = buf.get_n();
-    const std::vector<T*>& mem = buf.get_mem();
     for (unsigned i = start; i < bufs_nb; i += step) {
         VecType x1, x2, x3, x4;
         VecType y1, y2, y3, y4;
@@ -409,7 +478,8 @@ inline void butterfly_gs_step(
  * For each pair (P, Q) = (buf[i], buf[i + m]) for step = 2 * m and coef `r`
  *      Q = r * P
  *
- * @param buf - working buffers
+ * @param mem - working buffers
+ * @param bufs_nb - number of working buffers
  * @param r - coefficient
  * @param start - index of buffer among `m` ones
  * @param m - current group size
@@ -418,7 +488,8 @@ inline void butterfly_gs_step(
  */
 template <typename T>
 inline void butterfly_gs_step_simple(
-    vec::Buffers<T>& buf,
+    T* const* mem,
+    unsigned bufs_nb,
     T r,
     unsigned start,
     unsigned m,
@@ -433,8 +504,6 @@ inline void butterfly_gs_step_simple(
     VecType c = set_one(r);
 
     const size_t end = (len > 1) ? len - 1 : 0;
-    const unsigned bufs_nb = buf.get_n();
-    const std::vector<T*>& mem = buf.get_mem();
     for (unsigned i = start; i < bufs_nb; i += step) {
         VecType x1, y1;
         VecType x2, y2;
@@ -464,6 +533,89 @@ inline void butterfly_gs_step_simple(
     }
 }
 
+/**
+ * Find the next vector holding a given value
+ *
+ * @param buf - buffer
+ * @param vec_id - index of the first vector to look at
+ * @param vecs_nb - number of vectors of the buffer
+ * @param value - value to look for
+ * @return index of the first vector from `vec_id` holding `value`, `vecs_nb`
+ *         if there is none
+ */
+template <typename T>
+inline size_t find_value(T* buf, size_t vec_id, size_t vecs_nb, T value)
+{
+    const VecType _value = set_one(value);
+    VecType* _buf = reinterpret_cast<VecType*>(buf);
+
+    for (; vec_id < vecs_nb; ++vec_id) {
+        const VecType a = load_to_reg(_buf + vec_id);
+        if (!is_zero(compare_eq<T>(a, _value))) {
+            return vec_id;
+        }
+    }
+    return vecs_nb;
+}
+
+/* ============= Operations on vec::Buffers ============= */
+
+template <typename T>
+inline void butterfly_ct_step(
+    vec::Buffers<T>& buf,
+    T r,
+    unsigned start,
+    unsigned m,
+    unsigned step,
+    size_t len,
+    T card)
+{
+    butterfly_ct_step(
+        buf.get_mem().data(), buf.get_n(), r, start, m, step, len, card);
+}
+
+template <typename T>
+inline void butterfly_ct_radix4_step(
+    vec::Buffers<T>& buf,
+    T r1,
+    T r2,
+    T r3,
+    T j,
+    unsigned start,
+    unsigned m,
+    size_t len,
+    T card)
+{
+    butterfly_ct_radix4_step(
+        buf.get_mem().data(), buf.get_n(), r1, r2, r3, j, start, m, len, card);
+}
+
+template <typename T>
+inline void butterfly_gs_step(
+    vec::Buffers<T>& buf,
+    T r,
+    unsigned start,
+    unsigned m,
+    size_t len,
+    T card)
+{
+    butterfly_gs_step(
+        buf.get_mem().data(), buf.get_n(), r, start, m, len, card);
+}
+
+template <typename T>
+inline void butterfly_gs_step_simple(
+    vec::Buffers<T>& buf,
+    T r,
+    unsigned start,
+    unsigned m,
+    size_t len,
+    T card)
+{
+    butterfly_gs_step_simple(
+        buf.get_mem().data(), buf.get_n(), r, start, m, len, card);
+}
+
 template <typename T>
 inline void encode_post_process(
     vec::Buffers<T>& output,
@@ -522,6 +674,7 @@ inline void encode_post_process(
     }
 }
 
+} // namespace QUADIRON_SIMD_ISA
 } // namespace simd
 } // namespace quadiron
 
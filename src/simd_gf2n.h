@@ -0,0 +1,294 @@
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __QUAD_SIMD_GF2N_H__
+#define __QUAD_SIMD_GF2N_H__
+
+#include <algorithm>
+#include <cassert>
+
+#include <x86intrin.h>
+
+namespace quadiron {
+namespace simd {
+inline namespace QUADIRON_SIMD_ISA {
+
+/* ================= Operations for GF(2^8) and GF(2^16) ================= */
+
+/** Size of a multiplication table of a coefficient `a` of GF(2^n)
+ *
+ * For the k-th nibble of an element and each byte b of a product, the table
+ * at `(k * n / 8 + b) * GF2N_TABLE_SIZE` holds the byte b of `a * (i << 4k)`
+ * for i = 0, ..., 15, so that a product is the XOR of the lookups of its
+ * nibbles.
+ */
+constexpr unsigned GF2N_TABLE_SIZE = 16;
+
+/// Positions of even bytes followed by odd bytes of a 128-bit lane.
+static const uint8_t SPLIT_BYTES[GF2N_TABLE_SIZE] =
+    {0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15};
+
+/// Pack the low halves of the words of `w` bytes of `x` then `y`.
+inline VecType pack_halves(unsigned w, VecType x, VecType y)
+{
+    switch (w) {
+    case 2:
+        return pack16(x, y);
+    case 4:
+        return pack32(x, y);
+    case 8:
+        return pack64(x, y);
+    default:
+        return unpack_low64(x, y);
+    }
+}
+
+/// Zero-extend the low, or high, half of the words of `w / 2` bytes of `x`
+/// into words of `w` bytes.
+inline VecType widen_halves(unsigned w, VecType x, bool high)
+{
+    switch (w) {
+    case 2:
+        return high ? unpack_high8(x, zero()) : unpack_low8(x, zero());
+    case 4:
+        return high ? unpack_high16(x, zero()) : unpack_low16(x, zero());
+    case 8:
+        return high ? unpack_high32(x, zero()) : unpack_low32(x, zero());
+    default:
+        return high ? unpack_high64(x, zero()) : unpack_low64(x, zero());
+    }
+}
+
+/** Gather the low `E` bytes of the words of `W` bytes of `W / E` registers
+ *
+ * Upper bytes of words must be null. The result holds words of `E` bytes, in
+ * an order that unpack_words reverts.
+ */
+template <unsigned W, unsigned E>
+inline VecType pack_words(VecType* src)
+{
+    VecType x[W / E];
+    for (unsigned i = 0; i < W / E; ++i) {
+        x[i] = load_to_reg(&src[i]);
+    }
+    for (unsigned w = W, n = W / E; w > E; w /= 2, n /= 2) {
+        for (unsigned i = 0; i < n / 2; ++i) {
+            x[i] = pack_halves(w, x[2 * i], x[2 * i + 1]);
+        }
+    }
+    return x[0];
+}
+
+/// Zero-extend the words of `E` bytes of `x` into `W / E` registers of words
+/// of `W` bytes, see pack_words.
+template <unsigned W, unsigned E>
+inline void unpack_words(VecType x, VecType* dest)
+{
+    VecType y[W / E];
+    y[0] = x;
+    for (unsigned w = 2 * E, n = 1; w <= W; w *= 2, n *= 2) {
+        for (unsigned i = n; i-- > 0;) {
+            y[2 * i + 1] = widen_halves(w, y[i], true);
+            y[2 * i] = widen_halves(w, y[i], false);
+        }
+    }
+    for (unsigned i = 0; i < W / E; ++i) {
+        store_to_mem(&dest[i], y[i]);
+    }
+}
+
+/** Multiply each element of GF(2^8) of `src` by the coefficient of `tables`
+ *  and store results into `dest`
+ *
+ * Elements are stored in words of `W` bytes, `len` is the number of bytes.
+ * Only the low byte of words is meaningful: the ones of `W` registers are
+ * gathered into one register, multiplied, and spread back.
+ */
+template <unsigned W>
+inline void gf2n_mul_coef_to_buf8(
+    const uint8_t* tables,
+    uint8_t* src,
+    uint8_t* dest,
+    size_t len)
+{
+    const VecType mask = set_one<uint16_t>(0x0f0f);
+    const VecType tab_lo = load_table(tables);
+    const VecType tab_hi = load_table(tables + GF2N_TABLE_SIZE);
+
+    VecType* _src = reinterpret_cast<VecType*>(src);
+    VecType* _dest = reinterpret_cast<VecType*>(dest);
+    const size_t _len = len / sizeof(VecType) / W * W;
+
+    for (size_t i = 0; i < _len; i += W) {
+        const VecType x = pack_words<W, 1>(&_src[i]);
+        const VecType lo = bit_and(x, mask);
+        const VecType hi = bit_and(SHIFTR_U16(x, 4), mask);
+        unpack_words<W, 1>(
+            bit_xor(shuffle8(tab_lo, lo), shuffle8(tab_hi, hi)), &_dest[i]);
+    }
+    for (size_t i = _len * sizeof(VecType); i < len; i += W) {
+        dest[i] = tables[src[i] & 0x0f]
+                  ^ tables[GF2N_TABLE_SIZE + (src[i] >> 4)];
+        std::fill_n(dest + i + 1, W - 1, 0);
+    }
+}
+
+/** Multiply each element of GF(2^16) of `src` by the coefficient of `tables`
+ *  and store results into `dest`
+ *
+ * Elements are little-endian 16-bit values stored in words of `W` bytes,
+ * `len` is the number of bytes. Low and high bytes of the elements of `W`
+ * registers are gathered into two registers, so that each nibble is looked
+ * up once per byte of the products.
+ */
+template <unsigned W>
+inline void gf2n_mul_coef_to_buf16(
+    const uint8_t* tables,
+    uint8_t* src,
+    uint8_t* dest,
+    size_t len)
+{
+    const VecType mask = set_one<uint16_t>(0x0f0f);
+    const VecType split = load_table(SPLIT_BYTES);
+    VecType tab[8];
+    for (unsigned k = 0; k < 8; ++k) {
+        tab[k] = load_table(tables + k * GF2N_TABLE_SIZE);
+    }
+
+    VecType* _src = reinterpret_cast<VecType*>(src);
+    VecType* _dest = reinterpret_cast<VecType*>(dest);
+    const size_t _len = len / sizeof(VecType) / W * W;
+
+    for (size_t i = 0; i < _len; i += W) {
+        const VecType x = shuffle8(pack_words<W, 2>(&_src[i]), split);
+        const VecType y = shuffle8(pack_words<W, 2>(&_src[i + W / 2]), split);
+        // low and high bytes of the elements of `x` then `y`
+        const VecType lo = unpack_low64(x, y);
+        const VecType hi = unpack_high64(x, y);
+
+        const VecType n0 = bit_and(lo, mask);
+        const VecType n1 = bit_and(SHIFTR_U16(lo, 4), mask);
+        const VecType n2 = bit_and(hi, mask);
+        const VecType n3 = bit_and(SHIFTR_U16(hi, 4), mask);
+
+        const VecType prod_lo = bit_xor(
+            bit_xor(shuffle8(tab[0], n0), shuffle8(tab[2], n1)),
+            bit_xor(shuffle8(tab[4], n2), shuffle8(tab[6], n3)));
+        const VecType prod_hi = bit_xor(
+            bit_xor(shuffle8(tab[1], n0), shuffle8(tab[3], n1)),
+            bit_xor(shuffle8(tab[5], n2), shuffle8(tab[7], n3)));
+
+        unpack_words<W, 2>(unpack_low8(prod_lo, prod_hi), &_dest[i]);
+        unpack_words<W, 2>(unpack_high8(prod_lo, prod_hi), &_dest[i + W / 2]);
+    }
+    for (size_t i = _len * sizeof(VecType); i + 1 < len; i += W) {
+        const uint8_t lo = src[i];
+        const uint8_t hi = src[i + 1];
+        const uint8_t* t = tables;
+        for (unsigned b = 0; b < 2; ++b, t += GF2N_TABLE_SIZE) {
+            dest[i + b] = t[lo & 0x0f] ^ t[2 * GF2N_TABLE_SIZE + (lo >> 4)]
+                          ^ t[4 * GF2N_TABLE_SIZE + (hi & 0x0f)]
+                          ^ t[6 * GF2N_TABLE_SIZE + (hi >> 4)];
+        }
+        std::fill_n(dest + i + 2, W - 2, 0);
+    }
+}
+
+template <unsigned W>
+inline void gf2n_mul_coef_to_words(
+    unsigned n,
+    const uint8_t* tables,
+    uint8_t* src,
+    uint8_t* dest,
+    size_t len)
+{
+    if (n == 8) {
+        gf2n_mul_coef_to_buf8<W>(tables, src, dest, len);
+    } else {
+        gf2n_mul_coef_to_buf16<W>(tables, src, dest, len);
+    }
+}
+
+/** Multiply each element of GF(2^n) of `src` by the coefficient of `tables`
+ *  and store results into `dest`
+ *
+ * @param n - 8 or 16
+ * @param word_size - number of bytes of the words storing elements: 4, 8 or
+ * 16
+ * @param tables - multiplication tables of the coefficient
+ * @param len - number of bytes of `src` and `dest`
+ */
+inline void gf2n_mul_coef_to_buf(
+    unsigned n,
+    unsigned word_size,
+    const uint8_t* tables,
+    uint8_t* src,
+    uint8_t* dest,
+    size_t len)
+{
+    switch (word_size) {
+    case 4:
+        gf2n_mul_coef_to_words<4>(n, tables, src, dest, len);
+        break;
+    case 8:
+        gf2n_mul_coef_to_words<8>(n, tables, src, dest, len);
+        break;
+    default:
+        assert(word_size == 16);
+        gf2n_mul_coef_to_words<16>(n, tables, src, dest, len);
+    }
+}
+
+/** Add (XOR) each byte of `src` to the correspondent one of `dest`.
+ *
+ * Buffers need not be aligned: the bit-matrix coding XORs sub-packets that
+ * start at arbitrary offsets of a packet.
+ */
+inline void gf2n_add_two_bufs(uint8_t* src, uint8_t* dest, size_t len)
+{
+    VecType* _src = reinterpret_cast<VecType*>(src);
+    VecType* _dest = reinterpret_cast<VecType*>(dest);
+    const size_t _len = len / sizeof(VecType);
+
+    for (size_t i = 0; i < _len; ++i) {
+        storeu_to_mem(
+            &_dest[i],
+            bit_xor(loadu_to_reg(&_src[i]), loadu_to_reg(&_dest[i])));
+    }
+    for (size_t i = _len * sizeof(VecType); i < len; ++i) {
+        dest[i] ^= src[i];
+    }
+}
+
+} // namespace QUADIRON_SIMD_ISA
+} // namespace simd
+} // namespace quadiron
+
+#endif
@@ -0,0 +1,313 @@
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file simd_kernels.h
+ *
+ * Tables of the SIMD kernels compiled for each instruction set.
+ *
+ * With `QUADIRON_SIMD_DISPATCH`, the kernels are compiled once per instruction
+ * set (see simd_kernels_*.cpp) and the table of the instruction set detected
+ * at runtime is used by the rest of the library.
+ */
+
+#ifndef __QUAD_SIMD_KERNELS_H__
+#define __QUAD_SIMD_KERNELS_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "arith.h"
+#include "core.h"
+
+namespace quadiron {
+
+namespace vec {
+template <typename T>
+class Buffers;
+} // namespace vec
+
+namespace simd {
+
+/** Kernels operating on 16-bit or 32-bit words modulo a Fermat number. */
+template <typename T>
+struct RingKernels {
+    void (*neg)(size_t len, T* buf, T card);
+    void (*mul_coef_to_buf)(T a, T* src, T* dest, size_t len, T card);
+    void (*add_two_bufs)(T* src, T* dest, size_t len, T card);
+    void (*sub_two_bufs)(T* bufa, T* bufb, T* res, size_t len, T card);
+    void (*mul_two_bufs)(T* src, T* dest, size_t len, T card);
+    void (*butterfly_ct_radix4_step)(
+        T* const* mem,
+        unsigned bufs_nb,
+        T r1,
+        T r2,
+        T r3,
+        T j,
+        unsigned start,
+        unsigned m,
+        size_t len,
+        T card);
+    void (*butterfly_ct_step)(
+        T* const* mem,
+        unsigned bufs_nb,
+        T r,
+        unsigned start,
+        unsigned m,
+        unsigned step,
+        size_t len,
+        T card);
+    void (*butterfly_gs_step)(
+        T* const* mem,
+        unsigned bufs_nb,
+        T r,
+        unsigned start,
+        unsigned m,
+        size_t len,
+        T card);
+    void (*butterfly_gs_step_simple)(
+        T* const* mem,
+        unsigned bufs_nb,
+        T r,
+        unsigned start,
+        unsigned m,
+        size_t len,
+        T card);
+    size_t (*find_value)(T* buf, size_t vec_id, size_t vecs_nb, T value);
+};
+
+/** Kernels operating on 32-bit or 64-bit words modulo an odd number.
+ *
+ * Multiplications use the Montgomery reduction (see simd_prime.h).
+ */
+template <typename T>
+struct PrimeKernels {
+    void (*mul_coef_to_buf)(
+        T a,
+        T* src,
+        T* dest,
+        size_t len,
+        T card,
+        T card_inv);
+    void (*mul_two_bufs)(
+        T* src,
+        T* dest,
+        size_t len,
+        T card,
+        T card_inv,
+        T r2);
+    void (*add_two_bufs)(T* src, T* dest, size_t len, T card);
+    void (*sub_two_bufs)(T* bufa, T* bufb, T* res, size_t len, T card);
+};
+
+/** Kernels operating on elements of GF(2^64 - 2^32 + 1).
+ *
+ * Products are reduced by shifts and subtractions (see simd_prime.h).
+ */
+struct GoldilocksKernels {
+    void (*mul_coef_to_buf)(
+        uint64_t a,
+        uint64_t* src,
+        uint64_t* dest,
+        size_t len);
+    void (*mul_two_bufs)(uint64_t* src, uint64_t* dest, size_t len);
+    void (*add_two_bufs)(uint64_t* src, uint64_t* dest, size_t len);
+    void (*sub_two_bufs)(
+        uint64_t* bufa,
+        uint64_t* bufb,
+        uint64_t* res,
+        size_t len);
+    void (*neg)(size_t len, uint64_t* buf);
+};
+
+/** Kernels operating on packed elements of NF4. */
+struct Nf4Kernels {
+    __uint128_t (*expand16)(uint16_t* arr, int n);
+    __uint128_t (*expand32)(uint32_t* arr, int n);
+    __uint128_t (*add)(__uint128_t a, __uint128_t b);
+    __uint128_t (*sub)(__uint128_t a, __uint128_t b);
+    __uint128_t (*mul)(__uint128_t a, __uint128_t b);
+    void (*hadamard_mul)(unsigned n, __uint128_t* x, __uint128_t* y);
+    GroupedValues<__uint128_t> (*unpack)(__uint128_t a);
+    __uint128_t (*pack)(__uint128_t a);
+    __uint128_t (*pack_with_flag)(__uint128_t a, uint32_t flag);
+};
+
+/** Kernels operating on bytes of elements of GF(2^8) or GF(2^16). */
+struct Gf2nKernels {
+    void (*mul_coef_to_buf)(
+        unsigned n,
+        unsigned word_size,
+        const uint8_t* tables,
+        uint8_t* src,
+        uint8_t* dest,
+        size_t len);
+    void (*add_two_bufs)(uint8_t* src, uint8_t* dest, size_t len);
+};
+
+/** Kernels compiled for a given instruction set. */
+struct Kernels {
+    RingKernels<uint16_t> u16;
+    RingKernels<uint32_t> u32;
+    Nf4Kernels nf4;
+    Gf2nKernels gf2n;
+    PrimeKernels<uint32_t> p32;
+    PrimeKernels<uint64_t> p64;
+    GoldilocksKernels goldilocks;
+};
+
+/// Return the kernels without SIMD instructions.
+const Kernels& scalar_kernels();
+
+/// Return the kernels compiled for SSE4.1.
+const Kernels& sse_kernels();
+
+/// Return the kernels compiled for AVX2.
+const Kernels& avx_kernels();
+
+/// Return the kernels compiled for AVX-512F and AVX-512BW.
+const Kernels& avx512_kernels();
+
+/** Return the kernels of the instruction set the library runs with.
+ *
+ * CPUs supporting none of the compiled instruction sets run the scalar
+ * kernels.
+ */
+const Kernels& get_kernels();
+
+/// Return the ring kernels of the runtime instruction set for words of type T.
+template <typename T>
+const RingKernels<T>& ring_kernels();
+
+template <>
+inline const RingKernels<uint16_t>& ring_kernels()
+{
+    return get_kernels().u16;
+}
+
+template <>
+inline const RingKernels<uint32_t>& ring_kernels()
+{
+    return get_kernels().u32;
+}
+
+/// Return the prime kernels of the runtime instruction set for words of type T.
+template <typename T>
+const PrimeKernels<T>& prime_kernels();
+
+template <>
+inline const PrimeKernels<uint32_t>& prime_kernels()
+{
+    return get_kernels().p32;
+}
+
+template <>
+inline const PrimeKernels<uint64_t>& prime_kernels()
+{
+    return get_kernels().p64;
+}
+
+} // namespace simd
+} // namespace quadiron
+
+// Units compiled for a given instruction set build its table from the kernels
+// of simd.h. The table is constant-initialized, hence no code of the
+// instruction set runs unless the table is selected.
+#if defined(__SSE4_1__)
+
+#include "simd.h"
+
+namespace quadiron {
+namespace simd {
+inline namespace QUADIRON_SIMD_ISA {
+
+template <typename T>
+constexpr RingKernels<T> make_ring_kernels()
+{
+    return {
+        neg<T>,
+        mul_coef_to_buf<T>,
+        add_two_bufs<T>,
+        sub_two_bufs<T>,
+        mul_two_bufs<T>,
+        butterfly_ct_radix4_step<T>,
+        butterfly_ct_step<T>,
+        butterfly_gs_step<T>,
+        butterfly_gs_step_simple<T>,
+        find_value<T>,
+    };
+}
+
+template <typename T>
+constexpr PrimeKernels<T> make_prime_kernels()
+{
+    return {
+        mont_mul_coef_to_buf<T>,
+        mont_mul_two_bufs<T>,
+        add_two_bufs<T>,
+        sub_two_bufs<T>,
+    };
+}
+
+constexpr Kernels KERNELS = {
+    make_ring_kernels<uint16_t>(),
+    make_ring_kernels<uint32_t>(),
+    {
+        expand16,
+        expand32,
+        add,
+        sub,
+        mul,
+        hadamard_mul,
+        unpack,
+        pack,
+        pack,
+    },
+    {
+        gf2n_mul_coef_to_buf,
+        gf2n_add_two_bufs,
+    },
+    make_prime_kernels<uint32_t>(),
+    make_prime_kernels<uint64_t>(),
+    {
+        goldilocks_mul_coef_to_buf,
+        goldilocks_mul_two_bufs,
+        goldilocks_add_two_bufs,
+        goldilocks_sub_two_bufs,
+        goldilocks_neg,
+    },
+};
+
+} // namespace QUADIRON_SIMD_ISA
+} // namespace simd
+} // namespace quadiron
+
+#endif
+
+#endif
@@ -0,0 +1,486 @@
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Kernels without SIMD instructions, for CPUs lacking SSE4.1, see
+// simd_kernels.h. Registers are single elements, as `countof` is 1 then.
+
+#include <algorithm>
+
+#include "simd_kernels.h"
+
+namespace quadiron {
+namespace simd {
+namespace {
+
+/* ==================== Operations for RingModN =================== */
+
+template <typename T>
+inline T mod_add(T x, T y, T card)
+{
+    const T res = x + y;
+    return (res >= card) ? res - card : res;
+}
+
+template <typename T>
+inline T mod_sub(T x, T y, T card)
+{
+    return (x >= y) ? x - y : card - (y - x);
+}
+
+template <typename T>
+inline T mod_mul(T x, T y, T card)
+{
+    return static_cast<T>((DoubleSizeVal<T>(x) * y) % card);
+}
+
+template <typename T>
+void neg(size_t len, T* buf, T card)
+{
+    for (size_t i = 0; i < len; ++i) {
+        if (buf[i]) {
+            buf[i] = card - buf[i];
+        }
+    }
+}
+
+template <typename T>
+void mul_coef_to_buf(T a, T* src, T* dest, size_t len, T card)
+{
+    for (size_t i = 0; i < len; ++i) {
+        dest[i] = mod_mul(a, src[i], card);
+    }
+}
+
+template <typename T>
+void add_two_bufs(T* src, T* dest, size_t len, T card)
+{
+    for (size_t i = 0; i < len; ++i) {
+        dest[i] = mod_add(src[i], dest[i], card);
+    }
+}
+
+template <typename T>
+void sub_two_bufs(T* bufa, T* bufb, T* res, size_t len, T card)
+{
+    for (size_t i = 0; i < len; ++i) {
+        res[i] = mod_sub(bufa[i], bufb[i], card);
+    }
+}
+
+template <typename T>
+void mul_two_bufs(T* src, T* dest, size_t len, T card)
+{
+    for (size_t i = 0; i < len; ++i) {
+        dest[i] = mod_mul(src[i], dest[i], card);
+    }
+}
+
+/* ================= Butterfly Operations for FNT ================= */
+
+template <typename T>
+void butterfly_ct_radix4_step(
+    T* const* mem,
+    unsigned bufs_nb,
+    T r1,
+    T r2,
+    T r3,
+    T j,
+    unsigned start,
+    unsigned m,
+    size_t len,
+    T card)
+{
+    for (unsigned i = start; i < bufs_nb; i += 4 * m) {
+        T* p = mem[i];
+        T* q = mem[i + m];
+        T* r = mem[i + 2 * m];
+        T* s = mem[i + 3 * m];
+        for (size_t k = 0; k < len; ++k) {
+            const T b = mod_mul(r1, q[k], card);
+            const T c = mod_mul(r2, r[k], card);
+            const T d = mod_mul(r3, s[k], card);
+            const T s0 = mod_add(p[k], b, card);
+            const T s1 = mod_sub(p[k], b, card);
+            const T s2 = mod_add(c, d, card);
+            const T s3 = mod_mul(j, mod_sub(c, d, card), card);
+            p[k] = mod_add(s0, s2, card);
+            r[k] = mod_sub(s0, s2, card);
+            q[k] = mod_add(s1, s3, card);
+            s[k] = mod_sub(s1, s3, card);
+        }
+    }
+}
+
+template <typename T>
+void butterfly_ct_step(
+    T* const* mem,
+    unsigned bufs_nb,
+    T r,
+    unsigned start,
+    unsigned m,
+    unsigned step,
+    size_t len,
+    T card)
+{
+    for (unsigned i = start; i < bufs_nb; i += step) {
+        T* p = mem[i];
+        T* q = mem[i + m];
+        for (size_t k = 0; k < len; ++k) {
+            const T z = mod_mul(r, q[k], card);
+            q[k] = mod_sub(p[k], z, card);
+            p[k] = mod_add(p[k], z, card);
+        }
+    }
+}
+
+template <typename T>
+void butterfly_gs_step(
+    T* const* mem,
+    unsigned bufs_nb,
+    T r,
+    unsigned start,
+    unsigned m,
+    size_t len,
+    T card)
+{
+    for (unsigned i = start; i < bufs_nb; i += 2 * m) {
+        T* p = mem[i];
+        T* q = mem[i + m];
+        for (size_t k = 0; k < len; ++k) {
+            const T sum = mod_add(p[k], q[k], card);
+            q[k] = mod_mul(r, mod_sub(p[k], q[k], card), card);
+            p[k] = sum;
+        }
+    }
+}
+
+template <typename T>
+void butterfly_gs_step_simple(
+    T* const* mem,
+    unsigned bufs_nb,
+    T r,
+    unsigned start,
+    unsigned m,
+    size_t len,
+    T card)
+{
+    for (unsigned i = start; i < bufs_nb; i += 2 * m) {
+        mul_coef_to_buf(r, mem[i], mem[i + m], len, card);
+    }
+}
+
+template <typename T>
+size_t find_value(T* buf, size_t vec_id, size_t vecs_nb, T value)
+{
+    return std::find(buf + vec_id, buf + vecs_nb, value) - buf;
+}
+
+template <typename T>
+constexpr RingKernels<T> make_ring_kernels()
+{
+    return {
+        neg<T>,
+        mul_coef_to_buf<T>,
+        add_two_bufs<T>,
+        sub_two_bufs<T>,
+        mul_two_bufs<T>,
+        butterfly_ct_radix4_step<T>,
+        butterfly_ct_step<T>,
+        butterfly_gs_step<T>,
+        butterfly_gs_step_simple<T>,
+        find_value<T>,
+    };
+}
+
+/* ==================== Operations for NF4 =================== */
+
+// Elements of NF4 are four 32-bit values modulo F4, packed values being
+// 16-bit ones.
+
+constexpr uint32_t NF4_CARD = 65537;
+
+inline uint32_t lane(__uint128_t a, unsigned i, unsigned bits)
+{
+    return static_cast<uint32_t>(a >> (i * bits)) & ((1ULL << bits) - 1);
+}
+
+template <typename F>
+inline __uint128_t map_lanes(__uint128_t a, __uint128_t b, F f)
+{
+    __uint128_t c = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        c |= __uint128_t(f(lane(a, i, 32), lane(b, i, 32))) << (32 * i);
+    }
+    return c;
+}
+
+__uint128_t expand16(uint16_t* arr, int n)
+{
+    __uint128_t c = 0;
+    for (int i = 0; i < n; ++i) {
+        c |= __uint128_t(arr[i]) << (16 * i);
+    }
+    return c;
+}
+
+__uint128_t expand32(uint32_t* arr, int n)
+{
+    __uint128_t c = 0;
+    for (int i = 0; i < n; ++i) {
+        c |= __uint128_t(arr[i]) << (32 * i);
+    }
+    return c;
+}
+
+__uint128_t add(__uint128_t a, __uint128_t b)
+{
+    return map_lanes(a, b, [](uint32_t x, uint32_t y) {
+        return mod_add(x, y, NF4_CARD);
+    });
+}
+
+__uint128_t sub(__uint128_t a, __uint128_t b)
+{
+    return map_lanes(a, b, [](uint32_t x, uint32_t y) {
+        return mod_sub(x, y, NF4_CARD);
+    });
+}
+
+__uint128_t mul(__uint128_t a, __uint128_t b)
+{
+    return map_lanes(a, b, [](uint32_t x, uint32_t y) {
+        return mod_mul(x, y, NF4_CARD);
+    });
+}
+
+void hadamard_mul(unsigned n, __uint128_t* x, __uint128_t* y)
+{
+    for (unsigned i = 0; i < n; ++i) {
+        x[i] = mul(x[i], y[i]);
+    }
+}
+
+GroupedValues<__uint128_t> unpack(__uint128_t a)
+{
+    GroupedValues<__uint128_t> b = {0, 0};
+    for (unsigned i = 0; i < 4; ++i) {
+        // 65536, the only value not fitting in 16 bits, is flagged
+        if (lane(a, 2 * i + 1, 16) != 0) {
+            b.flag |= 1U << i;
+        }
+        b.values |= __uint128_t(lane(a, 2 * i, 16)) << (16 * i);
+    }
+    return b;
+}
+
+__uint128_t pack(__uint128_t a)
+{
+    __uint128_t c = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        c |= __uint128_t(lane(a, i, 16)) << (32 * i);
+    }
+    return c;
+}
+
+__uint128_t pack_with_flag(__uint128_t a, uint32_t flag)
+{
+    __uint128_t c = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        const uint32_t value = (flag >> i) & 1 ? 65536 : lane(a, i, 16);
+        c |= __uint128_t(value) << (32 * i);
+    }
+    return c;
+}
+
+/* ============= Operations for GF(2^8) and GF(2^16) ============= */
+
+// Tables are the ones of `gf2n_mul_coef_to_buf`: the table of the k-th nibble
+// and of the b-th byte of the products starts at `(k * n / 8 + b) * 16`.
+void gf2n_mul_coef_to_buf(
+    unsigned n,
+    unsigned word_size,
+    const uint8_t* tables,
+    uint8_t* src,
+    uint8_t* dest,
+    size_t len)
+{
+    const unsigned bytes_nb = n / 8;
+
+    for (size_t i = 0; i + bytes_nb <= len; i += word_size) {
+        uint8_t prod[2] = {0, 0};
+        for (unsigned k = 0; k < 2 * bytes_nb; ++k) {
+            const unsigned nibble = (src[i + k / 2] >> (4 * (k % 2))) & 0x0f;
+            for (unsigned b = 0; b < bytes_nb; ++b) {
+                prod[b] ^= tables[(k * bytes_nb + b) * 16 + nibble];
+            }
+        }
+        std::copy_n(prod, bytes_nb, dest + i);
+        std::fill_n(dest + i + bytes_nb, word_size - bytes_nb, 0);
+    }
+}
+
+void gf2n_add_two_bufs(uint8_t* src, uint8_t* dest, size_t len)
+{
+    for (size_t i = 0; i < len; ++i) {
+        dest[i] ^= src[i];
+    }
+}
+
+/* ================= Operations for Prime fields ================= */
+
+/// Montgomery product of `x` and `y`, see simd_prime.h
+template <typename T>
+inline T mont_mul(T x, T y, T q, T q_inv)
+{
+    const DoubleSizeVal<T> prod = DoubleSizeVal<T>(x) * y;
+    const T m = static_cast<T>(prod) * q_inv;
+    const T res = (prod + DoubleSizeVal<T>(m) * q) >> (sizeof(T) * CHAR_BIT);
+    return (res >= q) ? res - q : res;
+}
+
+template <typename T>
+void mont_mul_coef_to_buf(T a, T* src, T* dest, size_t len, T card, T card_inv)
+{
+    for (size_t i = 0; i < len; ++i) {
+        dest[i] = mont_mul(a, src[i], card, card_inv);
+    }
+}
+
+template <typename T>
+void mont_mul_two_bufs(T* src, T* dest, size_t len, T card, T card_inv, T r2)
+{
+    for (size_t i = 0; i < len; ++i) {
+        const T prod = mont_mul(src[i], dest[i], card, card_inv);
+        dest[i] = mont_mul(prod, r2, card, card_inv);
+    }
+}
+
+template <typename T>
+constexpr PrimeKernels<T> make_prime_kernels()
+{
+    return {
+        mont_mul_coef_to_buf<T>,
+        mont_mul_two_bufs<T>,
+        add_two_bufs<T>,
+        sub_two_bufs<T>,
+    };
+}
+
+/* ================ Operations for the Goldilocks field ================ */
+
+constexpr uint64_t GOLDILOCKS_P = 0xFFFFFFFF00000001ULL;
+
+inline uint64_t goldilocks_mul(uint64_t x, uint64_t y)
+{
+    return static_cast<uint64_t>((__uint128_t(x) * y) % GOLDILOCKS_P);
+}
+
+inline uint64_t goldilocks_add(uint64_t x, uint64_t y)
+{
+    return static_cast<uint64_t>((__uint128_t(x) + y) % GOLDILOCKS_P);
+}
+
+void goldilocks_mul_coef_to_buf(
+    uint64_t a,
+    uint64_t* src,
+    uint64_t* dest,
+    size_t len)
+{
+    for (size_t i = 0; i < len; ++i) {
+        dest[i] = goldilocks_mul(a, src[i]);
+    }
+}
+
+void goldilocks_mul_two_bufs(uint64_t* src, uint64_t* dest, size_t len)
+{
+    for (size_t i = 0; i < len; ++i) {
+        dest[i] = goldilocks_mul(src[i], dest[i]);
+    }
+}
+
+void goldilocks_add_two_bufs(uint64_t* src, uint64_t* dest, size_t len)
+{
+    for (size_t i = 0; i < len; ++i) {
+        dest[i] = goldilocks_add(src[i], dest[i]);
+    }
+}
+
+void goldilocks_sub_two_bufs(
+    uint64_t* bufa,
+    uint64_t* bufb,
+    uint64_t* res,
+    size_t len)
+{
+    sub_two_bufs(bufa, bufb, res, len, GOLDILOCKS_P);
+}
+
+void goldilocks_neg(size_t len, uint64_t* buf)
+{
+    neg(len, buf, GOLDILOCKS_P);
+}
+
+constexpr Kernels KERNELS = {
+    make_ring_kernels<uint16_t>(),
+    make_ring_kernels<uint32_t>(),
+    {
+        expand16,
+        expand32,
+        add,
+        sub,
+        mul,
+        hadamard_mul,
+        unpack,
+        pack,
+        pack_with_flag,
+    },
+    {
+        gf2n_mul_coef_to_buf,
+        gf2n_add_two_bufs,
+    },
+    make_prime_kernels<uint32_t>(),
+    make_prime_kernels<uint64_t>(),
+    {
+        goldilocks_mul_coef_to_buf,
+        goldilocks_mul_two_bufs,
+        goldilocks_add_two_bufs,
+        goldilocks_sub_two_bufs,
+        goldilocks_neg,
+    },
+};
+
+} // namespace
+
+const Kernels& scalar_kernels()
+{
+    return KERNELS;
+}
+
+} // namespace simd
+} // namespace quadiron
@@ -37,6 +37,7 @@
 
 namespace quadiron {
 namespace simd {
+inline namespace QUADIRON_SIMD_ISA {
 
 typedef uint32_t aint32 __attribute__((aligned(ALIGNMENT)));
 
@@ -53,7 +54,9 @@ inline __uint128_t expand16(uint16_t* arr, int n)
 {
     // since n <= 4
     uint16_t _arr[4] __attribute__((aligned(ALIGNMENT))) = {0, 0, 0, 0};
-    std::copy_n(arr, n, _arr);
+    for (int i = 0; i < n; ++i) {
+        _arr[i] = arr[i];
+    }
 
     __m128i b = _mm_set_epi16(0, 0, 0, 0, _arr[3], _arr[2], _arr[1], _arr[0]);
 
@@ -64,7 +67,9 @@ inline __uint128_t expand32(uint32_t* arr, int n)
 {
     // since n <= 4
     uint32_t _arr[4] __attribute__((aligned(simd::ALIGNMENT))) = {0, 0, 0, 0};
-    std::copy_n(arr, n, _arr);
+    for (int i = 0; i < n; ++i) {
+        _arr[i] = arr[i];
+    }
 
     __m128i b = _mm_set_epi32(_arr[3], _arr[2], _arr[1], _arr[0]);
 
@@ -157,17 +162,25 @@ inline __uint128_t pack(__uint128_t a, uint32_t flag)
 
 /* ================= Basic operations for NF4 ================= */
 
-#if defined(__AVX2__)
+#if defined(__AVX512F__) && defined(__AVX512BW__)
 
+// Masked moves of the low 128 bits of the registers (casts falsely trigger
+// uninitialized warnings on GCC 12).
 inline VecType load_to_reg(HalfVecType x)
 {
-    return _mm256_castsi128_si256(_mm_load_si128(&x));
+    return _mm512_maskz_loadu_epi32(0xF, &x);
 }
 
-inline VecType load_to_reg(__uint128_t x)
+inline void store_low_half_to_mem(HalfVecType* address, VecType reg)
 {
-    const HalfVecType* _x = reinterpret_cast<const HalfVecType*>(&x);
-    return load_to_reg(*_x);
+    _mm512_mask_storeu_epi32(address, 0xF, reg);
+}
+
+#elif defined(__AVX2__)
+
+inline VecType load_to_reg(HalfVecType x)
+{
+    return _mm256_castsi128_si256(_mm_load_si128(&x));
 }
 
 inline void store_low_half_to_mem(HalfVecType* address, VecType reg)
@@ -175,6 +188,16 @@ inline void store_low_half_to_mem(HalfVecType* address, VecType reg)
     _mm_store_si128(address, _mm256_castsi256_si128(reg));
 }
 
+#endif
+
+#if defined(__AVX2__)
+
+inline VecType load_to_reg(__uint128_t x)
+{
+    const HalfVecType* _x = reinterpret_cast<const HalfVecType*>(&x);
+    return load_to_reg(*_x);
+}
+
 inline __uint128_t add(__uint128_t a, __uint128_t b)
 {
     HalfVecType res;
@@ -363,6 +386,7 @@ inline void hadamard_mul(unsigned n, __uint128_t* _x, __uint128_t* _y)
     }
 }
 
+} // namespace QUADIRON_SIMD_ISA
 } // namespace simd
 } // namespace quadiron
 
@@ -0,0 +1,483 @@
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __QUAD_SIMD_PRIME_H__
+#define __QUAD_SIMD_PRIME_H__
+
+#include <x86intrin.h>
+
+namespace quadiron {
+namespace simd {
+inline namespace QUADIRON_SIMD_ISA {
+
+/* ================= Operations for Montgomery Arithmetic ================= */
+
+// Elements of 32-bit or 64-bit words are multiplied modulo an odd `q` by the
+// Montgomery reduction, with R = 2^32 or 2^64: `mont_mul(x, y)` returns
+// x * y / R mod q. Knowing `q_inv` = -1/q mod R, it only needs products and
+// shifts instead of a division. Intermediate values stay below R if q < R / 2.
+
+/// Montgomery product of the scalars `x` and `y`, lower than `q`
+template <typename T>
+inline T mont_mul(T x, T y, T q, T q_inv)
+{
+    const DoubleSizeVal<T> prod = DoubleSizeVal<T>(x) * y;
+    const T m = static_cast<T>(prod) * q_inv;
+    const T res = (prod + DoubleSizeVal<T>(m) * q) >> (sizeof(T) * CHAR_BIT);
+    return (res >= q) ? res - q : res;
+}
+
+/** Montgomery product of the low 32 bits of 64-bit elements
+ *
+ * @return the product in the low 32 bits, lower than 2q, and zeros above
+ */
+inline VecType mont_mul_wide(VecType x, VecType y, VecType q, VecType q_inv)
+{
+    const VecType prod = mul_wide(x, y);
+    const VecType m = mul_wide(prod, q_inv);
+    return shift_right<uint64_t>(add<uint64_t>(prod, mul_wide(m, q)), 32);
+}
+
+/** Full product of 64-bit elements from their 32-bit halves
+ *
+ * @param x input register
+ * @param y input register
+ * @param lo low 64 bits of the products
+ * @param hi high 64 bits of the products
+ */
+inline void mul_full(VecType x, VecType y, VecType& lo, VecType& hi)
+{
+    const VecType mask = set_one<uint64_t>(0xFFFFFFFF);
+    const VecType x_hi = shift_right<uint64_t>(x, 32);
+    const VecType y_hi = shift_right<uint64_t>(y, 32);
+
+    const VecType p00 = mul_wide(x, y);
+    const VecType p01 = mul_wide(x, y_hi);
+    const VecType p10 = mul_wide(x_hi, y);
+    const VecType p11 = mul_wide(x_hi, y_hi);
+
+    // sum of the 32-bit terms of weight 2^32, it doesn't overflow
+    const VecType mid = add<uint64_t>(
+        add<uint64_t>(shift_right<uint64_t>(p00, 32), bit_and(p01, mask)),
+        bit_and(p10, mask));
+
+    lo = bit_or(bit_and(p00, mask), shift_left<uint64_t>(mid, 32));
+    hi = add<uint64_t>(
+        add<uint64_t>(p11, shift_right<uint64_t>(p01, 32)),
+        add<uint64_t>(
+            shift_right<uint64_t>(p10, 32), shift_right<uint64_t>(mid, 32)));
+}
+
+/// Low 64 bits of the products of 64-bit elements
+inline VecType mul_low(VecType x, VecType y)
+{
+    const VecType cross = add<uint64_t>(
+        mul_wide(x, shift_right<uint64_t>(y, 32)),
+        mul_wide(shift_right<uint64_t>(x, 32), y));
+    return add<uint64_t>(mul_wide(x, y), shift_left<uint64_t>(cross, 32));
+}
+
+/**
+ * Montgomery multiplication for packed unsigned integers
+ *
+ * @param x input register, elements lower than `q`
+ * @param y input register, elements lower than `q`
+ * @param q modulo, odd and lower than R / 2
+ * @param q_inv -1/q mod R
+ * @return (x * y / R) mod q
+ */
+template <typename T>
+inline VecType mont_mul(VecType x, VecType y, VecType q, VecType q_inv);
+
+template <>
+inline VecType
+mont_mul<uint32_t>(VecType x, VecType y, VecType q, VecType q_inv)
+{
+    // even and odd elements are multiplied as 64-bit elements
+    const VecType even = mont_mul_wide(x, y, q, q_inv);
+    const VecType odd = mont_mul_wide(
+        shift_right<uint64_t>(x, 32), shift_right<uint64_t>(y, 32), q, q_inv);
+    const VecType res = bit_or(even, shift_left<uint64_t>(odd, 32));
+    return min<uint32_t>(res, sub<uint32_t>(res, q));
+}
+
+template <>
+inline VecType
+mont_mul<uint64_t>(VecType x, VecType y, VecType q, VecType q_inv)
+{
+    VecType lo, hi;
+    mul_full(x, y, lo, hi);
+
+    VecType mq_lo, mq_hi;
+    mul_full(mul_low(lo, q_inv), q, mq_lo, mq_hi);
+
+    // low halves sum to 0 mod R: there is a carry unless both are zero, in
+    // which case the comparison yields -1
+    const VecType no_carry = compare_eq<uint64_t>(lo, zero());
+    const VecType res = add<uint64_t>(
+        add<uint64_t>(add<uint64_t>(hi, mq_hi), set_one<uint64_t>(1)),
+        no_carry);
+    const VecType reduced = sub<uint64_t>(res, q);
+    return blend_neg64(reduced, res, reduced);
+}
+
+/**
+ * Modular addition for packed unsigned 64-bit integers
+ *
+ * @param x input register
+ * @param y input register
+ * @param q modulo, lower than 2^63
+ * @return (x + y) mod q
+ */
+template <>
+inline VecType mod_add<uint64_t>(VecType x, VecType y, uint64_t q)
+{
+    const VecType res = add<uint64_t>(x, y);
+    const VecType reduced = sub<uint64_t>(res, set_one(q));
+    return blend_neg64(reduced, res, reduced);
+}
+
+/**
+ * Modular subtraction for packed unsigned 64-bit integers
+ *
+ * @param x input register
+ * @param y input register
+ * @param q modulo, lower than 2^63
+ * @return (x - y) mod q
+ */
+template <>
+inline VecType mod_sub<uint64_t>(VecType x, VecType y, uint64_t q)
+{
+    const VecType res = sub<uint64_t>(x, y);
+    return blend_neg64(res, add<uint64_t>(res, set_one(q)), res);
+}
+
+/* ================ Operations for Prime fields ================ */
+
+/** Perform a Montgomery multiplication of a coefficient `a` to each element of
+ *  `src` and store results into `dest`
+ *
+ * @note: `a` is in Montgomery form, i.e. a * R mod card, so that the results
+ * are in the natural form.
+ */
+template <typename T>
+inline void
+mont_mul_coef_to_buf(T a, T* src, T* dest, size_t len, T card, T card_inv)
+{
+    const VecType coef = set_one(a);
+    const VecType q = set_one(card);
+    const VecType q_inv = set_one(card_inv);
+
+    VecType* _src = reinterpret_cast<VecType*>(src);
+    VecType* _dest = reinterpret_cast<VecType*>(dest);
+    const unsigned ratio = sizeof(*_src) / sizeof(*src);
+    const size_t _len = len / ratio;
+    const size_t _last_len = len - _len * ratio;
+
+    size_t i = 0;
+    const size_t end = (_len > 3) ? _len - 3 : 0;
+    for (; i < end; i += 4) {
+        _dest[i] = mont_mul<T>(coef, _src[i], q, q_inv);
+        _dest[i + 1] = mont_mul<T>(coef, _src[i + 1], q, q_inv);
+        _dest[i + 2] = mont_mul<T>(coef, _src[i + 2], q, q_inv);
+        _dest[i + 3] = mont_mul<T>(coef, _src[i + 3], q, q_inv);
+    }
+    for (; i < _len; ++i) {
+        _dest[i] = mont_mul<T>(coef, _src[i], q, q_inv);
+    }
+
+    if (_last_len > 0) {
+        for (size_t i = _len * ratio; i < len; i++) {
+            dest[i] = mont_mul(a, src[i], card, card_inv);
+        }
+    }
+}
+
+/** Perform an element-wise multiplication of `src` and `dest` and store
+ *  results into `dest`
+ *
+ * @note: products are brought back to the natural form by a second Montgomery
+ * multiplication by `r2` = R^2 mod card.
+ */
+template <typename T>
+inline void
+mont_mul_two_bufs(T* src, T* dest, size_t len, T card, T card_inv, T r2)
+{
+    const VecType q = set_one(card);
+    const VecType q_inv = set_one(card_inv);
+    const VecType _r2 = set_one(r2);
+
+    VecType* _src = reinterpret_cast<VecType*>(src);
+    VecType* _dest = reinterpret_cast<VecType*>(dest);
+    const unsigned ratio = sizeof(*_src) / sizeof(*src);
+    const size_t _len = len / ratio;
+    const size_t _last_len = len - _len * ratio;
+
+    size_t i;
+    for (i = 0; i < _len; i++) {
+        const VecType prod = mont_mul<T>(_src[i], _dest[i], q, q_inv);
+        _dest[i] = mont_mul<T>(prod, _r2, q, q_inv);
+    }
+    if (_last_len > 0) {
+        for (i = _len * ratio; i < len; i++) {
+            const T prod = mont_mul(src[i], dest[i], card, card_inv);
+            dest[i] = mont_mul(prod, r2, card, card_inv);
+        }
+    }
+}
+
+/* ================ Operations for the Goldilocks field ================ */
+
+// Elements of GF(p) with p = 2^64 - 2^32 + 1 are reduced without product by
+// the modulus, as 2^64 = 2^32 - 1 mod p and 2^96 = -1 mod p. As p > 2^63,
+// overflows of sums and differences are found from the most significant bit
+// of bitwise expressions, since SSE4.1 has no unsigned 64-bit comparison.
+
+constexpr uint64_t GOLDILOCKS_P = 0xFFFFFFFF00000001ULL;
+constexpr uint64_t GOLDILOCKS_EPS = 0xFFFFFFFFULL; // 2^64 mod p
+
+/// Mask whose 64-bit elements are negative where `s` = x + y overflowed
+inline VecType carry64(VecType x, VecType y, VecType s)
+{
+    return bit_or(bit_and(x, y), bit_andnot(s, bit_or(x, y)));
+}
+
+/// Mask whose 64-bit elements are negative where `d` = x - y underflowed
+inline VecType borrow64(VecType x, VecType y, VecType d)
+{
+    return bit_or(bit_andnot(x, y), bit_andnot(bit_xor(x, y), d));
+}
+
+/// Reduction of the 128-bit value `hi` * 2^64 + `lo`, lower than p
+inline uint64_t goldilocks_reduce(uint64_t lo, uint64_t hi)
+{
+    const uint64_t hi_hi = hi >> 32;
+    const uint64_t hi_lo = hi & GOLDILOCKS_EPS;
+
+    // hi_hi * 2^96 = -hi_hi
+    uint64_t t0 = lo - hi_hi;
+    if (lo < hi_hi) {
+        t0 -= GOLDILOCKS_EPS;
+    }
+    // hi_lo * 2^64 = hi_lo * (2^32 - 1), that doesn't overflow
+    const uint64_t t1 = (hi_lo << 32) - hi_lo;
+    uint64_t res = t0 + t1;
+    if (res < t1) {
+        res += GOLDILOCKS_EPS;
+    }
+    return (res >= GOLDILOCKS_P) ? res - GOLDILOCKS_P : res;
+}
+
+inline uint64_t goldilocks_mul(uint64_t x, uint64_t y)
+{
+    const __uint128_t prod = __uint128_t(x) * y;
+    return goldilocks_reduce(
+        static_cast<uint64_t>(prod), static_cast<uint64_t>(prod >> 64));
+}
+
+inline uint64_t goldilocks_add(uint64_t x, uint64_t y)
+{
+    const uint64_t res = x + y;
+    // x + y - p, either after an overflow or if x + y >= p
+    const uint64_t reduced = res + GOLDILOCKS_EPS;
+    return (res < x || reduced < res) ? reduced : res;
+}
+
+inline uint64_t goldilocks_sub(uint64_t x, uint64_t y)
+{
+    const uint64_t res = x - y;
+    return (x < y) ? res - GOLDILOCKS_EPS : res;
+}
+
+/**
+ * Reduction of packed 128-bit values modulo p
+ *
+ * @param lo low 64 bits of the values
+ * @param hi high 64 bits of the values
+ * @return the values modulo p
+ */
+inline VecType goldilocks_reduce(VecType lo, VecType hi)
+{
+    const VecType eps = set_one(GOLDILOCKS_EPS);
+    const VecType hi_hi = shift_right<uint64_t>(hi, 32);
+    const VecType hi_lo = bit_and(hi, eps);
+
+    const VecType d = sub<uint64_t>(lo, hi_hi);
+    const VecType t0 =
+        blend_neg64(d, sub<uint64_t>(d, eps), borrow64(lo, hi_hi, d));
+    const VecType t1 = sub<uint64_t>(shift_left<uint64_t>(hi_lo, 32), hi_lo);
+    const VecType s = add<uint64_t>(t0, t1);
+    const VecType res =
+        blend_neg64(s, add<uint64_t>(s, eps), carry64(t0, t1, s));
+
+    const VecType reduced = add<uint64_t>(res, eps);
+    return blend_neg64(res, reduced, carry64(res, eps, reduced));
+}
+
+/// Products of packed elements modulo p
+inline VecType goldilocks_mul(VecType x, VecType y)
+{
+    VecType lo, hi;
+    mul_full(x, y, lo, hi);
+    return goldilocks_reduce(lo, hi);
+}
+
+/// Sums of packed elements modulo p
+inline VecType goldilocks_add(VecType x, VecType y)
+{
+    const VecType eps = set_one(GOLDILOCKS_EPS);
+    const VecType res = add<uint64_t>(x, y);
+    const VecType reduced = add<uint64_t>(res, eps);
+    const VecType mask =
+        bit_or(carry64(x, y, res), carry64(res, eps, reduced));
+    return blend_neg64(res, reduced, mask);
+}
+
+/// Differences of packed elements modulo p
+inline VecType goldilocks_sub(VecType x, VecType y)
+{
+    const VecType res = sub<uint64_t>(x, y);
+    return blend_neg64(
+        res,
+        sub<uint64_t>(res, set_one(GOLDILOCKS_EPS)),
+        borrow64(x, y, res));
+}
+
+/** Multiply a coefficient `a` to each element of `src` and store results into
+ *  `dest`, modulo p
+ */
+inline void goldilocks_mul_coef_to_buf(
+    uint64_t a,
+    uint64_t* src,
+    uint64_t* dest,
+    size_t len)
+{
+    const VecType coef = set_one(a);
+
+    VecType* _src = reinterpret_cast<VecType*>(src);
+    VecType* _dest = reinterpret_cast<VecType*>(dest);
+    const unsigned ratio = sizeof(*_src) / sizeof(*src);
+    const size_t _len = len / ratio;
+
+    size_t i = 0;
+    const size_t end = (_len > 3) ? _len - 3 : 0;
+    for (; i < end; i += 4) {
+        _dest[i] = goldilocks_mul(coef, _src[i]);
+        _dest[i + 1] = goldilocks_mul(coef, _src[i + 1]);
+        _dest[i + 2] = goldilocks_mul(coef, _src[i + 2]);
+        _dest[i + 3] = goldilocks_mul(coef, _src[i + 3]);
+    }
+    for (; i < _len; ++i) {
+        _dest[i] = goldilocks_mul(coef, _src[i]);
+    }
+    for (i = _len * ratio; i < len; i++) {
+        dest[i] = goldilocks_mul(a, src[i]);
+    }
+}
+
+/** Perform an element-wise multiplication of `src` and `dest` and store
+ *  results into `dest`, modulo p
+ */
+inline void goldilocks_mul_two_bufs(uint64_t* src, uint64_t* dest, size_t len)
+{
+    VecType* _src = reinterpret_cast<VecType*>(src);
+    VecType* _dest = reinterpret_cast<VecType*>(dest);
+    const unsigned ratio = sizeof(*_src) / sizeof(*src);
+    const size_t _len = len / ratio;
+
+    size_t i;
+    for (i = 0; i < _len; i++) {
+        _dest[i] = goldilocks_mul(_src[i], _dest[i]);
+    }
+    for (i = _len * ratio; i < len; i++) {
+        dest[i] = goldilocks_mul(src[i], dest[i]);
+    }
+}
+
+/// Add `src` to `dest`, modulo p
+inline void goldilocks_add_two_bufs(uint64_t* src, uint64_t* dest, size_t len)
+{
+    VecType* _src = reinterpret_cast<VecType*>(src);
+    VecType* _dest = reinterpret_cast<VecType*>(dest);
+    const unsigned ratio = sizeof(*_src) / sizeof(*src);
+    const size_t _len = len / ratio;
+
+    size_t i;
+    for (i = 0; i < _len; i++) {
+        _dest[i] = goldilocks_add(_src[i], _dest[i]);
+    }
+    for (i = _len * ratio; i < len; i++) {
+        dest[i] = goldilocks_add(src[i], dest[i]);
+    }
+}
+
+/// Store `bufa` - `bufb` into `res`, modulo p
+inline void goldilocks_sub_two_bufs(
+    uint64_t* bufa,
+    uint64_t* bufb,
+    uint64_t* res,
+    size_t len)
+{
+    VecType* _bufa = reinterpret_cast<VecType*>(bufa);
+    VecType* _bufb = reinterpret_cast<VecType*>(bufb);
+    VecType* _res = reinterpret_cast<VecType*>(res);
+    const unsigned ratio = sizeof(*_bufa) / sizeof(*bufa);
+    const size_t _len = len / ratio;
+
+    size_t i;
+    for (i = 0; i < _len; i++) {
+        _res[i] = goldilocks_sub(_bufa[i], _bufb[i]);
+    }
+    for (i = _len * ratio; i < len; i++) {
+        res[i] = goldilocks_sub(bufa[i], bufb[i]);
+    }
+}
+
+/// Negate each element of `buf`, modulo p
+inline void goldilocks_neg(size_t len, uint64_t* buf)
+{
+    VecType* _buf = reinterpret_cast<VecType*>(buf);
+    const unsigned ratio = sizeof(*_buf) / sizeof(*buf);
+    const size_t _len = len / ratio;
+
+    size_t i;
+    for (i = 0; i < _len; i++) {
+        _buf[i] = goldilocks_sub(zero(), _buf[i]);
+    }
+    for (i = _len * ratio; i < len; i++) {
+        buf[i] = goldilocks_sub(0, buf[i]);
+    }
+}
+
+} // namespace QUADIRON_SIMD_ISA
+} // namespace simd
+} // namespace quadiron
+
+#endif
@@ -117,6 +117,7 @@ class Buffers final {
     const T* get(int i) const;
     const std::vector<T*>& get_mem() const;
     void set_mem(std::vector<T*>* mem);
+    void set_view(const std::vector<T*>& mem, size_t offset, size_t size);
     void copy(const Buffers<T>& v);
     void copy(int i, T* buf);
     void separate_even_odd();
@@ -408,6 +409,30 @@ inline void Buffers<T>::set_mem(std::vector<T*>* mem)
     this->mem = mem;
 }
 
+/**
+ * Point to a range of symbols of other buffers
+ *
+ * It allows walking through tiles of buffers with a single view.
+ *
+ * @param mem - the `n` other buffers
+ * @param offset - index of the first symbol of the range
+ * @param size - number of symbols of the range
+ */
+template <typename T>
+inline void
+Buffers<T>::set_view(const std::vector<T*>& mem, size_t offset, size_t size)
+{
+    // the view must not own the buffers it points to
+    assert(mem_alloc_case == BufMemAlloc::NONE);
+    assert(mem.size() >= static_cast<size_t>(n));
+
+    for (int i = 0; i < n; i++) {
+        this->mem[i] = mem[i] + offset;
+    }
+    this->size = size;
+    this->mem_len = n * size;
+}
+
 template <typename T>
 void Buffers<T>::copy(const Buffers<T>& v)
 {
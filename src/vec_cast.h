@@ -36,8 +36,11 @@
 #include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <utility>
 #include <vector>
 
+#include <sys/types.h>
+
 #include "vec_vector.h"
 
 namespace quadiron {
@@ -57,6 +60,31 @@ inline void pack_next(
     }
 }
 
+/*
+ * Copy words of `word_size` bytes, that no integer type matches, from byte
+ * buffers of source to buffers of destination
+ */
+template <typename Ts, typename Td>
+inline void pack_bytes(
+    const std::vector<Ts*>& src,
+    const std::vector<Td*>& dest,
+    int n,
+    size_t size,
+    size_t word_size)
+{
+    for (int i = 0; i < n; i++) {
+        const uint8_t* tmp = reinterpret_cast<const uint8_t*>(src.at(i));
+        Td* buf = dest.at(i);
+        // bounded by sizeof(Td), which callers always ensure
+        const size_t len = std::min(word_size, sizeof(Td));
+        for (size_t j = 0; j < size; j++) {
+            Td val = 0;
+            std::memcpy(&val, tmp + j * word_size, len);
+            buf[j] = val;
+        }
+    }
+}
+
 /*
  * Cast buffers of source to a type corresponding to 'word_size'
  * Copy casted elements to buffers of destination
@@ -99,6 +127,88 @@ inline void pack(
         pack_next<Ts, Td, __uint128_t>(src, dest, n, size);
         break;
     default:
+        pack_bytes<Ts, Td>(src, dest, n, size, word_size);
+        break;
+    }
+}
+
+template <typename Ts, typename Td, typename Tw, typename Iterator>
+inline void pack_marked_next(
+    const std::vector<Ts*>& src,
+    const std::vector<Td*>& dest,
+    int n,
+    size_t size,
+    const std::vector<std::pair<Iterator, Iterator>>& marks,
+    off_t offset,
+    Td value)
+{
+    for (int i = 0; i < n; i++) {
+        const Tw* tmp = reinterpret_cast<const Tw*>(src[i]);
+        Td* buf = dest[i];
+        size_t j = 0;
+        // copy runs of unmarked elements, then set the marked one
+        for (auto it = marks[i].first; it != marks[i].second; ++it) {
+            const size_t k = it->first - offset;
+            std::copy(tmp + j, tmp + k, buf + j);
+            buf[k] = value;
+            j = k + 1;
+        }
+        std::copy(tmp + j, tmp + size, buf + j);
+    }
+}
+
+/*
+ * Same as `pack`, but marked elements are set to a given value instead
+ *
+ * It saves a pass over destination buffers when restoring special values.
+ *
+ * @param marks: for each buffer, range of marks sorted by location, whose
+ *  first member is the location of the marked element
+ * @param offset: location of the first element of buffers
+ * @param value: value of marked elements
+ */
+template <typename Ts, typename Td, typename Iterator>
+inline void pack_marked(
+    const std::vector<Ts*>& src,
+    const std::vector<Td*>& dest,
+    int n,
+    size_t size,
+    size_t word_size,
+    const std::vector<std::pair<Iterator, Iterator>>& marks,
+    off_t offset,
+    Td value)
+{
+    assert(sizeof(Td) >= word_size);
+    assert(word_size % sizeof(Ts) == 0);
+    // get only word_size bytes from each element
+    switch (word_size) {
+    case 1:
+        pack_marked_next<Ts, Td, uint8_t>(
+            src, dest, n, size, marks, offset, value);
+        break;
+    case 2:
+        pack_marked_next<Ts, Td, uint16_t>(
+            src, dest, n, size, marks, offset, value);
+        break;
+    case 4:
+        pack_marked_next<Ts, Td, uint32_t>(
+            src, dest, n, size, marks, offset, value);
+        break;
+    case 8:
+        pack_marked_next<Ts, Td, uint64_t>(
+            src, dest, n, size, marks, offset, value);
+        break;
+    case 16:
+        pack_marked_next<Ts, Td, __uint128_t>(
+            src, dest, n, size, marks, offset, value);
+        break;
+    default:
+        pack_bytes<Ts, Td>(src, dest, n, size, word_size);
+        for (int i = 0; i < n; i++) {
+            for (auto it = marks[i].first; it != marks[i].second; ++it) {
+                dest[i][it->first - offset] = value;
+            }
+        }
         break;
     }
 }
@@ -116,6 +226,29 @@ inline void unpack_next(
     }
 }
 
+/*
+ * Copy the low `word_size` bytes of elements from buffers of source to byte
+ * buffers of destination, for word sizes that no integer type matches
+ */
+template <typename Ts, typename Td>
+inline void unpack_bytes(
+    const std::vector<Ts*>& src,
+    const std::vector<Td*>& dest,
+    int n,
+    size_t size,
+    size_t word_size)
+{
+    for (int i = 0; i < n; i++) {
+        const Ts* buf = src.at(i);
+        uint8_t* tmp = reinterpret_cast<uint8_t*>(dest.at(i));
+        // bounded by sizeof(Ts), which callers always ensure
+        const size_t len = std::min(word_size, sizeof(Ts));
+        for (size_t j = 0; j < size; j++) {
+            std::memcpy(tmp + j * word_size, &buf[j], len);
+        }
+    }
+}
+
 /*
  * Cast buffers of destination to a type corresponding to 'word_size'
  * Copy elements from source buffers to casted buffers
@@ -158,6 +291,7 @@ inline void unpack(
         unpack_next<Ts, Td, __uint128_t>(src, dest, n, size);
         break;
     default:
+        unpack_bytes<Ts, Td>(src, dest, n, size, word_size);
         break;
     }
 }
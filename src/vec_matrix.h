@@ -31,9 +31,12 @@
 #ifndef __QUAD_VEC_MATRIX_H__
 #define __QUAD_VEC_MATRIX_H__
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 #include "gf_ring.h"
+#include "vec_buffers.h"
 #include "vec_vector.h"
 
 namespace quadiron {
@@ -65,6 +68,10 @@ class Matrix {
     virtual const T& get(int i, int j);
     void inv(void);
     void mul(vec::Vector<T>* output, vec::Vector<T>* v);
+    void mul(
+        vec::Buffers<T>* output,
+        vec::Buffers<T>* v,
+        const std::vector<bool>& wanted_rows = {});
     void vandermonde(void);
     void vandermonde_suitable_for_ec(void);
     void cauchy(void);
@@ -403,6 +410,67 @@ void Matrix<T>::mul(vec::Vector<T>* output, vec::Vector<T>* v)
     }
 }
 
+/** Multiply the matrix by buffers
+ *
+ * Each output buffer is a linear combination of the input ones, i.e.
+ * `output[i] = sum_j matrix(i, j) * v[j]`. Buffers are processed by chunks
+ * small enough to stay in L1 cache while all inputs are accumulated.
+ *
+ * @param output buffers of `n_rows` elements, distinct from `v`
+ * @param v buffers of `n_cols` elements
+ * @param wanted_rows flags of the output buffers to compute, empty if all
+ * of them are wanted
+ */
+template <typename T>
+void Matrix<T>::mul(
+    vec::Buffers<T>* output,
+    vec::Buffers<T>* v,
+    const std::vector<bool>& wanted_rows)
+{
+    assert(get_n_cols() == v->get_n());
+    assert(get_n_rows() == output->get_n());
+    assert(output->get_size() == v->get_size());
+
+    // number of elements of a chunk, i.e. 4 KiB
+    constexpr size_t chunk_len = 4096 / sizeof(T);
+    alignas(simd::ALIGNMENT) T tmp[chunk_len];
+
+    const size_t size = v->get_size();
+    for (size_t begin = 0; begin < size; begin += chunk_len) {
+        const size_t len = std::min(chunk_len, size - begin);
+        for (int i = 0; i < n_rows; i++) {
+            if (!wanted_rows.empty() && !wanted_rows[i]) {
+                continue;
+            }
+            T* out = output->get(i) + begin;
+            bool first = true;
+            for (int j = 0; j < n_cols; j++) {
+                const T coef = get(i, j);
+                if (coef == 0) {
+                    continue;
+                }
+                T* src = v->get(j) + begin;
+                if (first) {
+                    if (coef == 1) {
+                        std::copy_n(src, len, out);
+                    } else {
+                        rn->mul_coef_to_buf(coef, src, out, len);
+                    }
+                    first = false;
+                } else if (coef == 1) {
+                    rn->add_two_bufs(src, out, len);
+                } else {
+                    rn->mul_coef_to_buf(coef, src, tmp, len);
+                    rn->add_two_bufs(tmp, out, len);
+                }
+            }
+            if (first) {
+                std::fill_n(out, len, 0);
+            }
+        }
+    }
+}
+
 template <typename T>
 void Matrix<T>::cauchy()
 {
@@ -415,16 +483,19 @@ void Matrix<T>::cauchy()
     }
 
     /* do optimise */
-    // convert 1st row to all 1s
+    // convert 1st row to all 1s: the divisor is read before (0, j) is set to
+    // 1, so that whole columns are scaled and the matrix stays MDS
     for (j = 0; j < n_cols; j++) {
+        const T factor = get(0, j);
         for (i = 0; i < n_rows; i++) {
-            set(i, j, rn->div(get(i, j), get(0, j)));
+            set(i, j, rn->div(get(i, j), factor));
         }
     }
     // convert 1st element of each row to 1
     for (i = 1; i < n_rows; i++) {
+        const T factor = get(i, 0);
         for (j = 0; j < n_cols; j++) {
-            set(i, j, rn->div(get(i, j), get(i, 0)));
+            set(i, j, rn->div(get(i, j), factor));
         }
     }
 }
@@ -40,6 +40,7 @@
 
 #include "core.h"
 #include "gf_ring.h"
+#include "misc.h"
 #include "simd/simd.h"
 #include "vec_cast.h"
 
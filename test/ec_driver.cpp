@@ -45,7 +45,7 @@ char* prefix = nullptr;
 static void xusage()
 {
     std::cerr << std::string("Usage: ") +
-    "ec [-e rs-gf2n-v|rs-gf2n-c|rs-gf2n-fft|rs-gf2n-fft-add|rs-gfp-fft|rs-fnt|rs-fnt-sys|rs-nf4]" +
+    "ec [-e rs-gf2n-v|rs-gf2n-c|rs-gf2n-fft|rs-gf2n-fft-add|rs-gf2n-fft-add-sys|rs-gfp-fft|rs-gfp-fft-sys|rs-fnt|rs-fnt-sys|rs-nf4]" +
     "[-w word_size][-n n_data][-m n_parities][-p prefix][-v (verbose)]" +
     " -c (encode) | -r (repair)\n";
     std::exit(EXIT_FAILURE);
@@ -348,7 +348,9 @@ template <typename T>
 void run_fec_rs_gf2n_fft(int word_size, int n_data, int n_parities, int rflag)
 {
     quadiron::fec::RsGf2nFft<T>* fec;
-    fec = new quadiron::fec::RsGf2nFft<T>(word_size, n_data, n_parities);
+    size_t pkt_size = 1024;
+    fec = new quadiron::fec::RsGf2nFft<T>(
+        word_size, n_data, n_parities, pkt_size);
 
     coding_zpad = count_digits(fec->n_outputs - 1);
 
@@ -357,11 +359,11 @@ void run_fec_rs_gf2n_fft(int word_size, int n_data, int n_parities, int rflag)
         std::exit(EXIT_FAILURE);
     }
     if (rflag) {
-        if (0 != repair_data_files<T>(fec)) {
+        if (0 != repair_data_files<T>(fec, true)) {
             std::exit(EXIT_FAILURE);
         }
     }
-    create_coding_files<T>(fec);
+    create_coding_files<T>(fec, true);
     print_stats<T>(fec);
     delete fec;
 }
@@ -371,10 +373,13 @@ void run_fec_rs_gf2n_fft_add(
     int word_size,
     int n_data,
     int n_parities,
-    int rflag)
+    int rflag,
+    quadiron::fec::FecType type)
 {
     quadiron::fec::RsGf2nFftAdd<T>* fec;
-    fec = new quadiron::fec::RsGf2nFftAdd<T>(word_size, n_data, n_parities);
+    size_t pkt_size = 1024;
+    fec = new quadiron::fec::RsGf2nFftAdd<T>(
+        type, word_size, n_data, n_parities, pkt_size);
 
     coding_zpad = count_digits(fec->n_outputs - 1);
 
@@ -383,11 +388,11 @@ void run_fec_rs_gf2n_fft_add(
         std::exit(EXIT_FAILURE);
     }
     if (rflag) {
-        if (0 != repair_data_files<T>(fec)) {
+        if (0 != repair_data_files<T>(fec, true)) {
             std::exit(EXIT_FAILURE);
         }
     }
-    create_coding_files<T>(fec);
+    create_coding_files<T>(fec, true);
     print_stats<T>(fec);
     delete fec;
 }
@@ -397,12 +402,17 @@ void run_fec_rs_gfp_fft(
     unsigned word_size,
     int n_data,
     int n_parities,
-    int rflag)
+    int rflag,
+    quadiron::fec::FecType type)
 {
     assert(sizeof(T) > word_size);
 
     quadiron::fec::RsGfpFft<T>* fec;
-    fec = new quadiron::fec::RsGfpFft<T>(word_size, n_data, n_parities);
+    size_t pkt_size = 1024;
+    fec = new quadiron::fec::RsGfpFft<T>(
+        type, word_size, n_data, n_parities, pkt_size);
+    // only the encoding of buffers is systematic
+    const bool on_packet = type == quadiron::fec::FecType::SYSTEMATIC;
 
     coding_zpad = count_digits(fec->n_outputs - 1);
 
@@ -411,11 +421,11 @@ void run_fec_rs_gfp_fft(
         std::exit(EXIT_FAILURE);
     }
     if (rflag) {
-        if (0 != repair_data_files<T>(fec)) {
+        if (0 != repair_data_files<T>(fec, on_packet)) {
             std::exit(EXIT_FAILURE);
         }
     }
-    create_coding_files<T>(fec);
+    create_coding_files<T>(fec, on_packet);
     print_stats<T>(fec);
     delete fec;
 }
@@ -477,7 +487,9 @@ enum ec_type {
     EC_TYPE_RS_GF2N,
     EC_TYPE_RS_GF2N_FFT,
     EC_TYPE_RS_GF2N_FFT_ADD,
+    EC_TYPE_RS_GF2N_FFT_ADD_SYS,
     EC_TYPE_RS_GFP_FFT,
+    EC_TYPE_RS_GFP_FFT_SYS,
     EC_TYPE_RS_FNT,
     EC_TYPE_RS_FNT_SYS,
     EC_TYPE_RS_NF4,
@@ -520,8 +532,12 @@ int main(int argc, char** argv)
                 eflag = EC_TYPE_RS_GF2N_FFT;
             } else if (!strcmp(optarg, "rs-gf2n-fft-add")) {
                 eflag = EC_TYPE_RS_GF2N_FFT_ADD;
+            } else if (!strcmp(optarg, "rs-gf2n-fft-add-sys")) {
+                eflag = EC_TYPE_RS_GF2N_FFT_ADD_SYS;
             } else if (!strcmp(optarg, "rs-gfp-fft")) {
                 eflag = EC_TYPE_RS_GFP_FFT;
+            } else if (!strcmp(optarg, "rs-gfp-fft-sys")) {
+                eflag = EC_TYPE_RS_GFP_FFT_SYS;
             } else if (!strcmp(optarg, "rs-nf4")) {
                 eflag = EC_TYPE_RS_NF4;
             } else if (!strcmp(optarg, "rs-fnt")) {
@@ -632,12 +648,17 @@ int main(int argc, char** argv)
             run_fec_rs_gf2n<__uint128_t>(
                 word_size, n_data, n_parities, mflag, rflag);
         }
-    } else if (eflag == EC_TYPE_RS_GFP_FFT) {
+    } else if (
+        eflag == EC_TYPE_RS_GFP_FFT || eflag == EC_TYPE_RS_GFP_FFT_SYS) {
+        const quadiron::fec::FecType type = eflag == EC_TYPE_RS_GFP_FFT_SYS
+            ? quadiron::fec::FecType::SYSTEMATIC
+            : quadiron::fec::FecType::NON_SYSTEMATIC;
         if (word_size <= 7) {
-            run_fec_rs_gfp_fft<uint64_t>(word_size, n_data, n_parities, rflag);
+            run_fec_rs_gfp_fft<uint64_t>(
+                word_size, n_data, n_parities, rflag, type);
         } else if (word_size <= 15) {
             run_fec_rs_gfp_fft<__uint128_t>(
-                word_size, n_data, n_parities, rflag);
+                word_size, n_data, n_parities, rflag, type);
         }
     } else if (eflag == EC_TYPE_RS_GF2N_FFT) {
         if (word_size <= 4) {
@@ -648,16 +669,21 @@ int main(int argc, char** argv)
             run_fec_rs_gf2n_fft<__uint128_t>(
                 word_size, n_data, n_parities, rflag);
         }
-    } else if (eflag == EC_TYPE_RS_GF2N_FFT_ADD) {
+    } else if (
+        eflag == EC_TYPE_RS_GF2N_FFT_ADD
+        || eflag == EC_TYPE_RS_GF2N_FFT_ADD_SYS) {
+        const quadiron::fec::FecType type = eflag == EC_TYPE_RS_GF2N_FFT_ADD_SYS
+            ? quadiron::fec::FecType::SYSTEMATIC
+            : quadiron::fec::FecType::NON_SYSTEMATIC;
         if (word_size <= 4) {
             run_fec_rs_gf2n_fft_add<uint32_t>(
-                word_size, n_data, n_parities, rflag);
+                word_size, n_data, n_parities, rflag, type);
         } else if (word_size <= 8) {
             run_fec_rs_gf2n_fft_add<uint64_t>(
-                word_size, n_data, n_parities, rflag);
+                word_size, n_data, n_parities, rflag, type);
         } else if (word_size <= 16) {
             run_fec_rs_gf2n_fft_add<__uint128_t>(
-                word_size, n_data, n_parities, rflag);
+                word_size, n_data, n_parities, rflag, type);
         }
     }
 
@@ -27,12 +27,34 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <gtest/gtest.h>
 
 #include "quadiron.h"
 
 namespace fec = quadiron::fec;
 
+// Variations of the block operations checked by run_test_blocks
+struct BlocksTest {
+    // threads encoding the blocks of a caller
+    unsigned n_threads = 2;
+    // callers sharing the code, each one with its own workspace if several
+    unsigned n_callers = 1;
+    // regenerate each output alone
+    bool pruned = true;
+    // encode former data, then update parities to the current data
+    bool update = true;
+    // encode vectors along with blocks
+    bool with_vectors = false;
+};
+
 template <typename T>
 class FecTestCommon : public ::testing::Test {
   public:
@@ -91,6 +113,468 @@ class FecTestCommon : public ::testing::Test {
             ASSERT_EQ(copied_data_frags, decoded_frags);
         }
     }
+
+    /** Encode random vectors with a systematic code and decode them back
+     *
+     * Vectors are decoded after the loss of each run of `n_parities`
+     * fragments.
+     */
+    void run_test_systematic(fec::FecCode<T>& fec)
+    {
+        const quadiron::gf::Field<T>& gf = fec.get_gf();
+
+        quadiron::vec::Vector<T> data_frags(gf, n_data);
+        quadiron::vec::Vector<T> parities(gf, n_parities);
+        quadiron::vec::Vector<T> received_frags(gf, n_data);
+        quadiron::vec::Vector<T> decoded_frags(gf, n_data);
+        quadiron::vec::Vector<T> fragments_ids(gf, n_data);
+
+        for (int j = 0; j < 100; j++) {
+            std::vector<quadiron::Properties> props(n_parities);
+            for (unsigned i = 0; i < n_data; i++) {
+                data_frags.set(i, gf.rand());
+            }
+            fec.encode(parities, props, 0, data_frags);
+
+            const std::vector<int> missing_idxs = lost_fragments(j);
+            unsigned n_received = 0;
+            for (unsigned i = 0; n_received < n_data; i++) {
+                if (missing_idxs[i]) {
+                    continue;
+                }
+                fragments_ids.set(n_received, i);
+                received_frags.set(
+                    n_received,
+                    i < n_data ? data_frags.get(i)
+                               : parities.get(i - n_data));
+                n_received++;
+            }
+            std::unique_ptr<fec::DecodeContext<T>> context =
+                fec.init_context_dec(fragments_ids);
+
+            fec.decode(*context, decoded_frags, props, 0, received_frags);
+
+            ASSERT_EQ(data_frags, decoded_frags);
+        }
+    }
+
+    // Fragments missing when `n_parities` of them are lost from `first_lost`
+    std::vector<int> lost_fragments(unsigned first_lost)
+    {
+        const unsigned code_len = n_data + n_parities;
+        std::vector<int> missing_idxs(code_len, 0);
+        for (unsigned i = 0; i < n_parities; i++) {
+            missing_idxs[(first_lost + i) % code_len] = 1;
+        }
+        return missing_idxs;
+    }
+
+    /** Encode random blocks, check their parities and decode them back.
+     *
+     * Parities are compared to the ones encoded by a single thread. Blocks
+     * are decoded after the loss of each run of `n_parities` fragments, with
+     * fewer cached contexts than erasure patterns so that contexts are both
+     * reused and evicted, and again once the memory kept across calls is
+     * released. The last packet is partial unless the code needs whole
+     * packets.
+     */
+    void run_test_blocks(
+        fec::FecCode<T>& fec,
+        const BlocksTest& test = BlocksTest())
+    {
+        const unsigned code_len = n_data + n_parities;
+        const unsigned n_outputs = fec.n_outputs;
+        const size_t word_size = fec.word_size;
+        const size_t block_size =
+            word_size * (fec.pkt_size * 9 + (fec.whole_packets ? 0 : 5));
+        const size_t coded_size = fec.get_coded_size(block_size);
+        const bool systematic = fec.type == fec::FecType::SYSTEMATIC;
+        // Updated range spans several packets.
+        const unsigned update_idx = 1;
+        const size_t update_offset = word_size * (fec.pkt_size + 3);
+        const size_t update_size = word_size * (fec.pkt_size * 2 + 1);
+
+        std::vector<std::vector<uint8_t>> data(n_data);
+        for (unsigned i = 0; i < n_data; i++) {
+            data[i].resize(block_size);
+            for (size_t j = 0; j < block_size; j++) {
+                data[i][j] = quadiron::prng()();
+            }
+        }
+        // Data before the update
+        std::vector<std::vector<uint8_t>> old_data(data);
+        if (test.update) {
+            for (size_t j = 0; j < update_size; j++) {
+                old_data[update_idx][update_offset + j] = quadiron::prng()();
+            }
+        }
+        std::vector<uint8_t*> data_bufs(n_data);
+        std::vector<uint8_t*> old_data_bufs(n_data);
+        for (unsigned i = 0; i < n_data; i++) {
+            data_bufs[i] = data[i].data();
+            old_data_bufs[i] = old_data[i].data();
+        }
+
+        std::vector<std::vector<uint8_t>> ref_parities(n_outputs);
+        std::vector<uint8_t*> ref_parities_bufs(n_outputs);
+        for (unsigned i = 0; i < n_outputs; i++) {
+            ref_parities[i].resize(coded_size);
+            ref_parities_bufs[i] = ref_parities[i].data();
+        }
+        std::vector<quadiron::Properties> ref_props(n_outputs);
+        const std::vector<bool> all_idxs(n_outputs, true);
+
+        fec.set_n_threads(1);
+        fec.encode_blocks_vertical(
+            data_bufs, ref_parities_bufs, ref_props, all_idxs, block_size);
+        fec.set_n_threads(test.n_threads);
+
+        const quadiron::gf::Field<T>& gf = fec.get_gf();
+        quadiron::vec::Vector<T> data_words(gf, n_data);
+        quadiron::vec::Vector<T> ref_words(gf, fec.get_n_outputs());
+        std::vector<quadiron::Properties> ref_words_props(n_outputs);
+        if (test.with_vectors) {
+            for (unsigned i = 0; i < n_data; i++) {
+                data_words.set(i, gf.rand());
+            }
+            fec.encode(ref_words, ref_words_props, 0, data_words);
+        }
+
+        // A single caller works on the state of the code. Otherwise each
+        // caller shares `fec` but owns its workspace and buffers, and loses
+        // different sets of fragments at a time.
+        auto caller = [&](unsigned id) {
+            fec::Workspace<T> own_workspace;
+            fec::Workspace<T>* workspace =
+                test.n_callers > 1 ? &own_workspace : nullptr;
+            auto encode = [&](
+                              const std::vector<uint8_t*>& bufs,
+                              const std::vector<uint8_t*>& parities_bufs,
+                              std::vector<quadiron::Properties>& props,
+                              const std::vector<bool>& wanted_idxs) {
+                if (workspace == nullptr) {
+                    fec.encode_blocks_vertical(
+                        bufs, parities_bufs, props, wanted_idxs, block_size);
+                } else {
+                    fec.encode_blocks_vertical(
+                        bufs,
+                        parities_bufs,
+                        props,
+                        wanted_idxs,
+                        block_size,
+                        *workspace);
+                }
+            };
+
+            std::vector<std::vector<uint8_t>> parities(n_outputs);
+            std::vector<uint8_t*> parities_bufs(n_outputs);
+            for (unsigned i = 0; i < n_outputs; i++) {
+                parities[i].resize(coded_size);
+                parities_bufs[i] = parities[i].data();
+            }
+            std::vector<quadiron::Properties> props(n_outputs);
+
+            encode(
+                test.update ? old_data_bufs : data_bufs,
+                parities_bufs,
+                props,
+                all_idxs);
+            if (test.update) {
+                fec.update_parities(
+                    update_idx,
+                    old_data[update_idx].data() + update_offset,
+                    data[update_idx].data() + update_offset,
+                    parities_bufs,
+                    props,
+                    update_offset,
+                    update_size);
+            }
+            for (unsigned i = 0; i < n_outputs; i++) {
+                ASSERT_EQ(ref_parities[i], parities[i]);
+                ASSERT_EQ(ref_props[i].get_map(), props[i].get_map());
+            }
+
+            // Regenerate each output alone.
+            for (unsigned i = 0; test.pruned && i < n_outputs; i++) {
+                std::vector<uint8_t> parity(coded_size);
+                std::vector<uint8_t*> pruned_bufs(n_outputs, nullptr);
+                pruned_bufs[i] = parity.data();
+                std::vector<quadiron::Properties> pruned_props(n_outputs);
+                std::vector<bool> wanted_idxs(n_outputs, false);
+                wanted_idxs[i] = true;
+
+                encode(data_bufs, pruned_bufs, pruned_props, wanted_idxs);
+
+                ASSERT_EQ(ref_parities[i], parity);
+                ASSERT_EQ(ref_props[i].get_map(), pruned_props[i].get_map());
+            }
+
+            // Vectors are short, encode them many times so that callers
+            // overlap.
+            for (unsigned j = 0; test.with_vectors && j < 256; j++) {
+                quadiron::vec::Vector<T> words(gf, n_data);
+                quadiron::vec::Vector<T> encoded(gf, fec.get_n_outputs());
+                std::vector<quadiron::Properties> words_props(n_outputs);
+                words.copy(&data_words);
+                fec.encode(encoded, words_props, 0, words);
+                ASSERT_TRUE(encoded == ref_words);
+            }
+
+            if (workspace == nullptr) {
+                fec.set_context_cache_capacity(2);
+            } else {
+                workspace->set_context_cache_capacity(2);
+            }
+            for (unsigned round = 0; round < 2; round++) {
+                if (round > 0) {
+                    // Released memory is allocated again on demand.
+                    if (workspace == nullptr) {
+                        fec.trim();
+                    } else {
+                        workspace->trim();
+                    }
+                }
+                for (unsigned shift = 0; shift < code_len; shift++) {
+                    const std::vector<int> missing_idxs =
+                        lost_fragments(id + shift);
+
+                    std::vector<std::vector<uint8_t>> decoded(n_data);
+                    std::vector<uint8_t*> decoded_bufs(n_data);
+                    std::vector<bool> wanted_data(n_data, true);
+                    for (unsigned i = 0; i < n_data; i++) {
+                        if (systematic && !missing_idxs[i]) {
+                            decoded[i] = data[i];
+                            wanted_data[i] = false;
+                        } else {
+                            decoded[i].resize(block_size, 0);
+                        }
+                        decoded_bufs[i] = decoded[i].data();
+                    }
+
+                    const bool ok = (workspace == nullptr)
+                        ? fec.decode_blocks_vertical(
+                              decoded_bufs,
+                              parities_bufs,
+                              props,
+                              missing_idxs,
+                              wanted_data,
+                              block_size)
+                        : fec.decode_blocks_vertical(
+                              decoded_bufs,
+                              parities_bufs,
+                              props,
+                              missing_idxs,
+                              wanted_data,
+                              block_size,
+                              *workspace);
+                    ASSERT_TRUE(ok);
+                    ASSERT_EQ(data, decoded);
+                }
+            }
+        };
+
+        if (test.n_callers == 1) {
+            caller(0);
+            return;
+        }
+        std::vector<std::thread> callers;
+        for (unsigned id = 0; id < test.n_callers; id++) {
+            callers.emplace_back(caller, id);
+        }
+        for (auto& t : callers) {
+            t.join();
+        }
+    }
+
+    void
+    run_test_streams_horizontal(fec::FecCode<T>& fec, unsigned first_lost = 0)
+    {
+        const unsigned code_len = n_data + n_parities;
+        const unsigned n_outputs = fec.n_outputs;
+        const bool systematic = fec.type == fec::FecType::SYSTEMATIC;
+        // Streams span several batches, the last one being partial.
+        const size_t stream_size = fec.word_size * (1024 * 2 + 5);
+
+        std::vector<std::string> data(n_data);
+        std::vector<std::unique_ptr<std::istringstream>> data_streams;
+        std::vector<std::istream*> data_bufs(n_data);
+        for (unsigned i = 0; i < n_data; i++) {
+            for (size_t j = 0; j < stream_size; j++) {
+                data[i].push_back(quadiron::prng()());
+            }
+            data_streams.push_back(
+                std::make_unique<std::istringstream>(data[i]));
+            data_bufs[i] = data_streams[i].get();
+        }
+        std::vector<std::ostringstream> parities(n_outputs);
+        std::vector<std::ostream*> parities_bufs(n_outputs);
+        for (unsigned i = 0; i < n_outputs; i++) {
+            parities_bufs[i] = &parities[i];
+        }
+        std::vector<quadiron::Properties> props(n_outputs);
+
+        fec.encode_streams_horizontal(data_bufs, parities_bufs, props);
+
+        const std::vector<int> missing_idxs = lost_fragments(first_lost);
+        std::vector<std::istream*> received_data_bufs(n_data, nullptr);
+        std::vector<std::istream*> received_parities_bufs(n_outputs, nullptr);
+        std::vector<std::unique_ptr<std::istringstream>> received;
+        for (unsigned i = 0; i < code_len; i++) {
+            if (missing_idxs[i]) {
+                continue;
+            }
+            if (systematic && i < n_data) {
+                received_data_bufs[i] = data_bufs[i];
+                continue;
+            }
+            const unsigned j = systematic ? i - n_data : i;
+            received.push_back(
+                std::make_unique<std::istringstream>(parities[j].str()));
+            received_parities_bufs[j] = received.back().get();
+        }
+        for (unsigned i = 0; i < n_data; i++) {
+            data_streams[i]->clear();
+            data_streams[i]->seekg(0);
+        }
+        std::vector<std::ostringstream> decoded(n_data);
+        std::vector<std::ostream*> decoded_bufs(n_data);
+        for (unsigned i = 0; i < n_data; i++) {
+            decoded_bufs[i] = &decoded[i];
+        }
+
+        ASSERT_TRUE(fec.decode_streams_horizontal(
+            received_data_bufs, received_parities_bufs, props, decoded_bufs));
+        for (unsigned i = 0; i < n_data; i++) {
+            ASSERT_EQ(data[i], decoded[i].str());
+        }
+    }
+
+    /** Check that aligned blocks are encoded without copies nor writes to data
+     *
+     * @param fec a ZeroCopyProbe code whose words are stored as T
+     */
+    template <typename Code>
+    void run_test_blocks_zero_copy(Code& fec)
+    {
+        using AlignedBlock =
+            std::vector<uint8_t, quadiron::simd::AlignedAllocator<uint8_t>>;
+        const size_t word_size = fec.word_size;
+        const size_t pkt_size = fec.pkt_size;
+        const size_t n_packets = 4;
+        const size_t block_size = word_size * pkt_size * n_packets;
+        const unsigned n_outputs = fec.n_outputs;
+
+        // Blocks on their own pages, so that they can be made read-only, and
+        // the same blocks shifted by one byte
+        const size_t page_size = sysconf(_SC_PAGESIZE);
+        const size_t block_span =
+            (block_size + page_size - 1) / page_size * page_size;
+        const size_t data_span = n_data * block_span;
+        void* pages = mmap(
+            nullptr,
+            data_span,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0);
+        ASSERT_NE(pages, MAP_FAILED);
+        std::unique_ptr<void, std::function<void(void*)>> data_pages(
+            pages, [data_span](void* p) { munmap(p, data_span); });
+        std::vector<AlignedBlock> data_copy(n_data);
+        std::vector<uint8_t*> data_bufs(n_data);
+        std::vector<uint8_t*> shifted_data_bufs(n_data);
+        for (unsigned i = 0; i < n_data; i++) {
+            data_bufs[i] = static_cast<uint8_t*>(pages) + i * block_span;
+            data_copy[i].resize(block_size + 1);
+            for (size_t j = 0; j < block_size; j++) {
+                data_bufs[i][j] = quadiron::prng()();
+                data_copy[i][j + 1] = data_bufs[i][j];
+            }
+            shifted_data_bufs[i] = data_copy[i].data() + 1;
+        }
+        std::vector<AlignedBlock> parities(n_outputs);
+        std::vector<std::vector<uint8_t>> ref_parities(n_outputs);
+        std::vector<uint8_t*> parities_bufs(n_outputs);
+        std::vector<uint8_t*> ref_parities_bufs(n_outputs);
+        for (unsigned i = 0; i < n_outputs; i++) {
+            parities[i].resize(fec.get_coded_size(block_size));
+            ref_parities[i].resize(fec.get_coded_size(block_size));
+            parities_bufs[i] = parities[i].data();
+            ref_parities_bufs[i] = ref_parities[i].data();
+        }
+        std::vector<quadiron::Properties> props(n_outputs);
+        std::vector<quadiron::Properties> ref_props(n_outputs);
+        std::vector<bool> wanted_idxs(n_outputs, true);
+
+        // Data blocks must be left untouched: writing to them would crash
+        ASSERT_EQ(mprotect(pages, data_span, PROT_READ), 0);
+        fec.encode_blocks_vertical(
+            data_bufs, parities_bufs, props, wanted_idxs, block_size);
+
+        // Packets are read from and written to the blocks themselves
+        ASSERT_EQ(fec.words_mem.size(), n_packets);
+        for (size_t k = 0; k < n_packets; k++) {
+            const size_t offset = k * pkt_size * word_size;
+            ASSERT_EQ(
+                fec.words_mem[k],
+                reinterpret_cast<const T*>(data_bufs[0] + offset));
+            ASSERT_EQ(
+                fec.output_mem[k],
+                reinterpret_cast<const T*>(parities_bufs[0] + offset));
+        }
+
+        // Shifted blocks are copied, and lead to the same parities
+        fec.words_mem.clear();
+        fec.output_mem.clear();
+        fec.encode_blocks_vertical(
+            shifted_data_bufs,
+            ref_parities_bufs,
+            ref_props,
+            wanted_idxs,
+            block_size);
+        ASSERT_EQ(fec.words_mem.size(), n_packets);
+        ASSERT_NE(
+            fec.words_mem[0],
+            reinterpret_cast<const T*>(shifted_data_bufs[0]));
+        for (unsigned i = 0; i < n_outputs; i++) {
+            ASSERT_TRUE(std::equal(
+                parities[i].begin(),
+                parities[i].end(),
+                ref_parities[i].begin()));
+            ASSERT_EQ(ref_props[i].get_map(), props[i].get_map());
+        }
+        for (unsigned i = 0; i < n_data; i++) {
+            ASSERT_TRUE(std::equal(
+                data_bufs[i], data_bufs[i] + block_size, shifted_data_bufs[i]));
+        }
+    }
+};
+
+// Code recording where the packets it encodes are read and written, to check
+// that aligned blocks of words stored as T are encoded without any copy.
+template <typename T, template <typename> class Code>
+class ZeroCopyProbe : public Code<T> {
+  public:
+    using Base = Code<T>;
+    using Base::Base;
+
+    std::vector<const T*> words_mem;
+    std::vector<const T*> output_mem;
+
+  protected:
+    void encode_packet(
+        fec::EncodeWorkspace<T>* workspace,
+        quadiron::vec::Buffers<T>& output,
+        std::vector<quadiron::Properties>& props,
+        off_t offset,
+        quadiron::vec::Buffers<T>& words,
+        const std::vector<bool>& wanted_idxs) override
+    {
+        words_mem.push_back(words.get(0));
+        output_mem.push_back(output.get(0));
+        Base::encode_packet(
+            workspace, output, props, offset, words, wanted_idxs);
+    }
 };
 
 using AllTypes = ::testing::Types<uint32_t, uint64_t, __uint128_t>;
@@ -117,6 +601,33 @@ TYPED_TEST(FecTestCommon, TestGf2nFft) // NOLINT
     }
 }
 
+TYPED_TEST(FecTestCommon, TestGf2nFftBlocks) // NOLINT
+{
+    for (unsigned word_size = 1; word_size <= 2; ++word_size) {
+        fec::RsGf2nFft<TypeParam> fec(
+            word_size, this->n_data, this->n_parities, 16);
+        this->run_test_blocks(fec);
+    }
+}
+
+TYPED_TEST(FecTestCommon, TestGf2nFftBlocksZeroCopy) // NOLINT
+{
+    ZeroCopyProbe<TypeParam, fec::RsGf2nFft> fec(
+        sizeof(TypeParam), this->n_data, this->n_parities, 16);
+    this->run_test_blocks_zero_copy(fec);
+}
+
+TYPED_TEST(FecTestCommon, TestGf2nFftAddSysBlocksZeroCopy) // NOLINT
+{
+    ZeroCopyProbe<TypeParam, fec::RsGf2nFftAdd> fec(
+        fec::FecType::SYSTEMATIC,
+        sizeof(TypeParam),
+        this->n_data,
+        this->n_parities,
+        16);
+    this->run_test_blocks_zero_copy(fec);
+}
+
 TYPED_TEST(FecTestCommon, TestGf2nFftAdd) // NOLINT
 {
     for (size_t wordsize = 1; wordsize <= sizeof(TypeParam); wordsize *= 2) {
@@ -127,6 +638,191 @@ TYPED_TEST(FecTestCommon, TestGf2nFftAdd) // NOLINT
     }
 }
 
+TYPED_TEST(FecTestCommon, TestGf2nFftAddSys) // NOLINT
+{
+    for (unsigned word_size = 1; word_size <= 2; ++word_size) {
+        fec::RsGf2nFftAdd<TypeParam> fec(
+            fec::FecType::SYSTEMATIC,
+            word_size,
+            this->n_data,
+            this->n_parities);
+        this->run_test_streams_horizontal(fec);
+        this->run_test_streams_horizontal(fec, 1);
+        this->run_test_systematic(fec);
+    }
+}
+
+TYPED_TEST(FecTestCommon, TestGf2nFftAddBlocksConcurrent) // NOLINT
+{
+    for (const auto type :
+         {fec::FecType::NON_SYSTEMATIC, fec::FecType::SYSTEMATIC}) {
+        fec::RsGf2nFftAdd<TypeParam> fec(
+            type, 2, this->n_data, this->n_parities, 16);
+        BlocksTest test;
+        test.n_callers = 4;
+        test.with_vectors = true;
+        this->run_test_blocks(fec, test);
+    }
+}
+
+TYPED_TEST(FecTestCommon, TestGf2nFftAddBlocks) // NOLINT
+{
+    for (const auto type :
+         {fec::FecType::NON_SYSTEMATIC, fec::FecType::SYSTEMATIC}) {
+        for (unsigned word_size = 1; word_size <= 2; ++word_size) {
+            fec::RsGf2nFftAdd<TypeParam> fec(
+                type, word_size, this->n_data, this->n_parities, 16);
+            this->run_test_blocks(fec);
+        }
+    }
+}
+
+TYPED_TEST(FecTestCommon, TestGf2nStreamsHorizontal) // NOLINT
+{
+    for (unsigned word_size = 1; word_size <= 2; ++word_size) {
+        fec::RsGf2n<TypeParam> fec(
+            word_size,
+            this->n_data,
+            this->n_parities,
+            fec::RsMatrixType::CAUCHY);
+        this->run_test_streams_horizontal(fec);
+    }
+}
+
+TYPED_TEST(FecTestCommon, TestGf2nBlocks) // NOLINT
+{
+    BlocksTest test;
+    test.n_threads = 4;
+    for (const auto mat_type :
+         {fec::RsMatrixType::VANDERMONDE, fec::RsMatrixType::CAUCHY}) {
+        for (unsigned word_size = 1; word_size <= 2; ++word_size) {
+            fec::RsGf2n<TypeParam> fec(
+                word_size, this->n_data, this->n_parities, mat_type, 16);
+            this->run_test_blocks(fec, test);
+        }
+
+        // Packets span several chunks of the matrix multiplication.
+        fec::RsGf2n<TypeParam> fec(
+            2, this->n_data, this->n_parities, mat_type, 1100);
+        this->run_test_blocks(fec);
+    }
+}
+
+TYPED_TEST(FecTestCommon, TestGf2nBlocksConcurrent) // NOLINT
+{
+    for (const auto mat_type :
+         {fec::RsMatrixType::VANDERMONDE, fec::RsMatrixType::CAUCHY}) {
+        fec::RsGf2n<TypeParam> fec(
+            1, this->n_data, this->n_parities, mat_type, 16);
+        BlocksTest test;
+        test.n_callers = 4;
+        this->run_test_blocks(fec, test);
+    }
+}
+
+TYPED_TEST(FecTestCommon, TestGf2nCauchyAllErasures) // NOLINT
+{
+    // Cauchy matrices used to be singular for some erasure patterns of
+    // this configuration.
+    const unsigned n_data = 10;
+    const unsigned n_parities = 4;
+    const unsigned code_len = n_data + n_parities;
+    fec::RsGf2n<TypeParam> fec(
+        1, n_data, n_parities, fec::RsMatrixType::CAUCHY, 16);
+    const size_t block_size = fec.buf_size;
+
+    std::vector<std::vector<uint8_t>> data(n_data);
+    std::vector<uint8_t*> data_bufs(n_data);
+    for (unsigned i = 0; i < n_data; i++) {
+        data[i].resize(block_size);
+        for (size_t j = 0; j < block_size; j++) {
+            data[i][j] = quadiron::prng()();
+        }
+        data_bufs[i] = data[i].data();
+    }
+    std::vector<std::vector<uint8_t>> parities(n_parities);
+    std::vector<uint8_t*> parities_bufs(n_parities);
+    for (unsigned i = 0; i < n_parities; i++) {
+        parities[i].resize(block_size);
+        parities_bufs[i] = parities[i].data();
+    }
+    std::vector<quadiron::Properties> props(n_parities);
+    std::vector<bool> wanted_idxs(n_parities, true);
+
+    fec.encode_blocks_vertical(
+        data_bufs, parities_bufs, props, wanted_idxs, block_size);
+
+    // Lose every set of `n_parities` fragments.
+    for (unsigned lost = 0; lost < (1u << code_len); lost++) {
+        if (__builtin_popcount(lost) != static_cast<int>(n_parities)) {
+            continue;
+        }
+        std::vector<int> missing_idxs(code_len);
+        std::vector<std::vector<uint8_t>> decoded(data);
+        std::vector<uint8_t*> decoded_bufs(n_data);
+        std::vector<bool> wanted_data(n_data);
+        for (unsigned i = 0; i < code_len; i++) {
+            missing_idxs[i] = (lost >> i) & 1;
+        }
+        for (unsigned i = 0; i < n_data; i++) {
+            if (missing_idxs[i]) {
+                std::fill(decoded[i].begin(), decoded[i].end(), 0);
+                wanted_data[i] = true;
+            }
+            decoded_bufs[i] = decoded[i].data();
+        }
+
+        ASSERT_TRUE(fec.decode_blocks_vertical(
+            decoded_bufs,
+            parities_bufs,
+            props,
+            missing_idxs,
+            wanted_data,
+            block_size));
+        ASSERT_EQ(data, decoded);
+    }
+}
+
+TYPED_TEST(FecTestCommon, TestGf2nBitMatrix) // NOLINT
+{
+    for (unsigned word_size = 1; word_size <= 2; ++word_size) {
+        // Sub-packets of 35 words start at unaligned offsets.
+        const size_t pkt_size = 8 * word_size * 35;
+        fec::RsGf2n<TypeParam> fec(
+            word_size,
+            this->n_data,
+            this->n_parities,
+            fec::RsMatrixType::CAUCHY_BITMATRIX,
+            pkt_size);
+        this->run_test_streams_horizontal(fec);
+        // Packets can't be updated per symbol.
+        BlocksTest test;
+        test.update = false;
+        this->run_test_blocks(fec, test);
+
+        // Parities of a partial packet would be truncated.
+        std::vector<uint8_t> block(fec.buf_size + word_size);
+        std::vector<uint8_t*> data_bufs(this->n_data, block.data());
+        std::vector<uint8_t*> parities_bufs(fec.n_outputs, block.data());
+        std::vector<quadiron::Properties> props(fec.n_outputs);
+        std::vector<bool> wanted_idxs(fec.n_outputs, true);
+        EXPECT_THROW(
+            fec.encode_blocks_vertical(
+                data_bufs, parities_bufs, props, wanted_idxs, block.size()),
+            quadiron::InvalidArgument);
+    }
+
+    // Packets must split into one sub-packet per bit of symbols.
+    EXPECT_THROW(
+        fec::RsGf2n<TypeParam>(
+            2,
+            this->n_data,
+            this->n_parities,
+            fec::RsMatrixType::CAUCHY_BITMATRIX,
+            24),
+        quadiron::InvalidArgument);
+}
+
 template <typename T>
 class FecTestNo128 : public FecTestCommon<T> {
 };
@@ -158,6 +854,168 @@ TYPED_TEST(FecTestNo128, TestFntSys) // NOLINT
     }
 }
 
+TYPED_TEST(FecTestNo128, TestNf4Blocks) // NOLINT
+{
+    BlocksTest test;
+    test.n_threads = 4;
+    for (unsigned word_size = 2; word_size < sizeof(TypeParam);
+         word_size *= 2) {
+        fec::RsNf4<TypeParam> fec(
+            word_size, this->n_data, this->n_parities, 16);
+        this->run_test_blocks(fec, test);
+    }
+}
+
+TYPED_TEST(FecTestNo128, TestFntBlocks) // NOLINT
+{
+    BlocksTest test;
+    test.n_threads = 4;
+    for (const auto type :
+         {fec::FecType::NON_SYSTEMATIC, fec::FecType::SYSTEMATIC}) {
+        for (unsigned word_size = 1; word_size <= 2; ++word_size) {
+            fec::RsFnt<TypeParam> fec(
+                type, word_size, this->n_data, this->n_parities, 16);
+            this->run_test_blocks(fec, test);
+        }
+    }
+}
+
+TYPED_TEST(FecTestNo128, TestNf4BlocksConcurrent) // NOLINT
+{
+    fec::RsNf4<TypeParam> fec(2, this->n_data, this->n_parities, 16);
+    BlocksTest test;
+    test.n_callers = 4;
+    this->run_test_blocks(fec, test);
+}
+
+TYPED_TEST(FecTestNo128, TestFntBlocksConcurrent) // NOLINT
+{
+    for (const auto type :
+         {fec::FecType::NON_SYSTEMATIC, fec::FecType::SYSTEMATIC}) {
+        fec::RsFnt<TypeParam> fec(type, 2, this->n_data, this->n_parities, 16);
+        BlocksTest test;
+        test.n_callers = 4;
+        this->run_test_blocks(fec, test);
+    }
+}
+
+TYPED_TEST(FecTestNo128, TestFntSharedPlans) // NOLINT
+{
+    auto& registry = fec::PlanRegistry<TypeParam>::get_instance();
+    const size_t n_plans = registry.get_size();
+    {
+        fec::RsFnt<TypeParam> fec1(
+            fec::FecType::SYSTEMATIC, 2, this->n_data, this->n_parities, 16);
+        const size_t n_code_plans = registry.get_size();
+        ASSERT_GT(n_code_plans, n_plans);
+
+        // A code of same parameters is built on the same plans
+        fec::RsFnt<TypeParam> fec2(
+            fec::FecType::SYSTEMATIC, 2, this->n_data, this->n_parities, 16);
+        ASSERT_EQ(registry.get_size(), n_code_plans);
+        this->run_test_blocks(fec1);
+        this->run_test_blocks(fec2);
+
+        // Plans don't depend on the packet size
+        fec::RsFnt<TypeParam> fec3(
+            fec::FecType::SYSTEMATIC, 2, this->n_data, this->n_parities, 32);
+        ASSERT_EQ(registry.get_size(), n_code_plans);
+        this->run_test_blocks(fec3);
+    }
+    // Plans are released with the last code using them
+    ASSERT_EQ(registry.get_size(), n_plans);
+}
+
+TYPED_TEST(FecTestNo128, TestFntStageStatsCopyBytes) // NOLINT
+{
+    const unsigned word_size = 2;
+    fec::RsFnt<TypeParam> fec(
+        fec::FecType::NON_SYSTEMATIC,
+        word_size,
+        this->n_data,
+        this->n_parities,
+        16);
+    const unsigned code_len = this->n_data + this->n_parities;
+    const unsigned n_outputs = fec.n_outputs;
+    // Last packet is partial.
+    const size_t block_size = word_size * (fec.pkt_size * 3 + 5);
+    const size_t coded_size = fec.get_coded_size(block_size);
+
+    // Blocks aren't aligned on words, so that all packets are copied.
+    std::vector<std::vector<uint8_t>> data(this->n_data);
+    std::vector<uint8_t*> data_bufs(this->n_data);
+    for (unsigned i = 0; i < this->n_data; i++) {
+        data[i].resize(block_size + 1);
+        for (size_t j = 0; j < block_size + 1; j++) {
+            data[i][j] = quadiron::prng()();
+        }
+        data_bufs[i] = data[i].data() + 1;
+    }
+    std::vector<std::vector<uint8_t>> parities(n_outputs);
+    std::vector<uint8_t*> parities_bufs(n_outputs);
+    for (unsigned i = 0; i < n_outputs; i++) {
+        parities[i].resize(coded_size + 1);
+        parities_bufs[i] = parities[i].data() + 1;
+    }
+    std::vector<quadiron::Properties> props(n_outputs);
+    // The first output, lost below, isn't wanted hence not copied.
+    std::vector<bool> wanted_idxs(n_outputs, true);
+    wanted_idxs[0] = false;
+
+    fec.stage_stats.reset();
+    fec.encode_blocks_vertical(
+        data_bufs, parities_bufs, props, wanted_idxs, block_size);
+    const uint64_t encode_bytes = fec.stage_stats.get_bytes(fec::Stage::COPY);
+
+    std::vector<int> missing_idxs(code_len, 0);
+    for (unsigned i = 0; i < this->n_parities; i++) {
+        missing_idxs[i] = 1;
+    }
+    std::vector<bool> wanted_data(this->n_data, true);
+    fec.stage_stats.reset();
+    ASSERT_TRUE(fec.decode_blocks_vertical(
+        data_bufs,
+        parities_bufs,
+        props,
+        missing_idxs,
+        wanted_data,
+        block_size));
+    const uint64_t decode_bytes = fec.stage_stats.get_bytes(fec::Stage::COPY);
+
+    if (fec::StageStats::enabled) {
+        ASSERT_EQ(
+            encode_bytes,
+            this->n_data * block_size + (n_outputs - 1) * coded_size);
+        ASSERT_EQ(decode_bytes, this->n_data * (coded_size + block_size));
+    } else {
+        ASSERT_EQ(encode_bytes, 0u);
+        ASSERT_EQ(decode_bytes, 0u);
+    }
+}
+
+TYPED_TEST(FecTestNo128, TestNf4StreamsHorizontal) // NOLINT
+{
+    for (unsigned word_size = 2; word_size < sizeof(TypeParam);
+         word_size *= 2) {
+        fec::RsNf4<TypeParam> fec(
+            word_size, this->n_data, this->n_parities, 16);
+        this->run_test_streams_horizontal(fec);
+    }
+}
+
+TYPED_TEST(FecTestNo128, TestFntStreamsHorizontal) // NOLINT
+{
+    for (unsigned word_size = 1; word_size <= 2; ++word_size) {
+        fec::RsFnt<TypeParam> fec(
+            fec::FecType::NON_SYSTEMATIC,
+            word_size,
+            this->n_data,
+            this->n_parities,
+            16);
+        this->run_test_streams_horizontal(fec);
+    }
+}
+
 TYPED_TEST(FecTestNo128, TestGfpFft) // NOLINT
 {
     for (size_t word_size = 1; word_size <= 4 && word_size < sizeof(TypeParam);
@@ -167,3 +1025,130 @@ TYPED_TEST(FecTestNo128, TestGfpFft) // NOLINT
         this->run_test(fec, true);
     }
 }
+
+TYPED_TEST(FecTestNo128, TestGfpFftSys) // NOLINT
+{
+    for (size_t word_size = 1; word_size <= 4 && word_size < sizeof(TypeParam);
+         word_size *= 2) {
+        fec::RsGfpFft<TypeParam> fec(
+            fec::FecType::SYSTEMATIC,
+            word_size,
+            this->n_data,
+            this->n_parities);
+        this->run_test_streams_horizontal(fec);
+        this->run_test_streams_horizontal(fec, 1);
+        this->run_test_systematic(fec);
+    }
+}
+
+TYPED_TEST(FecTestNo128, TestGfpFftBlocks) // NOLINT
+{
+    for (const auto type :
+         {fec::FecType::NON_SYSTEMATIC, fec::FecType::SYSTEMATIC}) {
+        for (size_t word_size = 1;
+             word_size <= 4 && word_size < sizeof(TypeParam);
+             word_size *= 2) {
+            fec::RsGfpFft<TypeParam> fec(
+                type, word_size, this->n_data, this->n_parities, 16);
+            this->run_test_blocks(fec);
+        }
+    }
+}
+
+TEST(FecPlanTest, TestWideKeys) // NOLINT
+{
+    using T = __uint128_t;
+    auto& registry = fec::PlanRegistry<T>::get_instance();
+    auto create = []() { return std::make_unique<int>(0); };
+    const T low = 3;
+    const T high = (T(1) << 64) + low;
+
+    // Values sharing their low 64 bits have their own plans
+    auto plan_low = registry.get<int>(
+        std::make_tuple(fec::PlanKind::GF_PRIME, nullptr, low, 0), create);
+    auto plan_high = registry.get<int>(
+        std::make_tuple(fec::PlanKind::GF_PRIME, nullptr, high, 0), create);
+    ASSERT_NE(plan_low, plan_high);
+}
+
+class FecTestGoldilocks : public FecTestCommon<uint64_t> {
+};
+
+TEST_F(FecTestGoldilocks, TestGoldilocks) // NOLINT
+{
+    for (unsigned word_size : {4, 6, 7}) {
+        fec::RsGoldilocks fec(word_size, this->n_data, this->n_parities);
+        this->run_test(fec, true);
+    }
+}
+
+TEST_F(FecTestGoldilocks, TestGoldilocksBlocks) // NOLINT
+{
+    for (unsigned word_size : {4, 6, 7}) {
+        fec::RsGoldilocks fec(word_size, this->n_data, this->n_parities, 16);
+        this->run_test_blocks(fec);
+        this->run_test_streams_horizontal(fec);
+    }
+}
+
+TEST_F(FecTestGoldilocks, TestGoldilocksSharedPlans) // NOLINT
+{
+    auto& registry = fec::PlanRegistry<uint64_t>::get_instance();
+    const size_t n_plans = registry.get_size();
+    {
+        fec::RsGoldilocks fec1(4, this->n_data, this->n_parities, 16);
+        const size_t n_code_plans = registry.get_size();
+        ASSERT_GT(n_code_plans, n_plans);
+
+        // A code of same parameters is built on the same plans
+        fec::RsGoldilocks fec2(4, this->n_data, this->n_parities, 16);
+        ASSERT_EQ(registry.get_size(), n_code_plans);
+        this->run_test_blocks(fec1);
+        this->run_test_blocks(fec2);
+
+        // Plans don't depend on the packet size
+        fec::RsGoldilocks fec3(4, this->n_data, this->n_parities, 32);
+        ASSERT_EQ(registry.get_size(), n_code_plans);
+        this->run_test_blocks(fec3);
+    }
+    // Plans are released with the last code using them
+    ASSERT_EQ(registry.get_size(), n_plans);
+}
+
+TEST_F(FecTestGoldilocks, TestGoldilocksCodedSize) // NOLINT
+{
+    for (unsigned word_size : {4, 6, 7}) {
+        fec::RsGoldilocks fec(word_size, this->n_data, this->n_parities, 16);
+        const unsigned n_outputs = fec.n_outputs;
+        const size_t block_size = word_size * fec.pkt_size * 3;
+        const size_t coded_size = fec.get_coded_size(block_size);
+
+        // Coded symbols are stored on 8-byte words.
+        ASSERT_EQ(coded_size, block_size / word_size * sizeof(uint64_t));
+        ASSERT_EQ(fec.get_data_size(coded_size), block_size);
+
+        std::vector<std::vector<uint8_t>> data(this->n_data);
+        std::vector<uint8_t*> data_bufs(this->n_data);
+        for (unsigned i = 0; i < this->n_data; i++) {
+            // All-ones words give symbols spanning the 64 bits.
+            data[i].resize(block_size, 0xff);
+            data_bufs[i] = data[i].data();
+        }
+        std::vector<std::vector<uint8_t>> parities(n_outputs);
+        std::vector<uint8_t*> parities_bufs(n_outputs);
+        for (unsigned i = 0; i < n_outputs; i++) {
+            parities[i].resize(coded_size);
+            parities_bufs[i] = parities[i].data();
+        }
+        std::vector<quadiron::Properties> props(n_outputs);
+        std::vector<bool> wanted_idxs(n_outputs, true);
+
+        fec.encode_blocks_vertical(
+            data_bufs, parities_bufs, props, wanted_idxs, block_size);
+
+        // Symbols need no property.
+        for (unsigned i = 0; i < n_outputs; i++) {
+            ASSERT_EQ(props[i].get_map().size(), 0u);
+        }
+    }
+}
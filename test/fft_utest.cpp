@@ -200,6 +200,39 @@ TYPED_TEST(FftTest, TestFftNaive) // NOLINT
     this->test_fft_codec(gf, &fft, this->code_len);
 }
 
+TYPED_TEST(FftTest, TestFftNaivePackets) // NOLINT
+{
+    auto gf(gf::create<gf::Prime<TypeParam>>(this->q));
+    const unsigned n = gf.get_code_len(this->code_len);
+    const unsigned r = gf.get_nth_root(n);
+    const size_t pkt_size = 8;
+    fft::Naive<TypeParam> fft(gf, n, r, pkt_size);
+
+    // Buffers are transformed whatever their size, e.g. tiles of packets.
+    for (size_t size : {pkt_size - 5, pkt_size, 3 * pkt_size + 1}) {
+        quadiron::vec::Buffers<TypeParam> v(n, size);
+        quadiron::vec::Buffers<TypeParam> output(n, size);
+        for (unsigned i = 0; i < n; i++) {
+            for (size_t u = 0; u < size; u++) {
+                v.get(i)[u] = gf.rand();
+            }
+        }
+        fft.fft(output, v);
+
+        quadiron::vec::Vector<TypeParam> column(gf, n);
+        quadiron::vec::Vector<TypeParam> expected(gf, n);
+        for (size_t u = 0; u < size; u++) {
+            for (unsigned i = 0; i < n; i++) {
+                column.set(i, v.get(i)[u]);
+            }
+            fft.fft(expected, column);
+            for (unsigned i = 0; i < n; i++) {
+                ASSERT_EQ(output.get(i)[u], expected.get(i));
+            }
+        }
+    }
+}
+
 TYPED_TEST(FftTest, TestNaiveVsFft2kVec) // NOLINT
 {
     auto gf(gf::create<gf::Prime<TypeParam>>(this->q));
@@ -369,7 +402,8 @@ TYPED_TEST(FftTest, TestFftCtGf2n) // NOLINT
 
         unsigned len = this->code_len;
         if (gf.card_minus_one() <= this->code_len) {
-            len = gf.rand();
+            // A code has at least one symbol
+            len = 1 + gf.rand() % gf.card_minus_one();
         }
 
         // With this encoder we cannot exactly satisfy users request,
@@ -382,6 +416,26 @@ TYPED_TEST(FftTest, TestFftCtGf2n) // NOLINT
     }
 }
 
+TYPED_TEST(FftTest, TestFftSinglePoint) // NOLINT
+{
+    // The transform of a single point, e.g. for a code of length 1, is the
+    // identity. 1 has no prime factor to split the transform on.
+    auto gf(gf::create<gf::BinExtension<TypeParam>>(8));
+    fft::CooleyTukey<TypeParam> fft_ct(gf, 1);
+    fft::GoodThomas<TypeParam> fft_gt(gf, 1);
+
+    quadiron::vec::Vector<TypeParam> v(gf, 1);
+    quadiron::vec::Vector<TypeParam> output(gf, 1);
+    for (fft::FourierTransform<TypeParam>* fft :
+         std::vector<fft::FourierTransform<TypeParam>*>{&fft_ct, &fft_gt}) {
+        this->test_fft_codec(gf, fft, 1);
+
+        v.set(0, gf.rand());
+        fft->fft(output, v);
+        ASSERT_EQ(output, v);
+    }
+}
+
 TYPED_TEST(FftTest, TestFftAdd) // NOLINT
 {
     for (size_t gf_n = 4; gf_n <= 128 && gf_n <= 8 * sizeof(TypeParam);
@@ -404,6 +458,25 @@ TYPED_TEST(FftTest, TestFftAdd) // NOLINT
     }
 }
 
+TYPED_TEST(FftTest, TestTaylorExpandLowDegree) // NOLINT
+{
+    auto gf(gf::create<gf::BinExtension<TypeParam>>(8));
+    fft::Additive<TypeParam> fft(gf, 8);
+
+    // No t * 2^k lies in [n / 2, n) when n <= t, which used to overflow the
+    // search of k.
+    for (int t : {2, 3, 33, 64, 255, 256}) {
+        const int n = t;
+        quadiron::vec::Vector<TypeParam> v1(this->random_vec(gf, n, n));
+        quadiron::vec::Vector<TypeParam> v2(gf, t);
+
+        fft.taylor_expand(v2, v1, n, t);
+        quadiron::vec::Vector<TypeParam> _v1(gf, n);
+        fft.inv_taylor_expand(_v1, v2, t);
+        ASSERT_EQ(_v1, v1);
+    }
+}
+
 TYPED_TEST(FftTest, TestFftNaive2) // NOLINT
 {
     auto gf(gf::create<gf::Prime<TypeParam>>(this->q));
@@ -469,7 +542,8 @@ TYPED_TEST(FftTest, TestFftGf2n) // NOLINT
 
         unsigned len = this->code_len;
         if (gf.card_minus_one() <= this->code_len) {
-            len = gf.rand();
+            // A code has at least one symbol
+            len = 1 + gf.rand() % gf.card_minus_one();
         }
 
         // With this encoder we cannot exactly satisfy users request,
@@ -483,3 +557,291 @@ TYPED_TEST(FftTest, TestFftGf2n) // NOLINT
         this->test_fft_codec(gf, &fft, len);
     }
 }
+
+// Compare Radix2 on packets to the naive DFT, over Fermat fields where packets
+// are large enough for vectorized butterflies, with a non-vectorized tail.
+template <typename T>
+void test_fft_2n_vs_naive_packets(
+    T q,
+    size_t size = 4 * quadiron::simd::countof<T>() + 3,
+    unsigned max_n = 256,
+    int n_iters = 10)
+{
+    auto gf(gf::create<gf::Prime<T>>(q));
+
+    // Odd and even numbers of layers, so that both radix-4 and radix-2 steps
+    // are performed.
+    for (unsigned n = 2; n <= max_n && n < q; n *= 2) {
+        const T r = gf.get_nth_root(n);
+        fft::Naive<T> fft_naive(gf, n, r, size);
+        fft::Radix2<T> fft_2n(gf, n, n, size);
+
+        quadiron::vec::Buffers<T> v(n, size);
+        quadiron::vec::Buffers<T> fft1(n, size);
+        quadiron::vec::Buffers<T> fft2(n, size);
+        quadiron::vec::Buffers<T> ifft2(n, size);
+        for (int j = 0; j < n_iters; j++) {
+            for (unsigned i = 0; i < n; i++) {
+                T* mem = v.get(i);
+                for (size_t u = 0; u < size; u++) {
+                    // Include q - 1, the symbol that must not overflow.
+                    mem[u] = (u % 7 == 0) ? q - 1 : gf.rand();
+                }
+            }
+
+            fft_naive.fft(fft1, v);
+            fft_2n.fft(fft2, v);
+            ASSERT_EQ(fft1, fft2);
+
+            fft_2n.ifft(ifft2, fft2);
+            ASSERT_EQ(ifft2, v);
+        }
+    }
+}
+
+TEST(FftRadix2Test, TestPacketsFermat) // NOLINT
+{
+    test_fft_2n_vs_naive_packets<uint16_t>(257);
+    test_fft_2n_vs_naive_packets<uint32_t>(257);
+    test_fft_2n_vs_naive_packets<uint32_t>(65537);
+}
+
+TEST(FftRadix2Test, TestPacketsTiled) // NOLINT
+{
+    // Packets are split in several tiles, the last one being partial. Few
+    // iterations as the naive DFT of large packets is slow.
+    test_fft_2n_vs_naive_packets<uint32_t>(65537, 1000, 128, 2);
+}
+
+TEST(FftRadix2Test, TestPruned) // NOLINT
+{
+    const size_t size = 4 * quadiron::simd::countof<uint32_t>() + 3;
+    const unsigned n = 64;
+    auto gf(gf::create<gf::Prime<uint32_t>>(65537));
+
+    // Inputs shorter than `data_len`, or not, so that the bit-reversal ordering
+    // spreads each input over groups of several elements, or of one.
+    for (const unsigned data_len : {n, n / 4}) {
+        for (const unsigned input_len : {data_len / 2, data_len}) {
+            fft::Radix2<uint32_t> fft(gf, n, data_len);
+
+            quadiron::vec::Buffers<uint32_t> v(input_len, size);
+            quadiron::vec::Buffers<uint32_t> full(n, size);
+            quadiron::vec::Buffers<uint32_t> pruned(n, size);
+            for (unsigned i = 0; i < input_len; i++) {
+                uint32_t* mem = v.get(i);
+                for (size_t u = 0; u < size; u++) {
+                    mem[u] = gf.rand();
+                }
+            }
+            fft.fft(full, v);
+
+            // One output, outputs of a same residue, spread outputs, and flags
+            // shorter than `n`.
+            std::vector<std::vector<bool>> wanted_list(4);
+            wanted_list[0].assign(n, false);
+            wanted_list[0][5] = true;
+            wanted_list[1].assign(n, false);
+            wanted_list[1][3] = true;
+            wanted_list[1][3 + n / 2] = true;
+            wanted_list[2].assign(n, false);
+            for (unsigned i = 1; i < n; i += 7) {
+                wanted_list[2][i] = true;
+            }
+            wanted_list[3].assign(n / 2, true);
+
+            for (const auto& wanted : wanted_list) {
+                pruned.zero_fill();
+                fft.fft_pruned(pruned, v, wanted);
+                for (unsigned i = 0; i < wanted.size(); i++) {
+                    if (!wanted[i]) {
+                        continue;
+                    }
+                    for (size_t u = 0; u < size; u++) {
+                        ASSERT_EQ(pruned.get(i)[u], full.get(i)[u]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Compare an FFT on packets to the same FFT on the vectors of their symbols,
+// inputs being zero-extended from `input_len` buffers as in encoding.
+template <typename T>
+void test_fft_packets_vs_vectors(
+    const gf::Field<T>& gf,
+    fft::FourierTransform<T>& fft,
+    unsigned input_len,
+    size_t size)
+{
+    const unsigned n = fft.get_n();
+
+    quadiron::vec::Buffers<T> v(input_len, size);
+    quadiron::vec::Buffers<T> fft1(n, size);
+    quadiron::vec::Buffers<T> ifft1(n, size);
+    quadiron::vec::Vector<T> v_vec(gf, n);
+    quadiron::vec::Vector<T> fft_vec(gf, n);
+    for (unsigned i = 0; i < input_len; i++) {
+        T* mem = v.get(i);
+        for (size_t u = 0; u < size; u++) {
+            mem[u] = gf.rand();
+        }
+    }
+
+    fft.fft(fft1, v);
+    for (size_t u = 0; u < size; u++) {
+        v_vec.zero_fill();
+        for (unsigned i = 0; i < input_len; i++) {
+            v_vec.set(i, v.get(i)[u]);
+        }
+        fft.fft(fft_vec, v_vec);
+        for (unsigned i = 0; i < n; i++) {
+            ASSERT_EQ(fft1.get(i)[u], fft_vec.get(i));
+        }
+    }
+
+    fft.ifft(ifft1, fft1);
+    for (unsigned i = 0; i < n; i++) {
+        for (size_t u = 0; u < size; u++) {
+            ASSERT_EQ(ifft1.get(i)[u], i < input_len ? v.get(i)[u] : 0);
+        }
+    }
+}
+
+// Compare additive FFTs of up to 2^max_m points on packets and on vectors
+template <typename T>
+void test_fft_add_packets(unsigned gf_n, size_t size, unsigned max_m)
+{
+    auto gf(gf::create<gf::BinExtension<T>>(gf_n));
+
+    for (unsigned m = 1; m <= max_m; m++) {
+        fft::Additive<T> fft(gf, m);
+        test_fft_packets_vs_vectors<T>(gf, fft, fft.get_n() / 2 + 1, size);
+    }
+}
+
+TEST(FftAdditiveTest, TestPackets) // NOLINT
+{
+    const size_t size = 4 * quadiron::simd::countof<uint32_t>() + 3;
+
+    test_fft_add_packets<uint32_t>(8, size, 8);
+    test_fft_add_packets<uint32_t>(16, size, 8);
+    test_fft_add_packets<uint64_t>(32, size, 6);
+}
+
+TEST(FftAdditiveTest, TestPacketsTiled) // NOLINT
+{
+    // Packets are split in several tiles, the last one being partial
+    test_fft_add_packets<uint32_t>(16, 1000, 8);
+}
+
+// Compare a mixed-radix FFT and its unnormalized inverse to the naive DFT with
+// the same root, on vectors and on packets. Inner layers, i.e. transforms given
+// their factors, leave the normalization of the inverse to the outer layer.
+template <typename T>
+void test_fft_vs_naive(
+    const gf::Field<T>& gf,
+    fft::FourierTransform<T>& fft,
+    T w,
+    size_t size)
+{
+    const unsigned n = fft.get_n();
+    fft::Naive<T> fft_naive(gf, n, w, size);
+
+    quadiron::vec::Vector<T> v_vec(gf, n);
+    quadiron::vec::Vector<T> fft1_vec(gf, n);
+    quadiron::vec::Vector<T> fft2_vec(gf, n);
+    for (unsigned i = 0; i < n; i++) {
+        v_vec.set(i, gf.rand());
+    }
+    fft_naive.fft(fft1_vec, v_vec);
+    fft.fft(fft2_vec, v_vec);
+    ASSERT_EQ(fft1_vec, fft2_vec);
+    fft_naive.fft_inv(fft1_vec, v_vec);
+    fft.fft_inv(fft2_vec, v_vec);
+    ASSERT_EQ(fft1_vec, fft2_vec);
+
+    quadiron::vec::Buffers<T> v(n, size);
+    quadiron::vec::Buffers<T> fft1(n, size);
+    quadiron::vec::Buffers<T> fft2(n, size);
+    for (unsigned i = 0; i < n; i++) {
+        T* mem = v.get(i);
+        for (size_t u = 0; u < size; u++) {
+            mem[u] = gf.rand();
+        }
+    }
+    fft_naive.fft(fft1, v);
+    fft.fft(fft2, v);
+    ASSERT_EQ(fft1, fft2);
+    fft_naive.fft_inv(fft1, v);
+    fft.fft_inv(fft2, v);
+    ASSERT_EQ(fft1, fft2);
+}
+
+TEST(FftCooleyTukeyTest, TestRadix2Inner) // NOLINT
+{
+    const size_t size = 4 * quadiron::simd::countof<uint32_t>() + 3;
+    auto gf(gf::create<gf::Prime<uint32_t>>(65537));
+
+    // n = 2 * n2, the inner DFT of n2 points being a fft::Radix2
+    for (unsigned n = 4; n <= 256; n *= 2) {
+        fft::CooleyTukey<uint32_t> fft(gf, n);
+        test_fft_vs_naive<uint32_t>(gf, fft, gf.get_nth_root(n), size);
+    }
+}
+
+TEST(FftCooleyTukeyTest, TestPackets) // NOLINT
+{
+    const size_t size = 4 * quadiron::simd::countof<uint32_t>() + 3;
+
+    auto gf8(gf::create<gf::BinExtension<uint32_t>>(8));
+    for (const unsigned n : {15, 17, 255}) {
+        fft::CooleyTukey<uint32_t> fft(gf8, n);
+        test_fft_packets_vs_vectors<uint32_t>(gf8, fft, n / 2 + 1, size);
+    }
+
+    auto gf16(gf::create<gf::BinExtension<uint32_t>>(16));
+    fft::CooleyTukey<uint32_t> fft16(gf16, 255);
+    test_fft_packets_vs_vectors<uint32_t>(gf16, fft16, 255, size);
+
+    // p - 1 = 2^13 * 29 * 101 * 179
+    auto gfp(gf::create<gf::Prime<uint64_t>>(4294991873ULL));
+    fft::CooleyTukey<uint64_t> fftp(gfp, 8 * 29);
+    test_fft_packets_vs_vectors<uint64_t>(gfp, fftp, 100, size);
+}
+
+TEST(FftCooleyTukeyTest, TestPacketsTiled) // NOLINT
+{
+    // Packets are split in several tiles, the last one being partial
+    auto gf(gf::create<gf::BinExtension<uint32_t>>(16));
+    fft::CooleyTukey<uint32_t> fft(gf, 255);
+    test_fft_packets_vs_vectors<uint32_t>(gf, fft, 200, 1000);
+}
+
+TEST(FftGoodThomasTest, TestPackets) // NOLINT
+{
+    const size_t size = 4 * quadiron::simd::countof<uint32_t>() + 3;
+
+    auto gf8(gf::create<gf::BinExtension<uint32_t>>(8));
+    fft::GoodThomas<uint32_t> fft8(gf8, 255);
+    test_fft_packets_vs_vectors<uint32_t>(gf8, fft8, 128, size);
+
+    auto gfp(gf::create<gf::Prime<uint64_t>>(4294991873ULL));
+    fft::GoodThomas<uint64_t> fftp(gfp, 8 * 29);
+    test_fft_packets_vs_vectors<uint64_t>(gfp, fftp, 100, size);
+}
+
+TEST(FftGoodThomasTest, TestRadix2Inner) // NOLINT
+{
+    const size_t size = 4 * quadiron::simd::countof<uint64_t>() + 3;
+    auto gf(gf::create<gf::Prime<uint64_t>>(4294991873ULL));
+
+    // Factors are given so that the inner DFT of 16 points is a fft::Radix2,
+    // which must transform packets whatever their size.
+    std::vector<uint64_t> factors = {29, 16};
+    const uint64_t n = 29 * 16;
+    const uint64_t w = gf.get_nth_root(n);
+    fft::GoodThomas<uint64_t> fft(gf, n, 0, &factors, w);
+    test_fft_vs_naive<uint64_t>(gf, fft, w, size);
+}
@@ -27,12 +27,20 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "gf_bin_ext.h"
 #include "gf_nf4.h"
+#include "gf_goldilocks.h"
+#include "gf_prime.h"
+#include "simd/allocator.h"
+#include "vec_buffers.h"
+#include "vec_vector.h"
 
 namespace gf = quadiron::gf;
+namespace vec = quadiron::vec;
 
 template <typename T>
 class GfTestCommon : public ::testing::Test {
@@ -184,3 +192,230 @@ TYPED_TEST(GfTestNo128, TestGf256) // NOLINT
     this->test_get_nth_root(gf);
     this->test_find_primitive_root(&gf);
 }
+
+// Compare the operations on buffers (vectorized for GF(2^8) and GF(2^16) when
+// SIMD is enabled) with the element-wise ones.
+TYPED_TEST(GfTestCommon, TestGf2nBufferOps) // NOLINT
+{
+    quadiron::prng().seed(time(0));
+
+    for (TypeParam n : {4, 8, 16}) {
+        auto gf(gf::create<gf::BinExtension<TypeParam>>(n));
+        const TypeParam h = gf.card_minus_one();
+
+        // Lengths that aren't multiple of the register sizes are used to
+        // test trailing elements as well.
+        for (size_t len : {1, 7, 64, 203, 1031}) {
+            const int n_bufs = 4;
+            vec::Buffers<TypeParam> x(n_bufs, len);
+            vec::Buffers<TypeParam> y(n_bufs, len);
+            for (int i = 0; i < n_bufs; ++i) {
+                for (size_t j = 0; j < len; ++j) {
+                    x.get(i)[j] = (j % 5 == 0) ? h : gf.rand();
+                    y.get(i)[j] = gf.rand();
+                }
+            }
+
+            // 0, 1 and `card - 1` are handled apart by some implementations.
+            vec::Vector<TypeParam> coefs(gf, n_bufs);
+            coefs.set(0, 0);
+            coefs.set(1, 1);
+            coefs.set(2, h);
+            coefs.set(3, 2 + gf.rand() % (h - 2));
+
+            // Products must clear the upper bytes of words.
+            vec::Buffers<TypeParam> res(n_bufs, len);
+            for (int i = 0; i < n_bufs; ++i) {
+                res.fill(i, ~static_cast<TypeParam>(0));
+            }
+            gf.mul_vec_to_vecp(coefs, x, res);
+            for (int i = 0; i < n_bufs; ++i) {
+                for (size_t j = 0; j < len; ++j) {
+                    ASSERT_EQ(res.get(i)[j], gf.mul(coefs.get(i), x.get(i)[j]));
+                }
+            }
+
+            res.copy(y);
+            gf.add_vecp_to_vecp(x, res);
+            for (int i = 0; i < n_bufs; ++i) {
+                for (size_t j = 0; j < len; ++j) {
+                    ASSERT_EQ(res.get(i)[j], gf.add(x.get(i)[j], y.get(i)[j]));
+                }
+            }
+
+            // The result may alias either operand.
+            for (int alias = 0; alias < 3; ++alias) {
+                vec::Buffers<TypeParam> a(x);
+                vec::Buffers<TypeParam> b(y);
+                vec::Buffers<TypeParam>& dst =
+                    alias == 0 ? res : (alias == 1 ? a : b);
+                gf.sub_vecp_to_vecp(a, b, dst);
+                for (int i = 0; i < n_bufs; ++i) {
+                    for (size_t j = 0; j < len; ++j) {
+                        ASSERT_EQ(
+                            dst.get(i)[j], gf.sub(x.get(i)[j], y.get(i)[j]));
+                    }
+                }
+            }
+
+            res.copy(x);
+            gf.neg(res);
+            for (int i = 0; i < n_bufs; ++i) {
+                for (size_t j = 0; j < len; ++j) {
+                    ASSERT_EQ(res.get(i)[j], gf.neg(x.get(i)[j]));
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+class GfTestFermat : public ::testing::Test {
+  public:
+    using Buffer = std::vector<T, quadiron::simd::AlignedAllocator<T>>;
+
+    Buffer rand_buffer(const gf::RingModN<T>& gf, size_t len)
+    {
+        Buffer buf(len);
+        for (size_t i = 0; i < len; ++i) {
+            // Make sure that `card - 1` (the trickiest value) is tested.
+            buf[i] = (i % 5 == 0) ? gf.card_minus_one() : gf.rand();
+        }
+        return buf;
+    }
+
+    // Compare the operations on buffers (vectorized when SIMD is enabled)
+    // with the element-wise ones.
+    void test_buffer_ops(const gf::RingModN<T>& gf)
+    {
+        // Lengths that aren't multiple of the register sizes are used to
+        // test trailing elements as well.
+        for (size_t len : {1, 7, 64, 203, 1031}) {
+            const Buffer x = rand_buffer(gf, len);
+            const Buffer y = rand_buffer(gf, len);
+            Buffer res(len);
+
+            Buffer src(x);
+            // `card - 1` squared overflows some vectorized products.
+            for (const T coef : {T(2 + gf.rand() % (gf.card_minus_one() - 2)),
+                                 gf.card_minus_one()}) {
+                gf.mul_coef_to_buf(coef, src.data(), res.data(), len);
+                for (size_t i = 0; i < len; ++i) {
+                    ASSERT_EQ(res[i], gf.mul(coef, x[i]));
+                }
+            }
+
+            res = y;
+            gf.add_two_bufs(src.data(), res.data(), len);
+            for (size_t i = 0; i < len; ++i) {
+                ASSERT_EQ(res[i], gf.add(x[i], y[i]));
+            }
+
+            Buffer other(y);
+            gf.sub_two_bufs(src.data(), other.data(), res.data(), len);
+            for (size_t i = 0; i < len; ++i) {
+                ASSERT_EQ(res[i], gf.sub(x[i], y[i]));
+            }
+
+            res = x;
+            gf.hadamard_mul(
+                static_cast<int>(len), res.data(), other.data());
+            for (size_t i = 0; i < len; ++i) {
+                ASSERT_EQ(res[i], gf.mul(x[i], y[i]));
+            }
+
+            res = x;
+            gf.neg(len, res.data());
+            for (size_t i = 0; i < len; ++i) {
+                ASSERT_EQ(res[i], gf.neg(x[i]));
+            }
+        }
+    }
+};
+
+using FermatTypes = ::testing::Types<uint16_t, uint32_t>;
+TYPED_TEST_CASE(GfTestFermat, FermatTypes);
+
+TYPED_TEST(GfTestFermat, TestBufferOps) // NOLINT
+{
+    quadiron::prng().seed(time(0));
+
+    auto gf257(gf::create<gf::Prime<TypeParam>>(257));
+    this->test_buffer_ops(gf257);
+
+    if (sizeof(TypeParam) > 2) {
+        auto gf65537(gf::create<gf::Prime<TypeParam>>(
+            quadiron::narrow_cast<TypeParam>(65537)));
+        this->test_buffer_ops(gf65537);
+    }
+}
+
+// Other primes use the Montgomery reduction, up to R / 2.
+template <typename T>
+class GfTestPrime : public GfTestFermat<T> {
+};
+
+using PrimeTypes = ::testing::Types<uint32_t, uint64_t>;
+TYPED_TEST_CASE(GfTestPrime, PrimeTypes);
+
+TYPED_TEST(GfTestPrime, TestBufferOps) // NOLINT
+{
+    quadiron::prng().seed(time(0));
+
+    const std::vector<uint64_t> primes = (sizeof(TypeParam) == 4)
+        ? std::vector<uint64_t>{65521, 2013265921}
+        : std::vector<uint64_t>{4294991873, 9223371938070528001};
+
+    for (uint64_t p : primes) {
+        auto gfp(gf::create<gf::Prime<TypeParam>>(
+            quadiron::narrow_cast<TypeParam>(p)));
+        this->test_buffer_ops(gfp);
+    }
+}
+
+class GfTestGoldilocks : public GfTestFermat<uint64_t> {
+};
+
+TEST_F(GfTestGoldilocks, TestArith) // NOLINT
+{
+    quadiron::prng().seed(time(0));
+
+    auto field(gf::create<gf::Goldilocks>());
+    const __uint128_t p = gf::Goldilocks::P;
+    auto mod = [p](__uint128_t x) { return static_cast<uint64_t>(x % p); };
+
+    // Values around the words of 32 bits and the modulus
+    std::vector<uint64_t> values = {0,
+                                    1,
+                                    2,
+                                    0xFFFFFFFF,
+                                    0x100000000,
+                                    0x8000000000000000,
+                                    0xFFFFFFFF00000000,
+                                    gf::Goldilocks::P - 1};
+    for (int i = 0; i < 100; ++i) {
+        values.push_back(field.rand());
+    }
+
+    for (uint64_t x : values) {
+        ASSERT_EQ(field.neg(x), mod(p - x));
+        for (uint64_t y : values) {
+            ASSERT_EQ(field.add(x, y), mod(__uint128_t(x) + y));
+            ASSERT_EQ(field.sub(x, y), mod(__uint128_t(x) + p - y));
+            ASSERT_EQ(field.mul(x, y), mod(__uint128_t(x) * y));
+        }
+    }
+
+    // Roots of unity of every power-of-two order up to 2^32
+    const uint64_t root = field.get_nth_root(uint64_t(1) << 32);
+    ASSERT_EQ(field.exp(root, uint64_t(1) << 32), 1);
+    ASSERT_NE(field.exp(root, uint64_t(1) << 31), 1);
+}
+
+TEST_F(GfTestGoldilocks, TestBufferOps) // NOLINT
+{
+    quadiron::prng().seed(time(0));
+
+    auto field(gf::create<gf::Goldilocks>());
+    this->test_buffer_ops(field);
+}
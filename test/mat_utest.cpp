@@ -89,3 +89,96 @@ TEST(MatrixTest, TestInvertGf29) // NOLINT
     ASSERT_EQ(mat.get(2, 1), 24);
     ASSERT_EQ(mat.get(2, 2), 14);
 }
+
+TEST(MatrixTest, TestCauchyMds) // NOLINT
+{
+    const auto gf256(gf::create<gf::BinExtension<uint32_t>>(8));
+    const int n_rows = 4;
+    const int n_cols = 10;
+    vec::Matrix<uint32_t> mat(gf256, n_rows, n_cols);
+    mat.cauchy();
+
+    // Every square sub-matrix must be invertible.
+    for (unsigned rows = 1; rows < (1u << n_rows); ++rows) {
+        for (unsigned cols = 1; cols < (1u << n_cols); ++cols) {
+            const int size = __builtin_popcount(rows);
+            if (__builtin_popcount(cols) != size) {
+                continue;
+            }
+            vec::Matrix<uint32_t> sub(gf256, size, size);
+            int sub_i = 0;
+            for (int i = 0; i < n_rows; ++i) {
+                if (!(rows & (1u << i))) {
+                    continue;
+                }
+                int sub_j = 0;
+                for (int j = 0; j < n_cols; ++j) {
+                    if (cols & (1u << j)) {
+                        sub.set(sub_i, sub_j++, mat.get(i, j));
+                    }
+                }
+                sub_i++;
+            }
+            ASSERT_NO_THROW(sub.inv());
+        }
+    }
+}
+
+TEST(MatrixTest, TestCauchyScaled) // NOLINT
+{
+    const auto gf256(gf::create<gf::BinExtension<uint32_t>>(8));
+    const int n_rows = 4;
+    const int n_cols = 10;
+    vec::Matrix<uint32_t> mat(gf256, n_rows, n_cols);
+    mat.cauchy();
+
+    // Whole rows and columns of the Cauchy matrix 1 / (i + (n_rows + j)) are
+    // scaled so that its first row and first column are all 1s.
+    auto cauchy = [&](int i, int j) {
+        return gf256.inv(gf256.add(i, j + n_rows));
+    };
+    for (int i = 0; i < n_rows; ++i) {
+        for (int j = 0; j < n_cols; ++j) {
+            const uint32_t expected = gf256.div(
+                gf256.mul(cauchy(i, j), cauchy(0, 0)),
+                gf256.mul(cauchy(0, j), cauchy(i, 0)));
+            ASSERT_EQ(mat.get(i, j), expected);
+        }
+    }
+}
+
+TEST(MatrixTest, TestMulBuffersGf2n) // NOLINT
+{
+    quadiron::prng().seed(time(0));
+
+    const auto gf256(gf::create<gf::BinExtension<uint32_t>>(8));
+    vec::Matrix<uint32_t> mat(gf256, 3, 4);
+    mat.cauchy();
+    // Null and unit coefficients are handled apart.
+    mat.set(1, 0, 0);
+    mat.set(1, 1, 1);
+
+    // Buffers span several chunks, the last one being partial.
+    const size_t size = 2500;
+    vec::Buffers<uint32_t> words(4, size);
+    vec::Buffers<uint32_t> output(3, size);
+    for (int j = 0; j < 4; j++) {
+        for (size_t k = 0; k < size; k++) {
+            words.get(j)[k] = gf256.rand();
+        }
+    }
+
+    mat.mul(&output, &words);
+
+    vec::Vector<uint32_t> v(gf256, 4);
+    vec::Vector<uint32_t> expected(gf256, 3);
+    for (size_t k = 0; k < size; k++) {
+        for (int j = 0; j < 4; j++) {
+            v.set(j, words.get(j)[k]);
+        }
+        mat.mul(&expected, &v);
+        for (int i = 0; i < 3; i++) {
+            ASSERT_EQ(output.get(i)[k], expected.get(i));
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2017-2018 Scality
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+
+#include "quadiron.h"
+
+TEST(PropertiesTest, TestAddGetRemove) // NOLINT
+{
+    quadiron::Properties props;
+
+    // Out-of-order locations are inserted at their place.
+    for (const off_t loc : {5, 9, 2, 7, 0}) {
+        props.add(loc, loc + 1);
+    }
+    props.add(7, 42);
+    ASSERT_EQ(props.size(), 5u);
+    ASSERT_EQ(props.get(2), 3u);
+    ASSERT_EQ(props.get(7), 42u);
+    ASSERT_EQ(props.get(3), 0u);
+
+    props.remove(2);
+    props.remove(3);
+    ASSERT_EQ(props.size(), 4u);
+    ASSERT_EQ(props.get(2), 0u);
+}
+
+TEST(PropertiesTest, TestRange) // NOLINT
+{
+    quadiron::Properties props;
+    for (off_t loc = 0; loc < 100; loc += 3) {
+        props.add(loc, quadiron::OOR_MARK);
+    }
+
+    const auto range = props.get_range(10, 20);
+    std::vector<off_t> locs;
+    for (auto it = range.first; it != range.second; ++it) {
+        locs.push_back(it->first);
+    }
+    ASSERT_EQ(locs, std::vector<off_t>({12, 15, 18}));
+
+    const auto empty = props.get_range(100, 200);
+    ASSERT_EQ(empty.first, empty.second);
+}
+
+TEST(PropertiesTest, TestMerge) // NOLINT
+{
+    quadiron::Properties props;
+    quadiron::Properties other;
+    props.add(1, 1);
+    props.add(8, 1);
+    other.add(4, 2);
+    other.add(8, 2);
+    other.add(12, 2);
+
+    props.merge(other);
+    ASSERT_EQ(props.size(), 4u);
+    ASSERT_EQ(props.get(4), 2u);
+    ASSERT_EQ(props.get(8), 1u);
+    ASSERT_EQ(props.get(12), 2u);
+}
+
+TEST(PropertiesTest, TestFntSerialize) // NOLINT
+{
+    quadiron::Properties props;
+    quadiron::Properties deserialized;
+    for (const off_t loc : {3, 17, 1024}) {
+        props.add(loc, quadiron::OOR_MARK);
+    }
+
+    uint32_t dwords[8];
+    ASSERT_EQ(props.fnt_serialize(dwords, 8), 0);
+    ASSERT_EQ(deserialized.fnt_deserialize(dwords, 8), 0);
+    ASSERT_EQ(props.get_map(), deserialized.get_map());
+}
@@ -243,3 +243,68 @@ TYPED_TEST(QuadironCTest, TestBasicNSys) // NOLINT
 {
     this->test_all_decodable_scenarios(3, 3, 0);
 }
+
+TYPED_TEST(QuadironCTest, TestStageStats) // NOLINT
+{
+    const int n_data = 3;
+    const int n_parities = 3;
+    const size_t block_size = 10000;
+    struct QuadironFnt32* inst = quadiron_fnt32_new(2, n_data, n_parities, 1);
+    const size_t metadata_size =
+        quadiron_fnt32_get_metadata_size(inst, block_size);
+    std::vector<std::vector<uint8_t>> data(n_data);
+    std::vector<uint8_t*> _data(n_data);
+    std::vector<std::vector<uint8_t>> parity(n_parities);
+    std::vector<uint8_t*> _parity(n_parities);
+    std::vector<int> wanted_idxs(n_parities, 1);
+    std::vector<int> missing_idxs(n_data + n_parities, 0);
+
+    for (int i = 0; i < n_data; i++) {
+        data[i].resize(block_size + metadata_size);
+        _data[i] = data[i].data();
+        this->randomize_buffer(_data[i] + metadata_size, block_size);
+    }
+    for (int i = 0; i < n_parities; i++) {
+        parity[i].resize(block_size + metadata_size);
+        _parity[i] = parity[i].data();
+    }
+    missing_idxs[0] = 1;
+
+    ASSERT_EQ(
+        quadiron_fnt32_encode(
+            inst, _data.data(), _parity.data(), wanted_idxs.data(), block_size),
+        0);
+    ASSERT_EQ(
+        quadiron_fnt32_decode(
+            inst,
+            _data.data(),
+            _parity.data(),
+            missing_idxs.data(),
+            block_size),
+        0);
+
+    const int expected = quadiron::fec::StageStats::enabled ? 0 : -1;
+    for (const auto stage :
+         {QUADIRON_STAGE_PACK,
+          QUADIRON_STAGE_FFT,
+          QUADIRON_STAGE_POST_PROCESS,
+          QUADIRON_STAGE_UNPACK}) {
+        uint64_t cycles = 0;
+        uint64_t bytes = 0;
+        ASSERT_EQ(
+            quadiron_fnt32_get_stage_stats(inst, stage, &cycles, &bytes),
+            expected);
+        if (expected == 0) {
+            ASSERT_GT(bytes, 0u);
+        }
+    }
+
+    quadiron_fnt32_reset_stage_stats(inst);
+    uint64_t cycles = 0;
+    uint64_t bytes = 0;
+    quadiron_fnt32_get_stage_stats(inst, QUADIRON_STAGE_PACK, &cycles, &bytes);
+    ASSERT_EQ(cycles, 0u);
+    ASSERT_EQ(bytes, 0u);
+
+    quadiron_fnt32_delete(inst);
+}
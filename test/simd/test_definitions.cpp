@@ -48,5 +48,9 @@ TEST(SimdDefinitionsTest, TestConstants) // NOLINT
         ASSERT_EQ(simd::ALIGNMENT, 32);
         ASSERT_EQ(simd::REG_BITSZ, 256);
         break;
+    case simd::InstructionSet::AVX512:
+        ASSERT_EQ(simd::ALIGNMENT, 64);
+        ASSERT_EQ(simd::REG_BITSZ, 512);
+        break;
     }
 }
@@ -27,10 +27,13 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
+#include <cstdlib>
+#include <string>
 #include <vector>
 
 #include <gtest/gtest.h>
 
+#include "exceptions.h"
 #include "simd/simd.h"
 
 namespace simd = quadiron::simd;
@@ -39,7 +42,7 @@ TEST(SimdTest, TestCountOf) // NOLINT
 {
     std::vector<std::size_t> expected;
 
-    switch (simd::INSTRUCTION_SET) {
+    switch (simd::get_instruction_set()) {
     case simd::InstructionSet::NONE:
         expected = {1, 1, 1, 1};
         break;
@@ -49,6 +52,9 @@ TEST(SimdTest, TestCountOf) // NOLINT
     case simd::InstructionSet::AVX:
         expected = {32, 16, 8, 4};
         break;
+    case simd::InstructionSet::AVX512:
+        expected = {64, 32, 16, 8};
+        break;
     }
 
     ASSERT_EQ(simd::countof<uint8_t>(), expected[0]);
@@ -56,3 +62,31 @@ TEST(SimdTest, TestCountOf) // NOLINT
     ASSERT_EQ(simd::countof<uint32_t>(), expected[2]);
     ASSERT_EQ(simd::countof<uint64_t>(), expected[3]);
 }
+
+TEST(SimdTest, TestInstructionSet) // NOLINT
+{
+    const simd::InstructionSet detected = simd::detect_instruction_set();
+
+    ASSERT_EQ(simd::get_instruction_set(), detected);
+    ASSERT_LE(detected, simd::INSTRUCTION_SET);
+
+#ifdef QUADIRON_SIMD_DISPATCH
+    const char* requested = std::getenv("QUADIRON_SIMD");
+    const std::string saved = requested == nullptr ? "" : requested;
+
+    setenv("QUADIRON_SIMD", "none", 1);
+    ASSERT_EQ(simd::detect_instruction_set(), simd::InstructionSet::NONE);
+    setenv("QUADIRON_SIMD", "sse", 1);
+    ASSERT_EQ(simd::detect_instruction_set(), simd::InstructionSet::SSE);
+    setenv("QUADIRON_SIMD", "neon", 1);
+    ASSERT_THROW(simd::detect_instruction_set(), quadiron::InvalidArgument);
+
+    if (requested == nullptr) {
+        unsetenv("QUADIRON_SIMD");
+    } else {
+        setenv("QUADIRON_SIMD", saved.c_str(), 1);
+    }
+    // The instruction set is detected once.
+    ASSERT_EQ(simd::get_instruction_set(), detected);
+#endif
+}